@@ -107,11 +107,9 @@ uint16_t tmf8828_app_is_mode_8x8()
 	return 0;
 }
 
-static void power_on_tmf882x(void)
+void tmf8828_app_power_off()
 {
     cyhal_gpio_write(ARDU_IO4, false);
-    cyhal_system_delay_ms(1000); //Cold Start --> wait 1s
-    cyhal_gpio_write(ARDU_IO4, true);
 }
 
 /**
@@ -128,13 +126,21 @@ static uint8_t is_mode_valid(uint8_t mode)
 }
 
 int tmf8828_app_init_measurement()
+{
+	tmf8828_app_power_off();
+	cyhal_system_delay_ms(TMF8828_COLD_START_DURATION_MS);
+
+	return tmf8828_app_start_measurement();
+}
+
+int tmf8828_app_start_measurement()
 {
 	// Temporary variable for storing version info
 	uint8_t ver[16] = { 0 };
 	bool is_measuring = false;
 
 	// Assert the CE pin on the TMF882X to turn on the device
-	power_on_tmf882x();
+	cyhal_gpio_write(ARDU_IO4, true);
 
 	/*************************************************************************
 	*
@@ -18,6 +18,12 @@
 #define TMF8828_MODE_8X8		1
 #define TMF8828_MODE_INVALID	2
 
+/**
+ * @def TMF8828_COLD_START_DURATION_MS
+ * @brief Time the device has to stay powered off (CE low) for a cold start
+ */
+#define TMF8828_COLD_START_DURATION_MS	1000
+
 typedef int8_t (*tmf8828_read_func_t)(uint8_t dev_addr, uint8_t *data, uint16_t len);
 typedef int8_t (*tmf8828_write_func_t)(uint8_t dev_addr, uint8_t *data, uint16_t len);
 
@@ -51,8 +57,26 @@ int tmf8828_app_is_board_available();
  */
 uint16_t tmf8828_app_is_mode_8x8();
 
+/**
+ * @brief Cold start the device, download its firmware and start the measurement
+ * Blocking (TMF8828_COLD_START_DURATION_MS + firmware download)
+ */
 int tmf8828_app_init_measurement();
 
+/**
+ * @brief First step of the non blocking start: power off the device (CE low)
+ */
+void tmf8828_app_power_off();
+
+/**
+ * @brief Second step of the non blocking start: power on the device, download its firmware and start the measurement
+ * To be called TMF8828_COLD_START_DURATION_MS after tmf8828_app_power_off
+ *
+ * @retval 0 Success
+ * @retval != 0 An error occurred
+ */
+int tmf8828_app_start_measurement();
+
 /**
  * @brief Request a new mode
  * The change will be performed by the next call to tmf8828_app_do (asynchronous)
@@ -0,0 +1,78 @@
+/*
+ * ble_port.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef BLE_PORT_H_
+#define BLE_PORT_H_
+
+#include <stdint.h>
+
+/**
+ * BLE port layer used by host_main
+ *
+ * The port owns the BLE stack (PSoC6 BLE middleware on the RDK3, a stand-in on a Linux host).
+ * It reports the stack events to host_main by calling the host_main_on_xxx functions (see host_main.h).
+ */
+
+/**
+ * @def BLE_PORT_DEFAULT_MTU
+ * @brief ATT MTU used until the client exchanges another one
+ */
+#define BLE_PORT_DEFAULT_MTU	23
+
+/**
+ * @def BLE_PORT_MAX_MTU
+ * @brief Highest MTU the port accepts during the MTU exchange
+ */
+#define BLE_PORT_MAX_MTU		512
+
+/**
+ * Characteristic on which a write has been received
+ */
+#define BLE_PORT_CHAR_DATA		0	/**< Notification characteristic (commands without request id) */
+#define BLE_PORT_CHAR_CMD		1	/**< Command characteristic (commands with request id, bulk data) */
+
+/**
+ * @brief Initialize and start the BLE stack (advertising starts once the stack is on)
+ *
+ * @retval 0 Success
+ * @retval < 0 Error
+ */
+int ble_port_init();
+
+/**
+ * @brief Let the stack process its pending events (events are reported to host_main from inside this call)
+ */
+void ble_port_process_events();
+
+/**
+ * @brief Check if the stack has events that ble_port_process_events has not processed yet
+ * Used before sleeping: the stack wakes the CPU up with an interrupt when a new event occurs
+ *
+ * @retval 1 Events pending
+ * @retval 0 Nothing to process
+ */
+uint8_t ble_port_has_pending_events();
+
+/**
+ * @brief Check if the stack can accept a notification
+ *
+ * @retval 1 Stack is free
+ * @retval 0 Stack is busy (its buffers are full)
+ */
+uint8_t ble_port_is_free();
+
+/**
+ * @brief Send a notification on the notification characteristic
+ * The stack copies the content, the buffer can be reused as soon as the function returns
+ *
+ * @retval 0 Success
+ * @retval -1 Notification refused for now (stack busy, not connected, ...)
+ * @retval -2 Notification can never be sent (invalid length)
+ */
+int ble_port_notify(uint8_t* content, uint16_t len);
+
+#endif /* BLE_PORT_H_ */
@@ -0,0 +1,735 @@
+/******************************************************************************
+* File Name: ble_port_psoc6.c
+*
+* Version: 1.10
+*
+* Description: BLE port layer on top of the PSoC6 BLE middleware.
+*              Starts the BLE stack, handles its events and reports them
+*              to host_main (GATT server with the custom throughput service).
+*
+* Related Document: CE222046_Throughput_Measurement.pdf
+*
+* Hardware Dependency: See CE222046_Throughput_Measurement.pdf
+*
+*******************************************************************************
+* Copyright (2018), Cypress Semiconductor Corporation. All rights reserved.
+*******************************************************************************
+* This software, including source code, documentation and related materials
+* (“Software”), is owned by Cypress Semiconductor Corporation or one of its
+* subsidiaries (“Cypress”) and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software (“EULA”).
+*
+* If no EULA applies, Cypress hereby grants you a personal, nonexclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress’s integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND, 
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED 
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress 
+* reserves the right to make changes to the Software without notice. Cypress 
+* does not assume any liability arising out of the application or use of the 
+* Software or any product or circuit described in the Software. Cypress does 
+* not authorize its products for use in any products where a malfunction or 
+* failure of the Cypress product may reasonably be expected to result in 
+* significant property damage, injury or death (“High Risk Product”). By 
+* including Cypress’s product in a High Risk Product, the manufacturer of such 
+* system or application assumes all risk of such use and in doing so agrees to 
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "ble_port.h"
+#include "host_main.h"
+
+#include "cy_pdl.h"
+#include "cyhal.h"
+#include "cybsp.h"
+#include "cy_syslib.h"
+#include "cy_sysint.h"
+#include "cycfg.h"
+#include "cycfg_ble.h"
+
+/******************************************************************************
+* Macros
+*******************************************************************************/
+#define ENABLE      (1u)
+#define DISABLE     (0u)
+
+#define DEBUG_BLE_ENABLE    	DISABLE
+#define DEBUG_BLE_LOGIC_ENABLE	DISABLE
+
+#include <stdio.h>
+
+#if DEBUG_BLE_ENABLE
+#define DEBUG_BLE       printf
+#else
+#define DEBUG_BLE(...)
+#endif
+
+#if DEBUG_BLE_LOGIC_ENABLE
+#define DEBUG_BLE_LOGIC       printf
+#else
+#define DEBUG_BLE_LOGIC(...)
+#endif
+
+
+#define SUCCESS                     (0u)
+#define TARGET_BDADDR       {{0xFF, 0xBB, 0xAA, 0x50, 0xA0, 0x00}, 0}
+
+/**
+ * Get access to the custom characteristic and to its descriptor.
+ * The characteristic can be configured using the Bluetooth Configurator tool
+ * The descriptor enables to configure the behavior of the characteristic.
+ * In our case, it will be used to enable or disable notifications
+ */
+#define CUSTOM_DESCR_HANDLE	cy_ble_customsConfig.attrInfo[0].customServInfo[0].customServCharDesc[0]
+#define CUSTOM_CHAR_HANDLE	cy_ble_customsConfig.attrInfo[0].customServInfo[0].customServCharHandle
+
+/**
+ * Command characteristic (write and write without response)
+ * Used for commands with request id and bulk inbound data (NTRIP)
+ */
+#define CUSTOM_CMD_CHAR_HANDLE	cy_ble_customsConfig.attrInfo[0].customServInfo[1].customServCharHandle
+
+
+/*******************************************************************************
+* Variables
+*******************************************************************************/
+
+cy_stc_ble_gap_bd_addr_t local_addr = TARGET_BDADDR;
+cy_stc_ble_conn_handle_t appConnHandle;
+cy_stc_ble_gatts_handle_value_ntf_t notificationPacket;
+
+/* Set by the BLESS interrupt, cleared when the stack processes its events */
+static volatile uint8_t events_pending = 0;
+
+/* BLESS interrupt configuration.
+ * It is used when BLE middleware operates in BLE Single CM4 Core mode. */
+const cy_stc_sysint_t blessIsrCfg =
+{
+    /* The BLESS interrupt */
+    .intrSrc      = bless_interrupt_IRQn,
+
+    /* The interrupt priority number */
+    .intrPriority = 1u
+};
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+void BlessInterrupt(void);
+void IasEventHandler(uint32_t event, void *eventParam);
+void StackEventHandler(uint32 event, void* eventParam);
+cy_en_ble_api_result_t SendAnswerNotification(uint16_t len, uint8_t* content);
+
+#if (CY_BLE_GATT_MTU > BLE_PORT_MAX_MTU)
+#error "CY_BLE_GATT_MTU is larger than BLE_PORT_MAX_MTU"
+#endif
+
+/*******************************************************************************
+* Function Name: ble_port_init()
+********************************************************************************
+*
+* Summary:
+*   This function initializes BLE.
+*
+* Return:
+*   0 (errors are only reported on the debug UART)
+*
+*******************************************************************************/
+int ble_port_init()
+{
+    cy_en_ble_api_result_t apiResult;
+    cy_stc_ble_stack_lib_version_t stackVersion;
+
+	notificationPacket.handleValPair.value.val = NULL;
+	notificationPacket.handleValPair.value.len = 0;
+
+    /* Initialize the BLESS interrupt */
+    cy_ble_config.hw->blessIsrConfig = &blessIsrCfg;
+    Cy_SysInt_Init(cy_ble_config.hw->blessIsrConfig, BlessInterrupt);
+
+    /* Register the generic event handler */
+    Cy_BLE_RegisterEventCallback(StackEventHandler);
+
+    /* Initialize the BLE */
+    Cy_BLE_Init(&cy_ble_config);
+
+    /* Enable BLE */
+    Cy_BLE_Enable();
+
+    /* Register the IAS CallBack */
+    Cy_BLE_IAS_RegisterAttrCallback(IasEventHandler);
+    
+    apiResult = Cy_BLE_GetStackLibraryVersion(&stackVersion);
+    
+    if(apiResult != CY_BLE_SUCCESS)
+    {
+        DEBUG_BLE("Cy_BLE_GetStackLibraryVersion API Error: 0x%2.2x \r\n",apiResult);
+    }
+    else
+    {
+        DEBUG_BLE("Stack Version: %d.%d.%d.%d \r\n", stackVersion.majorVersion, 
+        stackVersion.minorVersion, stackVersion.patch, stackVersion.buildNumber);
+    }
+
+    return 0;
+}
+
+void ble_port_process_events()
+{
+    // Cleared first: an interrupt occurring during the processing leaves it set
+    events_pending = 0;
+
+    // Cy_Ble_ProcessEvents() allows BLE stack to process pending events
+    Cy_BLE_ProcessEvents();
+}
+
+uint8_t ble_port_has_pending_events()
+{
+    return events_pending;
+}
+
+uint8_t ble_port_is_free()
+{
+    return (Cy_BLE_GATT_GetBusyStatus(appConnHandle.attId) == CY_BLE_STACK_STATE_FREE) ? 1 : 0;
+}
+
+/**
+ * @brief Forward a write to host_main (queued, processed later by host_main_do)
+ *
+ * @retval 0 Command queued
+ * @retval < 0 Command dropped (see host_main_on_write)
+ */
+static int receive_write(uint8_t characteristic, cy_stc_ble_gatt_value_t* value)
+{
+	return host_main_on_write(characteristic, value->val, value->len);
+}
+
+/**
+ * @brief Forward a write request to host_main, then answer it
+ * The client gets an error response if the command has not been queued
+ */
+static void receive_write_request(uint8_t characteristic, cy_stc_ble_gatt_write_param_t* write_req_param)
+{
+	int result = receive_write(characteristic, &write_req_param->handleValPair.value);
+	if (result == 0)
+	{
+		if(Cy_BLE_GATTS_WriteRsp(write_req_param->connHandle) != CY_BLE_SUCCESS)
+		{
+			DEBUG_BLE("Failed to send write response \r\n");
+		}
+		return;
+	}
+
+	cy_stc_ble_gatt_err_param_t err_param;
+	err_param.errInfo.attrHandle = write_req_param->handleValPair.attrHandle;
+	err_param.errInfo.opCode = CY_BLE_GATT_WRITE_REQ;
+	err_param.errInfo.errorCode = (result == -2) ? CY_BLE_GATT_ERR_INSUFFICIENT_RESOURCE : CY_BLE_GATT_ERR_INVALID_ATTRIBUTE_LEN;
+	err_param.connHandle = write_req_param->connHandle;
+	if(Cy_BLE_GATTS_ErrorRsp(&err_param) != CY_BLE_SUCCESS)
+	{
+		DEBUG_BLE("Failed to send error response \r\n");
+	}
+}
+
+/*******************************************************************************
+* Function Name: StackEventHandler()
+********************************************************************************
+*
+* Summary:
+*   This is an event callback function to receive events from the BLE Component.
+*
+*  event - the event code
+*  *eventParam - the event parameters
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+void StackEventHandler(uint32 event, void* eventParam)
+{
+    cy_en_ble_api_result_t apiResult;
+
+    switch(event)
+    {
+         /* There are some events generated by the BLE component
+        *  that are not required for this code example. */
+        
+        /**********************************************************
+        *                       General Events
+        ***********************************************************/
+        /* This event is received when the BLE component is Started */
+        case CY_BLE_EVT_STACK_ON:
+        {
+            DEBUG_BLE("CY_BLE_EVT_STACK_ON, Start Advertisement \r\n");
+            /* Enter into discoverable mode so that remote device can search it */
+            Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST, CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+            
+            break;
+        }    
+        /* This event is received when there is a timeout. */
+        case CY_BLE_EVT_TIMEOUT:
+        {
+			DEBUG_BLE("CY_BLE_EVT_TIMEOUT \r\n"); 
+            
+            break;
+		}   
+        /* This event indicates that some internal HW error has occurred. */    
+		case CY_BLE_EVT_HARDWARE_ERROR:    
+        {
+			DEBUG_BLE("Hardware Error \r\n");
+            
+			break;
+		}   
+        /*  This event will be triggered by host stack if BLE stack is busy or 
+         *  not busy. Parameter corresponding to this event will be the state 
+    	 *  of BLE stack.
+         *  BLE stack busy = CY_BLE_STACK_STATE_BUSY,
+    	 *  BLE stack not busy = CY_BLE_STACK_STATE_FREE 
+         */
+    	case CY_BLE_EVT_STACK_BUSY_STATUS:
+        {
+			DEBUG_BLE("CY_BLE_EVT_STACK_BUSY_STATUS: %x\r\n", *(uint8 *)eventParam);
+
+			// Stack buffers have been flushed, new notifications can be accepted
+			if (*(uint8 *)eventParam == CY_BLE_STACK_STATE_FREE)
+			{
+				host_main_on_stack_free();
+			}
+            
+			break;
+		}
+        /* This event indicates completion of Set LE event mask. */
+        case CY_BLE_EVT_LE_SET_EVENT_MASK_COMPLETE:
+        {
+			DEBUG_BLE("CY_BLE_EVT_LE_SET_EVENT_MASK_COMPLETE \r\n");
+            
+            break;
+		}            
+        /* This event indicates set device address command completed. */
+        case CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE:
+        {
+            DEBUG_BLE("CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE \r\n");
+            
+            cy_stc_ble_events_param_generic_t *param = \
+			(cy_stc_ble_events_param_generic_t *) eventParam;
+        
+            if( param->status != SUCCESS)
+            {
+                DEBUG_BLE("Failed to Set Local BDAddress [Status 0x%02X]\r\n",\
+                    param->status);
+               
+            }
+            else
+            {
+                DEBUG_BLE("Local Address Set successfully \r\n");
+                DEBUG_BLE("BdAddress set to: %02X:%02X:%02X:%02X:%02X:%02X \r\n",\
+                    local_addr.bdAddr[5],local_addr.bdAddr[4], local_addr.bdAddr[3],\
+                    local_addr.bdAddr[2], local_addr.bdAddr[1], local_addr.bdAddr[0]);  
+                          
+                Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST,\
+				CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+            }
+            
+            break;
+        }
+            
+        /* This event indicates get device address command completed
+           successfully */
+        case CY_BLE_EVT_GET_DEVICE_ADDR_COMPLETE:
+        {
+			DEBUG_BLE("CY_BLE_EVT_GET_DEVICE_ADDR_COMPLETE: ");
+            DEBUG_BLE("\n\rAdvertising with Address: ");
+            for(uint8_t i = CY_BLE_GAP_BD_ADDR_SIZE; i > 0u; i--)
+            {
+                DEBUG_BLE("%2.2X ", ((cy_stc_ble_bd_addrs_t *)\
+				((cy_stc_ble_events_param_generic_t *)eventParam)->eventParams)\
+				  ->publicBdAddr[i-1]);
+            }
+            DEBUG_BLE("\r\n");
+            
+            break;
+		}
+        /* This event indicates set Tx Power command completed. */
+        case CY_BLE_EVT_SET_TX_PWR_COMPLETE:
+        {
+			DEBUG_BLE("CY_BLE_EVT_SET_TX_PWR_COMPLETE \r\n");
+            
+            break;
+		}                       
+            
+        /**********************************************************
+        *                       GAP Events
+        ***********************************************************/
+       
+        /* This event indicates peripheral device has started/stopped
+           advertising. */
+        case CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
+        {
+            DEBUG_BLE("CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP: ");
+            if(Cy_BLE_GetConnectionState(appConnHandle) == CY_BLE_CONN_STATE_DISCONNECTED)
+            {
+                DEBUG_BLE(" <Restart ADV> \r\n");
+                DEBUG_BLE_LOGIC("Advertising...\r\n\n");
+                Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST,\
+                               				   CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+                host_main_on_advertising();
+            }
+           
+            break;
+        }
+            
+        /* This event is triggered instead of 'CY_BLE_EVT_GAP_DEVICE_CONNECTED', 
+        if Link Layer Privacy is enabled in component customizer. */
+        case CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE:
+        {
+            /* BLE link is established */
+            /* This event will be triggered since link layer privacy is enabled */
+            DEBUG_BLE("CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE \r\n");
+            
+            cy_stc_ble_gap_enhance_conn_complete_param_t *param = \
+            (cy_stc_ble_gap_enhance_conn_complete_param_t *)eventParam;
+
+            // Connection interval is given in 1.25ms units
+            host_main_on_conn_interval(((uint32_t) param->connIntv) * 1250u);
+
+#if (DEBUG_BLE_ENABLE || DEBUG_BLE_LOGIC_ENABLE)
+            DEBUG_BLE_LOGIC("Connected to Device ");
+
+			DEBUG_BLE_LOGIC("%02X:%02X:%02X:%02X:%02X:%02X\r\n\n",param->peerBdAddr[5],\
+					param->peerBdAddr[4], param->peerBdAddr[3], param->peerBdAddr[2],\
+					param->peerBdAddr[1], param->peerBdAddr[0]);
+
+			DEBUG_BLE("\r\nBDhandle : 0x%02X\r\n", param->bdHandle);
+#endif
+            cyhal_gpio_write((cyhal_gpio_t)LED2, CYBSP_LED_STATE_ON);
+            break;
+        }
+        
+        /* This event is triggered when there is a change to either the maximum Payload 
+        length or the maximum transmission time of Data Channel PDUs in either direction */
+        case CY_BLE_EVT_DATA_LENGTH_CHANGE:
+        {
+            DEBUG_BLE("CY_BLE_EVT_DATA_LENGTH_CHANGE \r\n");
+            cy_stc_ble_set_phy_info_t phyParam;
+            
+            /* Configure the BLE Component for 2Mbps data rate */
+            phyParam.bdHandle = appConnHandle.bdHandle;
+            phyParam.allPhyMask = CY_BLE_PHY_NO_PREF_MASK_NONE;
+            phyParam.phyOption = 0;
+			// Set to 1M (bug with iPhone 16 when set to 2M)
+            phyParam.rxPhyMask = CY_BLE_PHY_MASK_LE_1M;
+            phyParam.txPhyMask = CY_BLE_PHY_MASK_LE_1M;
+            
+            Cy_BLE_EnablePhyUpdateFeature();
+            apiResult = Cy_BLE_SetPhy(&phyParam);
+            if(apiResult != CY_BLE_SUCCESS)
+            {
+                DEBUG_BLE("Failed to set PHY..[bdHandle 0x%02X] : 0x%4x\r\n",
+                    phyParam.bdHandle, apiResult);
+            }
+            else
+            {
+                DEBUG_BLE("Setting PHY.[bdHandle 0x%02X] \r\n", phyParam.bdHandle);
+            }
+            
+            break;
+        }
+        
+        /* This event is generated at the GAP Peripheral end after connection 
+           is completed with peer Central device. */
+        case CY_BLE_EVT_GAP_DEVICE_CONNECTED: 
+		{
+			DEBUG_BLE("CY_BLE_EVT_GAP_DEVICE_CONNECTED \r\n");
+			cy_stc_ble_gap_connected_param_t *param = (cy_stc_ble_gap_connected_param_t *)eventParam;
+			host_main_on_connected(((uint32_t) param->connIntv) * 1250u);
+                      
+            break;
+		}            
+        /* This event is generated when disconnected from remote device or 
+           failed to establish connection. */
+        case CY_BLE_EVT_GAP_DEVICE_DISCONNECTED:   
+		{
+			if(Cy_BLE_GetConnectionState(appConnHandle) == CY_BLE_CONN_STATE_DISCONNECTED)
+            {
+                DEBUG_BLE("CY_BLE_EVT_GAP_DEVICE_DISCONNECTED %d\r\n",\
+                    CY_BLE_CONN_STATE_DISCONNECTED);
+            }
+            
+            /* Device disconnected; restart advertisement */
+            host_main_on_disconnected();
+            Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST,\
+                CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
+            
+            break;
+		}            
+        /* This event is generated at the GAP Central and the peripheral end 
+           after connection parameter update is requested from the host to 
+           the controller. */
+        case CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE:
+		{
+			DEBUG_BLE("CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE \r\n");
+
+			cy_stc_ble_gap_conn_param_updated_in_controller_t *param = \
+			(cy_stc_ble_gap_conn_param_updated_in_controller_t *)eventParam;
+			if (param->status == SUCCESS)
+			{
+				host_main_on_conn_interval(((uint32_t) param->connIntv) * 1250u);
+			}
+            
+            break;
+		}
+        /* This event indicates completion of the Cy_BLE_SetPhy API*/
+		case CY_BLE_EVT_SET_PHY_COMPLETE:
+        {
+            DEBUG_BLE("Updating the Phy.....\r\n");
+            cy_stc_ble_events_param_generic_t * param =\
+            (cy_stc_ble_events_param_generic_t *) eventParam;
+            if(param->status ==SUCCESS)
+            {
+                DEBUG_BLE("SET PHY updated to 2 Mbps\r\n");
+                Cy_BLE_GetPhy(appConnHandle.bdHandle);
+            }
+            else
+            {
+                DEBUG_BLE("SET PHY Could not update to 2 Mbps\r\n");
+                Cy_BLE_GetPhy(appConnHandle.bdHandle);
+            }
+            
+            break;
+        }
+        /* This event indicates completion of the Cy_BLE_GetPhy API */
+        case CY_BLE_EVT_GET_PHY_COMPLETE:
+        {
+            /* To remove unused parameter warning when UART debug is disabled */
+            #if (DEBUG_BLE == ENABLE)
+            cy_stc_ble_events_param_generic_t *param =\
+            cy_stc_ble_events_param_generic_t *)eventParam;
+            cy_stc_ble_phy_param_t *phyparam = NULL;
+                      
+            if(param->status == SUCCESS)
+            {
+                phyparam = (cy_stc_ble_phy_param_t *)param->eventParams;
+                DEBUG_BLE("RxPhy Mask : 0x%02X\r\nTxPhy Mask : 0x%02X\r\n", \
+                    phyparam->rxPhyMask, phyparam->txPhyMask);            
+            }
+            #endif
+            
+            break;
+
+        }
+        /* This event indicates that the controller has changed the transmitter
+           PHY or receiver PHY in use */
+        case CY_BLE_EVT_PHY_UPDATE_COMPLETE:
+        {
+            DEBUG_BLE("UPDATE PHY parameters\r\n");
+             /* To remove unused parameter warning when UART debug is disabled */
+            #if (DEBUG_BLE == ENABLE)
+            cy_stc_ble_events_param_generic_t *param =\
+           (cy_stc_ble_events_param_generic_t *)eventParam;
+            cy_stc_ble_phy_param_t *phyparam = NULL;
+            if(param->status == SUCCESS)
+            {
+                phyparam = (cy_stc_ble_phy_param_t *)param->eventParams;
+                DEBUG_BLE("RxPhy Mask : 0x%02X\r\nTxPhy Mask : 0x%02X\r\n",\
+                    phyparam->rxPhyMask, phyparam->txPhyMask);            
+            }
+            #endif
+            
+            break;
+        }		
+            
+        /**********************************************************
+        *                       GATT Events
+        ***********************************************************/
+            
+        /* This event is generated at the GAP Peripheral end after connection 
+           is completed with peer Central device. */
+        case CY_BLE_EVT_GATT_CONNECT_IND:
+        {
+            appConnHandle = *(cy_stc_ble_conn_handle_t *)eventParam;
+            DEBUG_BLE("CY_BLE_EVT_GATT_CONNECT_IND: %x, %x \r\n", 
+                        appConnHandle.attId, 
+                        appConnHandle.bdHandle);
+            
+            /* Update Notification packet with the data. */
+            notificationPacket.connHandle = appConnHandle;
+            notificationPacket.handleValPair.attrHandle = CUSTOM_CHAR_HANDLE;
+            
+            Cy_BLE_GetPhy(appConnHandle.bdHandle);                   
+           
+            break;
+        }    
+        /* This event is generated at the GAP Peripheral end after disconnection. */
+        case CY_BLE_EVT_GATT_DISCONNECT_IND:
+        {
+            DEBUG_BLE("CY_BLE_EVT_GATT_DISCONNECT_IND \r\n");
+            if(appConnHandle.bdHandle == (*(cy_stc_ble_conn_handle_t *)eventParam).bdHandle)
+            {
+            	DEBUG_BLE_LOGIC("Disconnected. \r\n\n");
+                appConnHandle.bdHandle = CY_BLE_INVALID_CONN_HANDLE_VALUE;
+                appConnHandle.attId    = CY_BLE_INVALID_CONN_HANDLE_VALUE;
+            }
+            cyhal_gpio_write((cyhal_gpio_t)LED2, CYBSP_LED_STATE_OFF);
+            
+            break;
+        }
+        /* This event is triggered when 'GATT MTU Exchange Request' 
+           received from GATT client device. */
+        case CY_BLE_EVT_GATTS_XCNHG_MTU_REQ:
+        {
+            uint16_t mtu = (((cy_stc_ble_gatt_xchg_mtu_param_t *)eventParam)->mtu < CY_BLE_GATT_MTU) ?
+                            ((cy_stc_ble_gatt_xchg_mtu_param_t *)eventParam)->mtu : CY_BLE_GATT_MTU;
+            DEBUG_BLE_LOGIC("Negotiated MTU size: %d \r\n", mtu);
+            host_main_on_mtu_exchanged(mtu);
+            
+            break;
+        }   
+        /* This event is triggered when there is a write request from the 
+           Client device */
+        case CY_BLE_EVT_GATTS_WRITE_REQ:
+        {
+        	DEBUG_BLE_LOGIC("StackEventHandler CY_BLE_EVT_GATTS_WRITE_REQ. Event : %ld \r\n", event);
+
+            DEBUG_BLE("CY_BLE_EVT_GATTS_WRITE_REQ \r\n");  
+            cy_stc_ble_gatt_write_param_t *write_req_param = \
+            (cy_stc_ble_gatt_write_param_t *)eventParam;
+            cy_stc_ble_gatts_db_attr_val_info_t attr_param;
+                        
+            DEBUG_BLE("Received GATT Write Request [bdHandle %02X]\r\n",\
+                write_req_param->connHandle.bdHandle);
+            attr_param.connHandle.bdHandle = write_req_param->connHandle.bdHandle;
+            attr_param.connHandle.attId = write_req_param->connHandle.attId;
+            attr_param.flags = CY_BLE_GATT_DB_PEER_INITIATED;
+            attr_param.handleValuePair = write_req_param->handleValPair;
+            attr_param.offset = 0;
+            
+            DEBUG_BLE("write_req_param->handleValPair.attrHandle = %d  \r\n", write_req_param->handleValPair.attrHandle);
+            DEBUG_BLE("CUSTOM_DESCR_HANDLE (%d)\r\n CUSTOM_CHAR_HANDLE(%d)\r\n",CUSTOM_DESCR_HANDLE, CUSTOM_CHAR_HANDLE);
+                  
+           
+			if(write_req_param->handleValPair.attrHandle == (CUSTOM_DESCR_HANDLE))
+            {
+                if(Cy_BLE_GATTS_WriteRsp(write_req_param->connHandle) != CY_BLE_SUCCESS)
+                {
+                    DEBUG_BLE("Failed to send write response \r\n");
+                    DEBUG_BLE_LOGIC("Error... \r\n");
+                }
+                else
+                {
+                    DEBUG_BLE("GATT write response sent \r\n");
+                    host_main_on_notification_config(attr_param.handleValuePair.value.val[0]);
+                    DEBUG_BLE("Notification config = %d\r\n", attr_param.handleValuePair.value.val[0]);
+                    DEBUG_BLE_LOGIC("Notification Enabled.\r\n\n");
+                    notificationPacket.connHandle = appConnHandle;
+                    notificationPacket.handleValPair.attrHandle = CUSTOM_CHAR_HANDLE;
+                }
+
+                DEBUG_BLE_LOGIC("Allright \r\n");
+            }
+			else if(write_req_param->handleValPair.attrHandle == (CUSTOM_CHAR_HANDLE))
+			{
+				DEBUG_BLE_LOGIC("Write to custom characteristic detected. \r\n");
+
+				// Queue the command first, the response tells the client if it has been accepted
+				receive_write_request(BLE_PORT_CHAR_DATA, write_req_param);
+			}
+			else if(write_req_param->handleValPair.attrHandle == (CUSTOM_CMD_CHAR_HANDLE))
+			{
+				receive_write_request(BLE_PORT_CHAR_CMD, write_req_param);
+			}
+			else
+			{
+				DEBUG_BLE_LOGIC("Not correct is %d but should be %d or %d \r\n", write_req_param->handleValPair.attrHandle, CUSTOM_DESCR_HANDLE, CUSTOM_CHAR_HANDLE);
+			}
+            break;
+        }
+        /* This event is triggered when there is a write without response
+           (write command) from the Client device */
+        case CY_BLE_EVT_GATTS_WRITE_CMD_REQ:
+        {
+            cy_stc_ble_gatts_write_cmd_req_param_t *write_cmd_param = \
+            (cy_stc_ble_gatts_write_cmd_req_param_t *)eventParam;
+
+            if(write_cmd_param->handleValPair.attrHandle == (CUSTOM_CMD_CHAR_HANDLE))
+            {
+                // No response: a dropped command is only counted
+                (void) receive_write(BLE_PORT_CHAR_CMD, &write_cmd_param->handleValPair.value);
+            }
+            break;
+        }
+        case CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ:
+        {
+            DEBUG_BLE("CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ \r\n");  
+            break;
+        }
+        /**********************************************************
+        *                       Other Events
+        ***********************************************************/
+        default:
+            DEBUG_BLE("OTHER event: %lx \r\n", (unsigned long) event);
+			break;
+        
+    }
+}
+
+int ble_port_notify(uint8_t* content, uint16_t len)
+{
+    cy_en_ble_api_result_t apiResult = SendAnswerNotification(len, content);
+    if (apiResult == CY_BLE_ERROR_INVALID_PARAMETER) return -2;
+    if (apiResult != CY_BLE_SUCCESS) return -1;
+    return 0;
+}
+
+cy_en_ble_api_result_t SendAnswerNotification(uint16_t len, uint8_t* content)
+{
+    cy_en_ble_api_result_t apiResult;
+    // The stack copies the value inside its own buffers, no need for an intermediate copy
+    notificationPacket.handleValPair.value.val = content;
+    notificationPacket.handleValPair.value.len = len;
+
+    apiResult = Cy_BLE_GATTS_Notification(&notificationPacket);
+    if(apiResult == CY_BLE_ERROR_INVALID_PARAMETER)
+    {
+        DEBUG_BLE("Couldn't send notification. [CY_BLE_ERROR_INVALID_PARAMETER]\r\n");
+    }
+    else if(apiResult != CY_BLE_SUCCESS)
+    {
+        DEBUG_BLE("Attrhandle = 0x%4X  Cy_BLE_GATTS_Notification API Error:"\
+            "0x%2.2x \r\n", notificationPacket.handleValPair.attrHandle, apiResult);
+    }
+    // Set back
+    notificationPacket.handleValPair.value.val = NULL;
+    notificationPacket.handleValPair.value.len = 0;
+
+    return apiResult;
+}
+
+/*******************************************************************************
+* Function Name: BlessInterrupt
+********************************************************************************
+* BLESS ISR
+* It is used used when BLE middleware operates in BLE single CM4
+*
+*******************************************************************************/
+/* BLESS ISR */
+void BlessInterrupt(void)
+{
+    /* Call interrupt processing */
+    Cy_BLE_BlessIsrHandler();
+
+    events_pending = 1;
+}
+
+void IasEventHandler(uint32_t event, void *eventParam)
+{
+    (void) eventParam;
+}
+
+/* [] END OF FILE */
@@ -29,7 +29,7 @@ static struct bmi2_dev bmi2_dev;
 const struct bmi2_int_pin_config int_config =
 {
 		.pin_type = BMI2_INT1,
-		.int_latch = BMI2_INT_LATCH,
+		.int_latch = BMI2_INT_NON_LATCH,	/* Pulse on each sample, the status does not have to be read to clear it */
 		.pin_cfg[0].lvl = BMI2_INT_ACTIVE_HIGH,
 		.pin_cfg[0].od = BMI2_INT_PUSH_PULL,
 		.pin_cfg[0].output_en = BMI2_INT_OUTPUT_ENABLE,
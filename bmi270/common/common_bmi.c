@@ -40,10 +40,7 @@ BMI2_INTF_RETURN_TYPE bmi2_i2c_read(uint8_t reg_addr, uint8_t *reg_data, uint32_
 	int8_t result;
     uint8_t dev_addr = *(uint8_t*)intf_ptr;
 
-    result = i2c_write_bytes(dev_addr, &reg_addr, sizeof(reg_addr));
-    if (result != 0) return BMI2_E_COM_FAIL;
-
-    result = i2c_read_bytes(dev_addr, reg_data, (uint16_t) len);
+    result = i2c_read_bytes(dev_addr, reg_addr, reg_data, (uint16_t) len);
     if (result != 0) return BMI2_E_COM_FAIL;
 
 	 return BMI2_OK;
@@ -56,27 +53,11 @@ BMI2_INTF_RETURN_TYPE bmi2_i2c_write(uint8_t reg_addr, const uint8_t *reg_data,
 {
 	int8_t result;
     uint8_t dev_addr = *(uint8_t*)intf_ptr;
-    uint8_t* i2c_data = NULL;
-
-	/*Allocate buffer for transmission*/
-    i2c_data = malloc(len+1);
-    if(i2c_data == NULL)
-    {
-    	return BMI2_E_NULL_PTR;
-    }
-
-    /*Copy register address and all the data*/
-    i2c_data[0] = reg_addr;
-    memcpy(&i2c_data[1], reg_data, len);
 
-    result = i2c_write_bytes(dev_addr, i2c_data, (uint16_t)(len + 1));
-    if (result != 0)
-    {
-    	free(i2c_data);
-    	return BMI2_E_COM_FAIL;
-    }
+    /*Register address and data are sent without copy*/
+    result = i2c_write_bytes(dev_addr, reg_addr, (uint8_t*) reg_data, (uint16_t) len);
+    if (result != 0) return BMI2_E_COM_FAIL;
 
-    free(i2c_data);
     return BMI2_OK;
 }
 
@@ -15,8 +15,8 @@ extern "C" {
 #include <stdio.h>
 #include "bmi2.h"
 
-typedef int8_t (*bmi270_read_func_t)(uint8_t dev_addr, uint8_t *data, uint16_t len);
-typedef int8_t (*bmi270_write_func_t)(uint8_t dev_addr, uint8_t *data, uint16_t len);
+typedef int8_t (*bmi270_read_func_t)(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint16_t len);
+typedef int8_t (*bmi270_write_func_t)(uint8_t dev_addr, uint8_t reg_addr, uint8_t *data, uint16_t len);
 typedef void (*bmi270_sleep_func_t)(uint16_t us);
 
 
@@ -0,0 +1,72 @@
+/*
+ * command_queue.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "command_queue.h"
+
+#define COMMAND_QUEUE_MASK			(COMMAND_QUEUE_SIZE - 1)
+#define COMMAND_QUEUE_PREFIX_SIZE	2
+
+static void write_byte(command_queue_t* queue, uint16_t index, uint8_t value)
+{
+	queue->buffer[index & COMMAND_QUEUE_MASK] = value;
+}
+
+static uint8_t read_byte(command_queue_t* queue, uint16_t index)
+{
+	return queue->buffer[index & COMMAND_QUEUE_MASK];
+}
+
+void command_queue_init(command_queue_t* queue)
+{
+	queue->head = 0;
+	queue->tail = 0;
+}
+
+uint16_t command_queue_get_used(command_queue_t* queue)
+{
+	return (uint16_t)(queue->head - queue->tail);
+}
+
+int command_queue_push(command_queue_t* queue, uint8_t header, const uint8_t* data, uint16_t len)
+{
+	const uint16_t entry_len = len + 1;
+	const uint32_t needed = (uint32_t) entry_len + COMMAND_QUEUE_PREFIX_SIZE;
+
+	if (needed > (uint32_t)(COMMAND_QUEUE_SIZE - command_queue_get_used(queue))) return -1;
+
+	uint16_t index = queue->head;
+	write_byte(queue, index++, (uint8_t)(entry_len & 0xFF));
+	write_byte(queue, index++, (uint8_t)(entry_len >> 8));
+	write_byte(queue, index++, header);
+
+	for(uint16_t i = 0; i < len; ++i)
+	{
+		write_byte(queue, index++, data[i]);
+	}
+
+	// Publish the entry once completely written
+	queue->head = index;
+	return 0;
+}
+
+uint16_t command_queue_pop(command_queue_t* queue, uint8_t* data, uint16_t max_len)
+{
+	if (command_queue_get_used(queue) == 0) return 0;
+
+	uint16_t index = queue->tail;
+	uint16_t entry_len = (uint16_t) read_byte(queue, index);
+	entry_len |= ((uint16_t) read_byte(queue, index + 1)) << 8;
+	index += COMMAND_QUEUE_PREFIX_SIZE;
+
+	for(uint16_t i = 0; (i < entry_len) && (i < max_len); ++i)
+	{
+		data[i] = read_byte(queue, index + i);
+	}
+
+	queue->tail = index + entry_len;
+	return entry_len;
+}
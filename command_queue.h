@@ -0,0 +1,67 @@
+/*
+ * command_queue.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef COMMAND_QUEUE_H_
+#define COMMAND_QUEUE_H_
+
+#include <stdint.h>
+
+/**
+ * @def COMMAND_QUEUE_SIZE
+ * @brief Size in bytes of the buffer storing the received commands (must be a power of two)
+ * Each entry uses its length + 2 bytes (length prefix)
+ */
+#ifndef COMMAND_QUEUE_SIZE
+#define COMMAND_QUEUE_SIZE	2048
+#endif
+
+#if ((COMMAND_QUEUE_SIZE & (COMMAND_QUEUE_SIZE - 1)) != 0)
+#error "COMMAND_QUEUE_SIZE must be a power of two"
+#endif
+
+/**
+ * Ring buffer of length prefixed entries
+ * Single producer (BLE stack event handler) / single consumer (host_main_do)
+ */
+typedef struct
+{
+	uint8_t buffer[COMMAND_QUEUE_SIZE];
+	volatile uint16_t head;		/**< Write index (written by the producer) */
+	volatile uint16_t tail;		/**< Read index (written by the consumer) */
+} command_queue_t;
+
+void command_queue_init(command_queue_t* queue);
+
+/**
+ * @brief Store an entry made of a header byte followed by the content
+ *
+ * @param [in] header First byte of the entry (used to store where the entry comes from)
+ * @param [in] data Content of the entry
+ * @param [in] len Length of the content
+ *
+ * @retval 0 Success
+ * @retval -1 Not enough space, entry not stored
+ */
+int command_queue_push(command_queue_t* queue, uint8_t header, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief Read and remove the oldest entry
+ *
+ * @param [out] data Buffer in which the entry (header byte + content) is copied
+ * @param [in] max_len Size of the buffer. If the entry is longer, it is truncated
+ *
+ * @retval 0 Queue is empty
+ * @retval > 0 Length of the entry (header byte + content), before truncation
+ */
+uint16_t command_queue_pop(command_queue_t* queue, uint8_t* data, uint16_t max_len);
+
+/**
+ * @brief Get the number of bytes used inside the queue
+ */
+uint16_t command_queue_get_used(command_queue_t* queue);
+
+#endif /* COMMAND_QUEUE_H_ */
@@ -0,0 +1,123 @@
+/*
+ * hal_data_ready.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "hal_data_ready.h"
+
+#include "cyhal.h"
+#include "cybsp.h"
+
+/**
+ * Pins of the interrupt lines (Arduino connector)
+ */
+#ifndef HAL_DATA_READY_BMI270_PIN
+#define HAL_DATA_READY_BMI270_PIN	ARDU_IO1
+#endif
+
+#ifndef HAL_DATA_READY_BMI323_PIN
+#define HAL_DATA_READY_BMI323_PIN	ARDU_IO2
+#endif
+
+#ifndef HAL_DATA_READY_TMF8828_PIN
+#define HAL_DATA_READY_TMF8828_PIN	ARDU_IO5
+#endif
+
+#define DATA_READY_IRQ_PRIORITY		5
+
+typedef struct
+{
+	cyhal_gpio_t pin;
+	uint8_t active_high;
+	uint8_t level_sensitive;		/**< Line stays active until the sensor is read (pulse otherwise) */
+} line_config_t;
+
+typedef struct
+{
+	cyhal_gpio_callback_data_t callback_data;
+	volatile uint8_t edge;
+	volatile uint32_t edge_count;
+	uint8_t initialised;
+} line_state_t;
+
+static const line_config_t line_configs[HAL_DATA_READY_LINES] =
+{
+	[HAL_DATA_READY_BMI270] = {HAL_DATA_READY_BMI270_PIN, 1, 0},
+	[HAL_DATA_READY_BMI323] = {HAL_DATA_READY_BMI323_PIN, 1, 0},
+	[HAL_DATA_READY_TMF8828] = {HAL_DATA_READY_TMF8828_PIN, 0, 1},
+};
+
+static line_state_t line_states[HAL_DATA_READY_LINES] = {0};
+
+static void data_ready_isr(void *callback_arg, cyhal_gpio_event_t event)
+{
+	(void) event;
+
+	line_state_t* state = (line_state_t*) callback_arg;
+	state->edge = 1;
+	state->edge_count++;
+}
+
+int hal_data_ready_init(hal_data_ready_line_e line)
+{
+	if (line >= HAL_DATA_READY_LINES) return -1;
+
+	line_state_t* state = &line_states[line];
+	if (state->initialised != 0) return 0;
+
+	const line_config_t* config = &line_configs[line];
+
+	// Pulled to the inactive level: a line that is not connected never triggers
+	cyhal_gpio_drive_mode_t drive_mode = (config->active_high != 0) ? CYHAL_GPIO_DRIVE_PULLDOWN : CYHAL_GPIO_DRIVE_PULLUP;
+	bool init_value = (config->active_high != 0) ? false : true;
+	if (cyhal_gpio_init(config->pin, CYHAL_GPIO_DIR_INPUT, drive_mode, init_value) != CY_RSLT_SUCCESS) return -1;
+
+	state->edge = 0;
+	state->edge_count = 0;
+	state->callback_data.callback = data_ready_isr;
+	state->callback_data.callback_arg = state;
+	cyhal_gpio_register_callback(config->pin, &state->callback_data);
+
+	cyhal_gpio_event_t event = (config->active_high != 0) ? CYHAL_GPIO_IRQ_RISE : CYHAL_GPIO_IRQ_FALL;
+	cyhal_gpio_enable_event(config->pin, event, DATA_READY_IRQ_PRIORITY, true);
+
+	state->initialised = 1;
+	return 0;
+}
+
+uint8_t hal_data_ready_is_pending(hal_data_ready_line_e line)
+{
+	if (line >= HAL_DATA_READY_LINES) return 0;
+
+	line_state_t* state = &line_states[line];
+	if (state->initialised == 0) return 0;
+	if (state->edge != 0) return 1;
+	if (line_configs[line].level_sensitive == 0) return 0;
+
+	// Still active: an edge has been acknowledged without reading the sensor
+	bool level = cyhal_gpio_read(line_configs[line].pin);
+	return (level == (line_configs[line].active_high != 0)) ? 1 : 0;
+}
+
+uint8_t hal_data_ready_has_edge(hal_data_ready_line_e line)
+{
+	if (line >= HAL_DATA_READY_LINES) return 0;
+
+	return line_states[line].edge;
+}
+
+void hal_data_ready_clear(hal_data_ready_line_e line)
+{
+	if (line >= HAL_DATA_READY_LINES) return;
+
+	line_states[line].edge = 0;
+}
+
+uint32_t hal_data_ready_get_edge_count(hal_data_ready_line_e line)
+{
+	if (line >= HAL_DATA_READY_LINES) return 0;
+
+	return line_states[line].edge_count;
+}
@@ -0,0 +1,61 @@
+/*
+ * hal_data_ready.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HAL_HAL_DATA_READY_H_
+#define HAL_HAL_DATA_READY_H_
+
+#include <stdint.h>
+
+/**
+ * Interrupt (data ready) lines of the sensors
+ *
+ * The pins are defined inside hal_data_ready.c (can be overwritten using the DEFINES of the Makefile).
+ * A line that is not connected never reports an edge, the sensor then has to be polled.
+ */
+typedef enum
+{
+	HAL_DATA_READY_BMI270,		/**< INT1 of the BMI270 (sensor fusion board), push-pull, active high */
+	HAL_DATA_READY_BMI323,		/**< INT1 of the BMI323 (RAB7), push-pull, active high */
+	HAL_DATA_READY_TMF8828,		/**< INT of the TMF8828 (AMS OSRAM TOF board), open drain, active low */
+	HAL_DATA_READY_LINES
+} hal_data_ready_line_e;
+
+/**
+ * @brief Configure the pin of the line and enable its interrupt
+ *
+ * @retval 0 Success
+ * @retval -1 Pin could not be initialised (already used)
+ */
+int hal_data_ready_init(hal_data_ready_line_e line);
+
+/**
+ * @brief Check if the sensor signals new data
+ *
+ * @retval 1 An edge occurred since the last call to hal_data_ready_clear
+ * 			or the line is at its active level (TMF8828: active until its interrupt status is cleared)
+ * @retval 0 No new data
+ */
+uint8_t hal_data_ready_is_pending(hal_data_ready_line_e line);
+
+/**
+ * @brief Check if an edge occurred since the last call to hal_data_ready_clear (does not access the pin)
+ */
+uint8_t hal_data_ready_has_edge(hal_data_ready_line_e line);
+
+/**
+ * @brief Acknowledge the edges (to be called before reading the sensor)
+ */
+void hal_data_ready_clear(hal_data_ready_line_e line);
+
+/**
+ * @brief Get the number of edges since the initialisation of the line
+ *
+ * @retval 0 Line not initialised or not connected (yet)
+ */
+uint32_t hal_data_ready_get_edge_count(hal_data_ready_line_e line);
+
+#endif /* HAL_HAL_DATA_READY_H_ */
@@ -6,7 +6,11 @@
  */
 
 #include "hal_i2c.h"
+#include "hal_i2c_breaker.h"
+#include "hal_i2c_trace.h"
+#include "hal_timer.h"
 
+#include "cyhal.h"
 #include "cyhal_i2c.h"
 #include "cyhal_gpio.h"
 #include "cycfg_pins.h"
@@ -19,7 +23,195 @@
 static cyhal_i2c_t i2c_master;
 static uint8_t i2c_initialized = 0;
 
-static const uint32_t STD_TIMEOUT_MS = 100;
+static const uint32_t STD_TIMEOUT_MS = HAL_I2C_TIMEOUT_US / 1000;
+
+#define I2C_IRQ_PRIORITY	6
+
+/**
+ * Queue of the asynchronous transactions, the head is in progress on the bus
+ * Modified by the interrupt: accessed inside critical sections otherwise
+ */
+static hal_i2c_transaction_t* volatile queue_head = NULL;
+static hal_i2c_transaction_t* volatile queue_tail = NULL;
+static volatile uint32_t transfer_start_us = 0;
+
+/**
+ * Completed transactions whose callback has not been called yet
+ */
+static hal_i2c_transaction_t* volatile completed_head = NULL;
+static hal_i2c_transaction_t* volatile completed_tail = NULL;
+
+/**
+ * Set when the breaker of a device opened: the bus is cleared once the queue is empty
+ */
+static volatile uint8_t recovery_requested = 0;
+
+/**
+ * @brief Convert the status of a blocking transfer (HAL functions or manual mode of the SCB)
+ *
+ * @retval -1 Not acknowledged
+ * @retval -2 Timeout
+ * @retval HAL_I2C_BUS_ERROR Other error (arbitration lost, bus error)
+ */
+static int8_t get_transfer_result(cy_rslt_t status)
+{
+	switch (status)
+	{
+		case CY_SCB_I2C_SUCCESS:
+			return 0;
+
+		case CY_SCB_I2C_MASTER_MANUAL_ADDR_NAK:
+		case CY_SCB_I2C_MASTER_MANUAL_NAK:
+			return -1;
+
+		case CY_SCB_I2C_MASTER_MANUAL_TIMEOUT:
+			return -2;
+
+		default:
+			return HAL_I2C_BUS_ERROR;
+	}
+}
+
+/**
+ * @brief Move the head of the queue to the completed list and start the next transactions
+ * Called inside the interrupt or inside a critical section
+ */
+static void complete_head(int8_t result)
+{
+	while (queue_head != NULL)
+	{
+		hal_i2c_transaction_t* transaction = queue_head;
+		queue_head = transaction->next;
+		if (queue_head == NULL) queue_tail = NULL;
+
+		if (result != HAL_I2C_REJECTED)
+		{
+			HAL_I2C_TRACE_RECORD(transfer_start_us, transaction->address,
+					&(hal_i2c_segment_t){ .data = transaction->tx_data, .len = transaction->tx_len }, 1,
+					transaction->rx_data, transaction->rx_len, result);
+			if (hal_i2c_breaker_report(transaction->address, result) != 0) recovery_requested = 1;
+		}
+
+		transaction->next = NULL;
+		transaction->result = result;
+		if (completed_tail == NULL) completed_head = transaction;
+		else completed_tail->next = transaction;
+		completed_tail = transaction;
+
+		if (queue_head == NULL) return;
+
+		// Next transaction back-to-back
+		hal_i2c_transaction_t* next = queue_head;
+		if (hal_i2c_breaker_allow(next->address) == 0)
+		{
+			result = HAL_I2C_REJECTED;
+			continue;
+		}
+
+		transfer_start_us = hal_timer_get_uticks();
+		if (cyhal_i2c_master_transfer_async(&i2c_master, next->address, next->tx_data, next->tx_len,
+				next->rx_data, next->rx_len) == CY_RSLT_SUCCESS)
+		{
+			return;
+		}
+
+		// Could not be started: completed with an error as well
+		result = -1;
+	}
+}
+
+static void i2c_event_callback(void* callback_arg, cyhal_i2c_event_t event)
+{
+	(void) callback_arg;
+
+	// Events of the blocking functions are not ours
+	hal_i2c_transaction_t* transaction = queue_head;
+	if (transaction == NULL) return;
+
+	if ((event & CYHAL_I2C_MASTER_ERR_EVENT) != 0)
+	{
+		// Only the NACKs leave the bus idle
+		uint32_t status = Cy_SCB_I2C_MasterGetStatus(i2c_master.base, &i2c_master.context);
+		complete_head(((status & (CY_SCB_I2C_MASTER_ADDR_NAK | CY_SCB_I2C_MASTER_DATA_NAK)) != 0) ? -1 : HAL_I2C_BUS_ERROR);
+		return;
+	}
+
+	// A write followed by a read is done once the read is done
+	cyhal_i2c_event_t done_event = (transaction->rx_len > 0) ? CYHAL_I2C_MASTER_RD_CMPLT_EVENT : CYHAL_I2C_MASTER_WR_CMPLT_EVENT;
+	if ((event & done_event) != 0)
+	{
+		complete_head(0);
+	}
+}
+
+/**
+ * @brief Abort the transfer in progress if it lasts too long
+ */
+static void check_timeout()
+{
+	uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+	if ((queue_head != NULL) && ((hal_timer_get_uticks() - transfer_start_us) > HAL_I2C_TIMEOUT_US))
+	{
+		(void) cyhal_i2c_abort_async(&i2c_master);
+		complete_head(-2);
+	}
+
+	cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/**
+ * @brief Fail every queued transaction (bus being reinitialised)
+ */
+static void fail_all()
+{
+	uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+	if (queue_head != NULL)
+	{
+		(void) cyhal_i2c_abort_async(&i2c_master);
+
+		// Not restarted: the queue is emptied first
+		hal_i2c_transaction_t* pending = queue_head->next;
+		queue_head->next = NULL;
+		queue_tail = queue_head;
+		complete_head(-1);
+
+		while (pending != NULL)
+		{
+			hal_i2c_transaction_t* next = pending->next;
+			pending->next = NULL;
+			pending->result = -1;
+			if (completed_tail == NULL) completed_head = pending;
+			else completed_tail->next = pending;
+			completed_tail = pending;
+			pending = next;
+		}
+	}
+
+	cyhal_system_critical_section_exit(interrupt_state);
+}
+
+/**
+ * @brief Clear the bus if a breaker opened (only once the queue is empty: no transaction is aborted)
+ */
+static void recover_if_requested()
+{
+	if ((recovery_requested == 0) || (queue_head != NULL)) return;
+
+	recovery_requested = 0;
+	(void) hal_i2c_recover();
+}
+
+/**
+ * @brief Account the result of a blocking transfer
+ */
+static int8_t report_transfer(uint8_t address, int8_t result)
+{
+	if (hal_i2c_breaker_report(address, result) != 0) recovery_requested = 1;
+	recover_if_requested();
+	return result;
+}
 
 static void hal_i2c_bus_clear(void)
 {
@@ -61,7 +253,7 @@ int8_t hal_i2c_init()
 	cyhal_i2c_cfg_t i2c_config;
 	i2c_config.is_slave = false;
 	i2c_config.address = 0;
-	i2c_config.frequencyhal_hz = 400000UL;
+	i2c_config.frequencyhal_hz = HAL_I2C_FREQUENCY_HZ;
 
 	cy_rslt_t result = cyhal_i2c_init(&i2c_master, ARDU_SDA, ARDU_SCL, NULL);
 	if (result != CY_RSLT_SUCCESS) return result;
@@ -70,14 +262,24 @@ int8_t hal_i2c_init()
 	if (result == CY_RSLT_SUCCESS)
 	{
 		i2c_initialized = 1;
+
+		// Used for the timeout of the asynchronous transactions
+		hal_timer_init();
+
+		cyhal_i2c_register_callback(&i2c_master, i2c_event_callback, NULL);
+		cyhal_i2c_enable_event(&i2c_master, (cyhal_i2c_event_t)(CYHAL_I2C_MASTER_WR_CMPLT_EVENT
+				| CYHAL_I2C_MASTER_RD_CMPLT_EVENT | CYHAL_I2C_MASTER_ERR_EVENT), I2C_IRQ_PRIORITY, true);
 	}
 	return result;
 }
 
 int8_t hal_i2c_recover()
 {
+	hal_i2c_breaker_add_recovery();
+
 	if (i2c_initialized != 0)
 	{
+		fail_all();
 		cyhal_i2c_free(&i2c_master);
 		i2c_initialized = 0;
 	}
@@ -89,50 +291,208 @@ int8_t hal_i2c_recover()
 
 int8_t hal_i2c_read(uint8_t address, uint8_t* data, uint16_t len)
 {
+	hal_i2c_flush();
+	if (hal_i2c_breaker_allow(address) == 0) return HAL_I2C_REJECTED;
+
+	HAL_I2C_TRACE_BEGIN(trace_start);
 	cy_rslt_t result = cyhal_i2c_master_read(&i2c_master, (uint16_t)address, data, len, STD_TIMEOUT_MS, true);
-	if (result != CY_RSLT_SUCCESS) return -1;
-	return 0;
+	int8_t retval = get_transfer_result(result);
+	HAL_I2C_TRACE_RECORD(trace_start, address, NULL, 0, data, len, retval);
+
+	return report_transfer(address, retval);
 }
 
 int8_t hal_i2c_write(uint8_t address, uint8_t* data, uint16_t len)
 {
+	hal_i2c_flush();
+	if (hal_i2c_breaker_allow(address) == 0) return HAL_I2C_REJECTED;
+
+	HAL_I2C_TRACE_BEGIN(trace_start);
 	cy_rslt_t result = cyhal_i2c_master_write(&i2c_master, (uint16_t)address, data, len, STD_TIMEOUT_MS, true);
-	if (result != CY_RSLT_SUCCESS) return -1;
-	return 0;
+	int8_t retval = get_transfer_result(result);
+	HAL_I2C_TRACE_RECORD(trace_start, address, &(hal_i2c_segment_t){ .data = data, .len = len }, 1, NULL, 0, retval);
+
+	return report_transfer(address, retval);
 }
 
-int8_t hal_i2c_write_register(uint8_t address, uint8_t reg, uint8_t* data, uint16_t size)
+int8_t hal_i2c_write_vector(uint8_t address, const hal_i2c_segment_t* segments, uint8_t count)
 {
-	cy_rslt_t result;
-	uint8_t* i2c_data = NULL;
+	hal_i2c_flush();
+	if (hal_i2c_breaker_allow(address) == 0) return HAL_I2C_REJECTED;
 
-	// Allocate buffer for a register and the data
-    i2c_data = malloc(size+1);
-    if(i2c_data == NULL) return 1;
+	HAL_I2C_TRACE_BEGIN(trace_start);
 
-    // Copy register register and all the data
-    i2c_data[0] = reg;
-    memcpy(&i2c_data[1], data, size);
+	// Manual mode of the SCB: the bytes of every segment are written directly into the FIFO
+	cy_en_scb_i2c_status_t status = Cy_SCB_I2C_MasterSendStart(i2c_master.base, address, CY_SCB_I2C_WRITE_XFER,
+			STD_TIMEOUT_MS, &i2c_master.context);
 
-    // Execute write command
-    result = cyhal_i2c_master_write( &i2c_master, (uint16_t)address, i2c_data, size+1, STD_TIMEOUT_MS, true );
+	for (uint8_t i = 0; (i < count) && (status == CY_SCB_I2C_SUCCESS); ++i)
+	{
+		for (uint16_t j = 0; (j < segments[i].len) && (status == CY_SCB_I2C_SUCCESS); ++j)
+		{
+			status = Cy_SCB_I2C_MasterWriteByte(i2c_master.base, segments[i].data[j], STD_TIMEOUT_MS, &i2c_master.context);
+		}
+	}
 
-    // Free allocated buffer and exit
-    free(i2c_data);
+	// The bus is lost after an arbitration loss or a bus error: no stop to send
+	if ((status != CY_SCB_I2C_MASTER_MANUAL_ARB_LOST) && (status != CY_SCB_I2C_MASTER_MANUAL_BUS_ERR))
+	{
+		cy_en_scb_i2c_status_t stop_status = Cy_SCB_I2C_MasterSendStop(i2c_master.base, STD_TIMEOUT_MS, &i2c_master.context);
+		if (status == CY_SCB_I2C_SUCCESS) status = stop_status;
+	}
 
-    if (result != CY_RSLT_SUCCESS) return -1;
-    return 0;
+	int8_t retval = get_transfer_result(status);
+	HAL_I2C_TRACE_RECORD(trace_start, address, segments, count, NULL, 0, retval);
+
+	return report_transfer(address, retval);
+}
+
+/**
+ * @brief Remove a transaction from the list of the completed transactions (its callback is not called)
+ */
+static void remove_completed(hal_i2c_transaction_t* transaction)
+{
+	uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+	hal_i2c_transaction_t* previous = NULL;
+	for (hal_i2c_transaction_t* current = completed_head; current != NULL; current = current->next)
+	{
+		if (current == transaction)
+		{
+			if (previous == NULL) completed_head = current->next;
+			else previous->next = current->next;
+			if (completed_tail == current) completed_tail = previous;
+			current->next = NULL;
+			break;
+		}
+		previous = current;
+	}
+
+	cyhal_system_critical_section_exit(interrupt_state);
+}
+
+int8_t hal_i2c_write_read(uint8_t address, const uint8_t* tx_data, uint16_t tx_len, uint8_t* rx_data, uint16_t rx_len)
+{
+	// Executed as an asynchronous transaction: the SCB chains the write and the read by itself
+	hal_i2c_transaction_t transaction =
+	{
+		.address = address,
+		.tx_data = (uint8_t*) tx_data,
+		.tx_len = tx_len,
+		.rx_data = rx_data,
+		.rx_len = rx_len,
+		.callback = NULL,
+		.context = NULL,
+		.result = 0,
+		.next = NULL,
+	};
+
+	hal_i2c_flush();
+
+	if (hal_i2c_submit(&transaction) != 0) return -1;
+
+	while (transaction.result == HAL_I2C_PENDING)
+	{
+		check_timeout();
+	}
+
+	// Lives on the stack: must not be seen by hal_i2c_process
+	remove_completed(&transaction);
+
+	recover_if_requested();
+	return transaction.result;
+}
+
+int8_t hal_i2c_write_register(uint8_t address, uint8_t reg, uint8_t* data, uint16_t size)
+{
+	hal_i2c_segment_t segments[2] =
+	{
+		{ .data = &reg, .len = 1 },
+		{ .data = data, .len = size },
+	};
+
+	return hal_i2c_write_vector(address, segments, 2);
 }
 
 int8_t hal_i2c_read_register(uint8_t address, uint8_t reg, uint8_t* data, uint16_t size)
 {
-	cy_rslt_t result;
+	return hal_i2c_write_read(address, &reg, 1, data, size);
+}
+
+int8_t hal_i2c_submit(hal_i2c_transaction_t* transaction)
+{
+	if ((transaction == NULL) || (transaction->result == HAL_I2C_PENDING)) return -1;
+	if ((transaction->tx_len == 0) && (transaction->rx_len == 0)) return -1;
+
+	transaction->result = HAL_I2C_PENDING;
+	transaction->next = NULL;
+
+	uint32_t interrupt_state = cyhal_system_critical_section_enter();
+
+	if (queue_tail == NULL)
+	{
+		queue_head = transaction;
+		queue_tail = transaction;
+
+		transfer_start_us = hal_timer_get_uticks();
+		if (hal_i2c_breaker_allow(transaction->address) == 0)
+		{
+			complete_head(HAL_I2C_REJECTED);
+		}
+		else if (cyhal_i2c_master_transfer_async(&i2c_master, transaction->address, transaction->tx_data, transaction->tx_len,
+				transaction->rx_data, transaction->rx_len) != CY_RSLT_SUCCESS)
+		{
+			complete_head(-1);
+		}
+	}
+	else
+	{
+		queue_tail->next = transaction;
+		queue_tail = transaction;
+	}
+
+	cyhal_system_critical_section_exit(interrupt_state);
+	return 0;
+}
+
+void hal_i2c_process()
+{
+	check_timeout();
+	recover_if_requested();
+
+	for(;;)
+	{
+		uint32_t interrupt_state = cyhal_system_critical_section_enter();
+		hal_i2c_transaction_t* transaction = completed_head;
+		if (transaction != NULL)
+		{
+			completed_head = transaction->next;
+			if (completed_head == NULL) completed_tail = NULL;
+			transaction->next = NULL;
+		}
+		cyhal_system_critical_section_exit(interrupt_state);
+
+		if (transaction == NULL) return;
+
+		// The callback can submit the transaction again
+		if (transaction->callback != NULL) transaction->callback(transaction);
+	}
+}
 
-    result = cyhal_i2c_master_write( &i2c_master, (uint16_t)address, &reg, 1, STD_TIMEOUT_MS, false );
-    if (result != CY_RSLT_SUCCESS) return -1;
+uint8_t hal_i2c_is_busy()
+{
+	return (queue_head != NULL) ? 1 : 0;
+}
 
-    result = cyhal_i2c_master_read( &i2c_master, (uint16_t)address, data, size, STD_TIMEOUT_MS, true );
+uint8_t hal_i2c_has_completed()
+{
+	return (completed_head != NULL) ? 1 : 0;
+}
 
-    if (result != CY_RSLT_SUCCESS) return -2;
-    return 0;
+void hal_i2c_flush()
+{
+	while (queue_head != NULL)
+	{
+		check_timeout();
+	}
 }
@@ -10,16 +10,153 @@
 
 #include <stdint.h>
 
+/**
+ * @def HAL_I2C_FREQUENCY_HZ
+ * @brief Clock of the I2C bus
+ */
+#define HAL_I2C_FREQUENCY_HZ	400000UL
+
+/**
+ * @def HAL_I2C_TRANSFER_TIME_US
+ * @brief Estimation of the bus time of one transfer of len bytes
+ * 9 clocks per byte (ACK included) plus the address byte, rounded up, plus 5us for start/stop conditions
+ */
+#define HAL_I2C_TRANSFER_TIME_US(len)	(((((len) + 1UL) * 9UL * 1000000UL) + HAL_I2C_FREQUENCY_HZ - 1) / HAL_I2C_FREQUENCY_HZ + 5UL)
+
+/**
+ * @def HAL_I2C_TIMEOUT_US
+ * @brief Maximum duration of one transfer (blocking or asynchronous)
+ */
+#define HAL_I2C_TIMEOUT_US		100000UL
+
+/**
+ * @def HAL_I2C_PENDING
+ * @brief Result of a transaction that is queued or in progress
+ */
+#define HAL_I2C_PENDING			1
+
+/**
+ * @def HAL_I2C_REJECTED
+ * @brief Result of a transfer not sent because the breaker of the device is open (see hal_i2c_breaker.h)
+ */
+#define HAL_I2C_REJECTED		-3
+
+/**
+ * @def HAL_I2C_BUS_ERROR
+ * @brief Result of a transfer that failed because of the bus (arbitration lost, misplaced start or stop, SCB error)
+ */
+#define HAL_I2C_BUS_ERROR		-4
+
+/**
+ * Part of a vectored write, the data is sent without copy
+ */
+typedef struct
+{
+	const uint8_t* data;
+	uint16_t len;
+} hal_i2c_segment_t;
+
+typedef struct hal_i2c_transaction hal_i2c_transaction_t;
+
+/**
+ * @brief Called by hal_i2c_process once the transaction is completed (result is set)
+ */
+typedef void (*hal_i2c_callback_t)(hal_i2c_transaction_t* transaction);
+
+/**
+ * Asynchronous transaction: write tx_data, then read rx_data after a repeated start
+ * Either part can be empty (length 0). The structure and the buffers are owned by the caller
+ * and must stay valid until the callback (or until result is not HAL_I2C_PENDING anymore).
+ */
+struct hal_i2c_transaction
+{
+	uint8_t address;
+	uint8_t* tx_data;
+	uint16_t tx_len;
+	uint8_t* rx_data;
+	uint16_t rx_len;
+	hal_i2c_callback_t callback;		/**< Can be NULL */
+	void* context;						/**< Free for the caller */
+	volatile int8_t result;				/**< HAL_I2C_PENDING, 0 success, -1 not acknowledged (NACK), -2 timeout, HAL_I2C_REJECTED, HAL_I2C_BUS_ERROR */
+	hal_i2c_transaction_t* next;		/**< Used by the queue */
+};
+
 int8_t hal_i2c_init();
 
+/**
+ * @brief Clear the bus (9 clocks and a stop) and initialise the I2C block again
+ * Called automatically when the breaker of a device opens
+ */
 int8_t hal_i2c_recover();
 
 int8_t hal_i2c_read(uint8_t address, uint8_t* data, uint16_t len);
 
 int8_t hal_i2c_write(uint8_t address, uint8_t* data, uint16_t len);
 
+/**
+ * @brief Write the segments one after the other inside one transfer (one start, one stop)
+ *
+ * @retval 0 Success
+ * @retval -1 Address or data not acknowledged, bus error
+ * @retval -2 Timeout
+ * @retval HAL_I2C_REJECTED Device down, nothing sent
+ */
+int8_t hal_i2c_write_vector(uint8_t address, const hal_i2c_segment_t* segments, uint8_t count);
+
+/**
+ * @brief Write then read inside one transfer (repeated start between both)
+ *
+ * @retval 0 Success
+ * @retval -1 Transfer error
+ * @retval -2 Timeout
+ * @retval HAL_I2C_REJECTED Device down, nothing sent
+ */
+int8_t hal_i2c_write_read(uint8_t address, const uint8_t* tx_data, uint16_t tx_len, uint8_t* rx_data, uint16_t rx_len);
+
+/**
+ * @brief Write the register address followed by the data (vectored write, no buffer needed)
+ */
 int8_t hal_i2c_write_register(uint8_t address, uint8_t reg, uint8_t* data, uint16_t size);
 
+/**
+ * @brief Write the register address, then read the data after a repeated start
+ */
 int8_t hal_i2c_read_register(uint8_t address, uint8_t reg, uint8_t* data, uint16_t size);
 
+/**
+ * Asynchronous transactions
+ * Queued transactions are executed back-to-back by the interrupt of the I2C block, the CPU is free meanwhile.
+ * The blocking functions above wait until the queue is empty before using the bus.
+ * A transaction for a device whose breaker is open is completed with HAL_I2C_REJECTED without using the bus.
+ */
+
+/**
+ * @brief Add a transaction at the end of the queue (started immediately if the bus is free)
+ *
+ * @retval 0 Queued
+ * @retval -1 Transaction already queued, or nothing to transfer
+ */
+int8_t hal_i2c_submit(hal_i2c_transaction_t* transaction);
+
+/**
+ * @brief Call the callbacks of the completed transactions and abort a transfer lasting longer than HAL_I2C_TIMEOUT_US
+ * Called by the main loop (the callbacks are not called inside the interrupt)
+ */
+void hal_i2c_process();
+
+/**
+ * @brief Check if transactions are queued or in progress
+ */
+uint8_t hal_i2c_is_busy();
+
+/**
+ * @brief Check if callbacks have to be called by hal_i2c_process (checked before sleeping)
+ */
+uint8_t hal_i2c_has_completed();
+
+/**
+ * @brief Wait until the queue is empty (the callbacks are not called)
+ */
+void hal_i2c_flush();
+
 #endif /* HAL_HAL_I2C_H_ */
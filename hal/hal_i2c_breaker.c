@@ -0,0 +1,192 @@
+/*
+ * hal_i2c_breaker.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "hal_i2c_breaker.h"
+#include "hal_timer.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ADDRESSES		128
+#define NO_DEVICE		0xFF
+
+static hal_i2c_device_stats_t devices[HAL_I2C_BREAKER_MAX_DEVICES];
+static uint8_t device_count = 0;
+
+/**
+ * Index inside devices of every address (NO_DEVICE if not tracked)
+ */
+static uint8_t device_index[ADDRESSES];
+static uint8_t index_initialized = 0;
+
+static uint32_t recoveries = 0;
+
+/**
+ * @brief Get the counters of the address, create them on the first use
+ *
+ * @retval NULL Not tracked (too many addresses)
+ */
+static hal_i2c_device_stats_t* get_device(uint8_t address)
+{
+	address &= (ADDRESSES - 1);
+
+	if (index_initialized == 0)
+	{
+		memset(device_index, NO_DEVICE, sizeof(device_index));
+		index_initialized = 1;
+	}
+
+	uint8_t index = device_index[address];
+	if (index != NO_DEVICE) return &devices[index];
+
+	if (device_count >= HAL_I2C_BREAKER_MAX_DEVICES) return NULL;
+
+	hal_i2c_device_stats_t* device = &devices[device_count];
+	memset(device, 0, sizeof(*device));
+	device->address = address;
+	device->open_us = HAL_I2C_BREAKER_OPEN_US;
+	device_index[address] = device_count;
+	device_count++;
+	return device;
+}
+
+static void open_breaker(hal_i2c_device_stats_t* device)
+{
+	device->state = HAL_I2C_BREAKER_OPEN;
+	device->retry_us = hal_timer_get_uticks() + device->open_us;
+	device->trips++;
+}
+
+/**
+ * @brief Check if the failure that opened the breaker requires a bus clear
+ * A NACK (absent device) leaves the bus idle: clearing it would only disturb the other devices
+ */
+static uint8_t get_recovery(int8_t result)
+{
+	return (result != -1) ? 1 : 0;
+}
+
+uint8_t hal_i2c_breaker_allow(uint8_t address)
+{
+	hal_i2c_device_stats_t* device = get_device(address);
+	if (device == NULL) return 1;
+
+	switch (device->state)
+	{
+		case HAL_I2C_BREAKER_OPEN:
+			if ((int32_t)(hal_timer_get_uticks() - device->retry_us) >= 0)
+			{
+				// Probe
+				device->state = HAL_I2C_BREAKER_HALF_OPEN;
+				return 1;
+			}
+			break;
+
+		case HAL_I2C_BREAKER_HALF_OPEN:
+			// Probe still in progress
+			break;
+
+		default:
+			return 1;
+	}
+
+	device->rejected++;
+	return 0;
+}
+
+uint8_t hal_i2c_breaker_report(uint8_t address, int8_t result)
+{
+	hal_i2c_device_stats_t* device = get_device(address);
+	if (device == NULL) return 0;
+
+	device->transfers++;
+
+	if (result == 0)
+	{
+		device->consecutive_failures = 0;
+		device->state = HAL_I2C_BREAKER_CLOSED;
+		device->open_us = HAL_I2C_BREAKER_OPEN_US;
+		return 0;
+	}
+
+	device->failures++;
+	if (result == -2) device->timeouts++;
+	if (device->consecutive_failures < 0xFF) device->consecutive_failures++;
+
+	if (device->state == HAL_I2C_BREAKER_HALF_OPEN)
+	{
+		// Still down: wait longer before the next probe
+		device->open_us *= 2;
+		if (device->open_us > HAL_I2C_BREAKER_OPEN_MAX_US) device->open_us = HAL_I2C_BREAKER_OPEN_MAX_US;
+		open_breaker(device);
+		return get_recovery(result);
+	}
+
+	if ((device->state == HAL_I2C_BREAKER_CLOSED) && (device->consecutive_failures >= HAL_I2C_BREAKER_THRESHOLD))
+	{
+		open_breaker(device);
+		return get_recovery(result);
+	}
+
+	return 0;
+}
+
+void hal_i2c_breaker_add_recovery()
+{
+	recoveries++;
+}
+
+uint32_t hal_i2c_breaker_get_recoveries()
+{
+	return recoveries;
+}
+
+const hal_i2c_device_stats_t* hal_i2c_breaker_get_device(uint8_t address)
+{
+	if ((index_initialized == 0) || (address >= ADDRESSES) || (device_index[address] == NO_DEVICE)) return NULL;
+	return &devices[device_index[address]];
+}
+
+uint8_t hal_i2c_breaker_get_open_count()
+{
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < device_count; ++i)
+	{
+		if (devices[i].state != HAL_I2C_BREAKER_CLOSED) count++;
+	}
+	return count;
+}
+
+void hal_i2c_breaker_reset()
+{
+	// The addresses stay tracked
+	for (uint8_t i = 0; i < device_count; ++i)
+	{
+		uint8_t address = devices[i].address;
+		memset(&devices[i], 0, sizeof(devices[i]));
+		devices[i].address = address;
+		devices[i].open_us = HAL_I2C_BREAKER_OPEN_US;
+	}
+	recoveries = 0;
+}
+
+void hal_i2c_breaker_print()
+{
+	static const char* const state_names[] = { "closed", "open", "half-open" };
+
+	printf("I2C breakers: %u devices, %lu bus recoveries \r\n", device_count, (unsigned long) recoveries);
+
+	for (uint8_t i = 0; i < device_count; ++i)
+	{
+		const hal_i2c_device_stats_t* device = &devices[i];
+		printf("I2C 0x%02X %-9s transfers %lu, failures %lu (timeouts %lu, in a row %u), rejected %lu, trips %lu \r\n",
+				device->address, state_names[device->state], (unsigned long) device->transfers,
+				(unsigned long) device->failures, (unsigned long) device->timeouts, device->consecutive_failures,
+				(unsigned long) device->rejected, (unsigned long) device->trips);
+	}
+}
@@ -0,0 +1,125 @@
+/*
+ * hal_i2c_breaker.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HAL_HAL_I2C_BREAKER_H_
+#define HAL_HAL_I2C_BREAKER_H_
+
+#include <stdint.h>
+
+/**
+ * Circuit breaker of every I2C device (address), used by hal_i2c
+ *
+ * After HAL_I2C_BREAKER_THRESHOLD failed transfers in a row, the breaker of the address opens: its transfers fail
+ * immediately (HAL_I2C_REJECTED) instead of waiting for a NACK or a timeout. If the last failure was a timeout or a bus error,
+ * the bus is cleared as well (hal_i2c_recover): a device that only does not acknowledge (absent) cannot hold the bus.
+ * Once the open time elapsed, the breaker is half-open: one transfer is let through. If it succeeds the breaker closes,
+ * otherwise it opens again for twice the time (up to HAL_I2C_BREAKER_OPEN_MAX_US).
+ * Times are measured with hal_timer_get_uticks.
+ */
+
+/**
+ * @def HAL_I2C_BREAKER_THRESHOLD
+ * @brief Failed transfers in a row opening the breaker
+ */
+#ifndef HAL_I2C_BREAKER_THRESHOLD
+#define HAL_I2C_BREAKER_THRESHOLD		3
+#endif
+
+/**
+ * @def HAL_I2C_BREAKER_OPEN_US
+ * @brief Time during which the transfers are rejected after the first opening
+ */
+#ifndef HAL_I2C_BREAKER_OPEN_US
+#define HAL_I2C_BREAKER_OPEN_US			500000UL
+#endif
+
+/**
+ * @def HAL_I2C_BREAKER_OPEN_MAX_US
+ * @brief Longest open time (doubled at every failed half-open transfer)
+ */
+#ifndef HAL_I2C_BREAKER_OPEN_MAX_US
+#define HAL_I2C_BREAKER_OPEN_MAX_US		8000000UL
+#endif
+
+/**
+ * @def HAL_I2C_BREAKER_MAX_DEVICES
+ * @brief Number of addresses that can be tracked, the next ones have no breaker
+ */
+#ifndef HAL_I2C_BREAKER_MAX_DEVICES
+#define HAL_I2C_BREAKER_MAX_DEVICES		24
+#endif
+
+typedef enum
+{
+	HAL_I2C_BREAKER_CLOSED = 0,			/**< Transfers executed */
+	HAL_I2C_BREAKER_OPEN,				/**< Transfers rejected until retry_us */
+	HAL_I2C_BREAKER_HALF_OPEN			/**< One transfer in progress decides if the breaker closes */
+} hal_i2c_breaker_state_e;
+
+/**
+ * Counters of one address
+ */
+typedef struct
+{
+	uint8_t address;
+	uint8_t state;						/**< hal_i2c_breaker_state_e */
+	uint8_t consecutive_failures;
+	uint32_t transfers;					/**< Transfers executed on the bus */
+	uint32_t failures;					/**< Transfers failed (NACK, bus error or timeout) */
+	uint32_t timeouts;
+	uint32_t rejected;					/**< Transfers rejected while the breaker was open */
+	uint32_t trips;						/**< Number of times the breaker opened */
+	uint32_t open_us;					/**< Duration of the current or next opening */
+	uint32_t retry_us;					/**< End of the opening (hal_timer_get_uticks) */
+} hal_i2c_device_stats_t;
+
+/**
+ * @brief Check if a transfer can be sent to the address (and count it as rejected otherwise)
+ * Called by the I2C interrupt or while no asynchronous transaction is queued (one caller at a time)
+ *
+ * @retval 1 Transfer allowed
+ * @retval 0 Breaker open, the transfer must fail with HAL_I2C_REJECTED
+ */
+uint8_t hal_i2c_breaker_allow(uint8_t address);
+
+/**
+ * @brief Account the result of an allowed transfer
+ *
+ * @param [in] result 0 success, -1 not acknowledged, -2 timeout, other failure (bus error)
+ *
+ * @retval 1 The breaker just opened after a timeout or a bus error: the bus has to be cleared
+ */
+uint8_t hal_i2c_breaker_report(uint8_t address, int8_t result);
+
+/**
+ * @brief Count a bus recovery (hal_i2c_recover)
+ */
+void hal_i2c_breaker_add_recovery();
+
+uint32_t hal_i2c_breaker_get_recoveries();
+
+/**
+ * @retval NULL Nothing has been sent to the address yet
+ */
+const hal_i2c_device_stats_t* hal_i2c_breaker_get_device(uint8_t address);
+
+/**
+ * @brief Get the number of breakers that are not closed
+ */
+uint8_t hal_i2c_breaker_get_open_count();
+
+/**
+ * @brief Close every breaker and reset the counters
+ */
+void hal_i2c_breaker_reset();
+
+/**
+ * @brief Print the counters of every address over the debug UART
+ */
+void hal_i2c_breaker_print();
+
+#endif /* HAL_HAL_I2C_BREAKER_H_ */
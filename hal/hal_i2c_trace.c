@@ -0,0 +1,261 @@
+/*
+ * hal_i2c_trace.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "hal_i2c_trace.h"
+
+#include <stddef.h>
+
+static uint16_t read_u16(const uint8_t* data)
+{
+	return (uint16_t)(data[0] | (data[1] << 8));
+}
+
+int hal_i2c_trace_decode(const uint8_t* data, uint16_t len, hal_i2c_trace_record_t* record)
+{
+	if (len < 9) return -1;
+
+	record->time_us = ((uint32_t) data[0]) | (((uint32_t) data[1]) << 8)
+			| (((uint32_t) data[2]) << 16) | (((uint32_t) data[3]) << 24);
+	record->duration_us = read_u16(&data[4]);
+	record->address = data[6];
+	record->flags = data[7];
+	record->result = (int8_t) data[8];
+	record->tx_len = 0;
+	record->rx_len = 0;
+	record->tx_data = NULL;
+	record->rx_data = NULL;
+
+	uint16_t index = 9;
+	if ((record->flags & HAL_I2C_TRACE_FLAG_WRITE) != 0)
+	{
+		if ((index + 2) > len) return -1;
+		record->tx_len = read_u16(&data[index]);
+		index += 2;
+
+		uint16_t stored = (record->tx_len < HAL_I2C_TRACE_MAX_PAYLOAD) ? record->tx_len : HAL_I2C_TRACE_MAX_PAYLOAD;
+		if ((index + stored) > len) return -1;
+		record->tx_data = &data[index];
+		index += stored;
+	}
+
+	if ((record->flags & HAL_I2C_TRACE_FLAG_READ) != 0)
+	{
+		if ((index + 2) > len) return -1;
+		record->rx_len = read_u16(&data[index]);
+		index += 2;
+
+		uint16_t stored = (record->rx_len < HAL_I2C_TRACE_MAX_PAYLOAD) ? record->rx_len : HAL_I2C_TRACE_MAX_PAYLOAD;
+		if ((index + stored) > len) return -1;
+		record->rx_data = &data[index];
+		index += stored;
+	}
+
+	return index;
+}
+
+#ifdef I2C_TRACE_SUPPORT
+
+#include "hal_timer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_MASK	(HAL_I2C_TRACE_SIZE - 1)
+
+/**
+ * Ring of the encoded records, the indexes are free running (masked when used)
+ * Written by the I2C interrupt: the main loop only reads it while the recording is paused
+ */
+static uint8_t trace[HAL_I2C_TRACE_SIZE];
+static volatile uint32_t trace_head = 0;
+static volatile uint32_t trace_tail = 0;
+static volatile uint8_t trace_enabled = 1;
+static uint32_t records = 0;
+static uint32_t dropped = 0;
+
+static void put_u8(uint8_t value)
+{
+	trace[trace_head & TRACE_MASK] = value;
+	trace_head++;
+}
+
+static void put_u16(uint16_t value)
+{
+	put_u8((uint8_t)(value & 0xFF));
+	put_u8((uint8_t)(value >> 8));
+}
+
+static uint8_t get_u8(uint32_t index)
+{
+	return trace[index & TRACE_MASK];
+}
+
+static uint16_t get_stored_len(uint16_t len)
+{
+	return (len < HAL_I2C_TRACE_MAX_PAYLOAD) ? len : HAL_I2C_TRACE_MAX_PAYLOAD;
+}
+
+/**
+ * @brief Get the size of the record stored at index
+ */
+static uint16_t get_record_size(uint32_t index)
+{
+	uint8_t flags = get_u8(index + 7);
+	uint16_t size = 9;
+
+	if ((flags & HAL_I2C_TRACE_FLAG_WRITE) != 0)
+	{
+		uint16_t len = (uint16_t)(get_u8(index + size) | (get_u8(index + size + 1) << 8));
+		size += 2 + get_stored_len(len);
+	}
+
+	if ((flags & HAL_I2C_TRACE_FLAG_READ) != 0)
+	{
+		uint16_t len = (uint16_t)(get_u8(index + size) | (get_u8(index + size + 1) << 8));
+		size += 2 + get_stored_len(len);
+	}
+
+	return size;
+}
+
+uint32_t hal_i2c_trace_begin()
+{
+	return hal_timer_get_uticks();
+}
+
+void hal_i2c_trace_record(uint32_t start_us, uint8_t address, const hal_i2c_segment_t* tx, uint8_t tx_count,
+		const uint8_t* rx, uint16_t rx_len, int8_t result)
+{
+	if (trace_enabled == 0) return;
+
+	uint32_t duration_us = hal_timer_get_uticks() - start_us;
+
+	uint16_t tx_len = 0;
+	for (uint8_t i = 0; i < tx_count; ++i)
+	{
+		tx_len += tx[i].len;
+	}
+
+	uint8_t flags = 0;
+	uint16_t size = 9;
+	if (tx_len > 0)
+	{
+		flags |= HAL_I2C_TRACE_FLAG_WRITE;
+		size += 2 + get_stored_len(tx_len);
+	}
+	if (rx_len > 0)
+	{
+		flags |= HAL_I2C_TRACE_FLAG_READ;
+		size += 2 + get_stored_len(rx_len);
+	}
+	if ((tx_len > HAL_I2C_TRACE_MAX_PAYLOAD) || (rx_len > HAL_I2C_TRACE_MAX_PAYLOAD)) flags |= HAL_I2C_TRACE_FLAG_TRUNCATED;
+
+	// Make room by dropping the oldest records
+	while ((HAL_I2C_TRACE_SIZE - (trace_head - trace_tail)) < size)
+	{
+		trace_tail += get_record_size(trace_tail);
+		records--;
+		dropped++;
+	}
+
+	put_u16((uint16_t)(start_us & 0xFFFF));
+	put_u16((uint16_t)(start_us >> 16));
+	put_u16((duration_us > 0xFFFF) ? 0xFFFF : (uint16_t) duration_us);
+	put_u8(address);
+	put_u8(flags);
+	put_u8((uint8_t) result);
+
+	if (tx_len > 0)
+	{
+		put_u16(tx_len);
+		uint16_t stored = 0;
+		for (uint8_t i = 0; (i < tx_count) && (stored < HAL_I2C_TRACE_MAX_PAYLOAD); ++i)
+		{
+			for (uint16_t j = 0; (j < tx[i].len) && (stored < HAL_I2C_TRACE_MAX_PAYLOAD); ++j)
+			{
+				put_u8(tx[i].data[j]);
+				stored++;
+			}
+		}
+	}
+
+	if (rx_len > 0)
+	{
+		put_u16(rx_len);
+		// Data of a failed read is not meaningful but keeps the size of the record known
+		uint16_t stored = get_stored_len(rx_len);
+		for (uint16_t i = 0; i < stored; ++i)
+		{
+			put_u8((result == 0) ? rx[i] : 0);
+		}
+	}
+
+	records++;
+}
+
+void hal_i2c_trace_enable(uint8_t enable)
+{
+	trace_enabled = enable;
+}
+
+void hal_i2c_trace_clear()
+{
+	uint8_t enabled = trace_enabled;
+	trace_enabled = 0;
+
+	trace_head = 0;
+	trace_tail = 0;
+	records = 0;
+	dropped = 0;
+
+	trace_enabled = enabled;
+}
+
+uint32_t hal_i2c_trace_get_records()
+{
+	return records;
+}
+
+uint32_t hal_i2c_trace_get_dropped()
+{
+	return dropped;
+}
+
+void hal_i2c_trace_dump(hal_i2c_trace_output_t output)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	static char line[sizeof(HAL_I2C_TRACE_LINE_PREFIX) + 2 * HAL_I2C_TRACE_MAX_RECORD_SIZE];
+
+	uint8_t enabled = trace_enabled;
+	trace_enabled = 0;
+
+	snprintf(line, sizeof(line), HAL_I2C_TRACE_LINE_PREFIX "BEGIN %lu %lu",
+			(unsigned long) records, (unsigned long) dropped);
+	output(line);
+
+	for (uint32_t index = trace_tail; index != trace_head;)
+	{
+		uint16_t size = get_record_size(index);
+		uint16_t len = sizeof(HAL_I2C_TRACE_LINE_PREFIX) - 1;
+		memcpy(line, HAL_I2C_TRACE_LINE_PREFIX, len);
+		for (uint16_t i = 0; i < size; ++i)
+		{
+			uint8_t value = get_u8(index + i);
+			line[len++] = hex[value >> 4];
+			line[len++] = hex[value & 0x0F];
+		}
+		line[len] = '\0';
+		output(line);
+		index += size;
+	}
+
+	output(HAL_I2C_TRACE_LINE_PREFIX "END");
+
+	trace_enabled = enabled;
+}
+
+#endif
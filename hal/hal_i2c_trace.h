@@ -0,0 +1,142 @@
+/*
+ * hal_i2c_trace.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HAL_HAL_I2C_TRACE_H_
+#define HAL_HAL_I2C_TRACE_H_
+
+#include <stdint.h>
+
+#include "hal_i2c.h"
+
+/**
+ * Recorder of the I2C transactions
+ *
+ * Only compiled if I2C_TRACE_SUPPORT is defined (see DEFINES inside the Makefile).
+ * Otherwise the HAL_I2C_TRACE_xxx macros are empty and the functions are not available.
+ *
+ * Every transfer of hal_i2c (blocking or asynchronous) is stored inside a ring, the oldest records are dropped
+ * when it is full. The ring is dumped over the debug UART as text lines ("I2CT " followed by one record in hex)
+ * that can be extracted from a terminal log and replayed by the host build (host/i2c_replay.h).
+ *
+ * Encoding of one record (little endian):
+ * - uint32 start time (us, hal_timer_get_uticks)
+ * - uint16 duration (us, saturated)
+ * - uint8 address
+ * - uint8 flags (HAL_I2C_TRACE_FLAG_xxx)
+ * - int8 result (0 success, -1 transfer error, -2 timeout)
+ * - if HAL_I2C_TRACE_FLAG_WRITE: uint16 length on the bus, then the written bytes (HAL_I2C_TRACE_MAX_PAYLOAD at most)
+ * - if HAL_I2C_TRACE_FLAG_READ: uint16 length on the bus, then the read bytes (HAL_I2C_TRACE_MAX_PAYLOAD at most)
+ */
+
+/**
+ * @def HAL_I2C_TRACE_SIZE
+ * @brief Size of the ring storing the records (must be a power of two)
+ */
+#ifndef HAL_I2C_TRACE_SIZE
+#define HAL_I2C_TRACE_SIZE			4096
+#endif
+
+/**
+ * @def HAL_I2C_TRACE_MAX_PAYLOAD
+ * @brief Bytes stored per direction, the rest of a longer transfer is not stored (HAL_I2C_TRACE_FLAG_TRUNCATED)
+ */
+#ifndef HAL_I2C_TRACE_MAX_PAYLOAD
+#define HAL_I2C_TRACE_MAX_PAYLOAD	32
+#endif
+
+#define HAL_I2C_TRACE_FLAG_WRITE		0x01
+#define HAL_I2C_TRACE_FLAG_READ			0x02
+#define HAL_I2C_TRACE_FLAG_TRUNCATED	0x04
+
+/**
+ * @def HAL_I2C_TRACE_MAX_RECORD_SIZE
+ * @brief Size of the largest encoded record
+ */
+#define HAL_I2C_TRACE_MAX_RECORD_SIZE	(9 + 2 * (2 + HAL_I2C_TRACE_MAX_PAYLOAD))
+
+/**
+ * @def HAL_I2C_TRACE_LINE_PREFIX
+ * @brief Start of the lines printed by hal_i2c_trace_dump
+ */
+#define HAL_I2C_TRACE_LINE_PREFIX		"I2CT "
+
+/**
+ * Decoded record, the data points inside the decoded buffer
+ */
+typedef struct
+{
+	uint32_t time_us;
+	uint16_t duration_us;
+	uint8_t address;
+	uint8_t flags;
+	int8_t result;
+	uint16_t tx_len;			/**< Bytes written on the bus */
+	uint16_t rx_len;			/**< Bytes read on the bus */
+	const uint8_t* tx_data;		/**< Stored written bytes (tx_len, HAL_I2C_TRACE_MAX_PAYLOAD at most) */
+	const uint8_t* rx_data;		/**< Stored read bytes (rx_len, HAL_I2C_TRACE_MAX_PAYLOAD at most) */
+} hal_i2c_trace_record_t;
+
+/**
+ * @brief Called by hal_i2c_trace_dump for every line (without end of line)
+ */
+typedef void (*hal_i2c_trace_output_t)(const char* line);
+
+/**
+ * @brief Decode one record
+ *
+ * @retval > 0 Size of the record
+ * @retval -1 Truncated or invalid record
+ */
+int hal_i2c_trace_decode(const uint8_t* data, uint16_t len, hal_i2c_trace_record_t* record);
+
+#ifdef I2C_TRACE_SUPPORT
+
+uint32_t hal_i2c_trace_begin();
+
+/**
+ * @brief Store a transfer started at start_us (hal_i2c_trace_begin) and ending now
+ * Called by the I2C interrupt or while no asynchronous transaction is queued (one writer at a time)
+ *
+ * @param [in] tx Segments written (count 0 if nothing is written)
+ */
+void hal_i2c_trace_record(uint32_t start_us, uint8_t address, const hal_i2c_segment_t* tx, uint8_t tx_count,
+		const uint8_t* rx, uint16_t rx_len, int8_t result);
+
+/**
+ * @brief Start or stop the recording (started by default)
+ */
+void hal_i2c_trace_enable(uint8_t enable);
+
+/**
+ * @brief Remove all the records
+ */
+void hal_i2c_trace_clear();
+
+uint32_t hal_i2c_trace_get_records();
+
+/**
+ * @brief Get how many records have been dropped because the ring was full
+ */
+uint32_t hal_i2c_trace_get_dropped();
+
+/**
+ * @brief Output all the records, oldest first, between a BEGIN and an END line
+ * The recording is paused meanwhile, the records are kept.
+ */
+void hal_i2c_trace_dump(hal_i2c_trace_output_t output);
+
+#define HAL_I2C_TRACE_BEGIN(var)		uint32_t var = hal_i2c_trace_begin()
+#define HAL_I2C_TRACE_RECORD(...)		hal_i2c_trace_record(__VA_ARGS__)
+
+#else
+
+#define HAL_I2C_TRACE_BEGIN(var)
+#define HAL_I2C_TRACE_RECORD(...)
+
+#endif
+
+#endif /* HAL_HAL_I2C_TRACE_H_ */
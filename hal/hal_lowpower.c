@@ -0,0 +1,141 @@
+/*
+ * hal_lowpower.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "hal_lowpower.h"
+#include "hal_timer.h"
+#include "cyhal.h"
+
+#include <string.h>
+
+/**
+ * @def MAX_DELAY_COUNTS
+ * @brief Longest delay programmed at once (the loop wakes up and sleeps again for longer deadlines)
+ */
+#define MAX_DELAY_COUNTS	0xFFFFUL
+
+static cyhal_lptimer_t lptimer;
+static uint32_t frequency_hz = 32768;
+static uint32_t min_delay_counts = 4;
+
+static hal_lowpower_stats_t stats;
+static uint64_t sleep_counts = 0;
+static uint64_t latency_sum_counts = 0;
+
+static uint32_t counts_to_us(uint32_t counts)
+{
+	return (uint32_t)(((uint64_t) counts * 1000000u) / frequency_hz);
+}
+
+static void lptimer_isr(void *callback_arg, cyhal_lptimer_event_t event)
+{
+	(void) callback_arg;
+	(void) event;
+
+	// Only used to wake the CPU up, the main loop checks its deadlines
+}
+
+int hal_lowpower_init()
+{
+	if (cyhal_lptimer_init(&lptimer) != CY_RSLT_SUCCESS) return -1;
+
+	cyhal_lptimer_info_t info;
+	cyhal_lptimer_get_info(&lptimer, &info);
+	if (info.frequency_hz != 0) frequency_hz = info.frequency_hz;
+	if (info.min_set_delay > min_delay_counts) min_delay_counts = info.min_set_delay;
+
+	cyhal_lptimer_register_callback(&lptimer, lptimer_isr, NULL);
+	cyhal_lptimer_enable_event(&lptimer, CYHAL_LPTIMER_COMPARE_MATCH, 7, true);
+
+	hal_lowpower_reset_stats();
+	return 0;
+}
+
+uint32_t hal_lowpower_get_frequency()
+{
+	return frequency_hz;
+}
+
+uint32_t hal_lowpower_get_counts()
+{
+	return cyhal_lptimer_read(&lptimer);
+}
+
+uint8_t hal_lowpower_is_reached(uint32_t deadline)
+{
+	return ((int32_t)(hal_lowpower_get_counts() - deadline) >= 0) ? 1 : 0;
+}
+
+void hal_lowpower_idle_until(uint32_t deadline, uint8_t allow_deep_sleep)
+{
+	uint32_t start = hal_lowpower_get_counts();
+	if ((int32_t)(start - deadline) >= 0) return;
+
+	uint32_t delay = deadline - start;
+	if (delay < min_delay_counts) return;
+	if (delay > MAX_DELAY_COUNTS) delay = MAX_DELAY_COUNTS;
+
+	if (cyhal_lptimer_set_delay(&lptimer, delay) != CY_RSLT_SUCCESS) return;
+
+	uint32_t start_uticks = hal_timer_get_uticks();
+	uint8_t deep_sleep_done = 0;
+	if ((allow_deep_sleep != 0) && (counts_to_us(delay) >= HAL_LOWPOWER_DEEP_SLEEP_MIN_US))
+	{
+		// Refused if a peripheral is busy (a registered low power callback returned an error)
+		if (cyhal_syspm_deepsleep() == CY_RSLT_SUCCESS)
+		{
+			deep_sleep_done = 1;
+			stats.deep_sleeps++;
+		}
+	}
+
+	if (deep_sleep_done == 0)
+	{
+		cyhal_syspm_sleep();
+		stats.sleeps++;
+	}
+
+	uint32_t slept_counts = hal_lowpower_get_counts() - start;
+	sleep_counts += slept_counts;
+	stats.sleep_time_ms = (uint32_t)((sleep_counts * 1000u) / frequency_hz);
+
+	if (deep_sleep_done != 0)
+	{
+		// The microsecond timer was stopped: give the part it did not count back to the monotonic time
+		uint32_t slept_us = counts_to_us(slept_counts);
+		uint32_t counted_us = hal_timer_get_uticks() - start_uticks;
+		if (slept_us > counted_us) hal_timer_add_stopped_time(slept_us - counted_us);
+	}
+}
+
+void hal_lowpower_record_wakeup(uint32_t deadline)
+{
+	uint32_t late_counts = hal_lowpower_get_counts() - deadline;
+	if ((int32_t) late_counts < 0) return;
+
+	uint32_t latency_us = counts_to_us(late_counts);
+
+	stats.wakeups++;
+	latency_sum_counts += late_counts;
+	if (latency_us > stats.latency_max_us) stats.latency_max_us = latency_us;
+	if (latency_us > HAL_LOWPOWER_LATE_US) stats.late_wakeups++;
+}
+
+const hal_lowpower_stats_t* hal_lowpower_get_stats()
+{
+	if (stats.wakeups != 0)
+	{
+		stats.latency_avg_us = (uint32_t)((latency_sum_counts * 1000000u) / ((uint64_t) stats.wakeups * frequency_hz));
+	}
+	return &stats;
+}
+
+void hal_lowpower_reset_stats()
+{
+	memset(&stats, 0, sizeof(stats));
+	sleep_counts = 0;
+	latency_sum_counts = 0;
+}
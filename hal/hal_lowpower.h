@@ -0,0 +1,88 @@
+/*
+ * hal_lowpower.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HAL_HAL_LOWPOWER_H_
+#define HAL_HAL_LOWPOWER_H_
+
+#include <stdint.h>
+
+/**
+ * Time base of the main loop and idle handling
+ *
+ * Deadlines are expressed in counts of the low power timer (32768 Hz), which keeps counting during deep sleep.
+ * The main loop sleeps until its next deadline, the CPU is woken up by the timer or by any other interrupt (BLE, UART...).
+ */
+
+/**
+ * @def HAL_LOWPOWER_DEEP_SLEEP_MIN_US
+ * @brief Shortest idle time for which deep sleep is used (CPU sleep below, transition costs more than it saves)
+ */
+#define HAL_LOWPOWER_DEEP_SLEEP_MIN_US	2000
+
+/**
+ * @def HAL_LOWPOWER_LATE_US
+ * @brief A deadline reached later than this is counted as late wake-up
+ */
+#define HAL_LOWPOWER_LATE_US			1000
+
+typedef struct
+{
+	uint32_t sleeps;					/**< Number of CPU sleeps */
+	uint32_t deep_sleeps;				/**< Number of deep sleeps */
+	uint32_t sleep_time_ms;				/**< Time spent inside sleep or deep sleep */
+	uint32_t wakeups;					/**< Number of deadlines reached (see hal_lowpower_record_wakeup) */
+	uint32_t late_wakeups;				/**< Number of deadlines reached more than HAL_LOWPOWER_LATE_US late */
+	uint32_t latency_max_us;			/**< Highest delay between a deadline and its processing */
+	uint32_t latency_avg_us;			/**< Average delay between a deadline and its processing */
+} hal_lowpower_stats_t;
+
+/**
+ * @brief Initialise the low power timer used as time base
+ *
+ * @retval 0 Success
+ * @retval -1 Timer could not be initialised
+ */
+int hal_lowpower_init();
+
+/**
+ * @brief Get the frequency of the time base
+ */
+uint32_t hal_lowpower_get_frequency();
+
+/**
+ * @brief Get the current time in counts of the time base (wraps around)
+ */
+uint32_t hal_lowpower_get_counts();
+
+/**
+ * @brief Check if a deadline has been reached
+ *
+ * @retval 1 Deadline reached or passed
+ * @retval 0 Deadline in the future
+ */
+uint8_t hal_lowpower_is_reached(uint32_t deadline);
+
+/**
+ * @brief Sleep until the deadline or until any interrupt
+ * Has to be called inside a critical section (cyhal_system_critical_section_enter): an interrupt pending
+ * since the check of the work to do wakes the CPU up immediately instead of being missed.
+ *
+ * @param [in] deadline Time (in counts) at which the CPU has to be awake
+ * @param [in] allow_deep_sleep 1 if deep sleep can be used (peripherals clocked by the high frequency clocks are stopped)
+ */
+void hal_lowpower_idle_until(uint32_t deadline, uint8_t allow_deep_sleep);
+
+/**
+ * @brief Record the delay between a deadline and the moment it is processed (wake-up latency)
+ */
+void hal_lowpower_record_wakeup(uint32_t deadline);
+
+const hal_lowpower_stats_t* hal_lowpower_get_stats();
+
+void hal_lowpower_reset_stats();
+
+#endif /* HAL_HAL_LOWPOWER_H_ */
@@ -7,11 +7,51 @@
 
 #include "hal_timer.h"
 #include "cyhal_timer.h"
+#include "cyhal_system.h"
+
+#define TIMER_IRQ_PRIORITY	7
 
 static cyhal_timer_t Systick_obj;
+static uint8_t timer_initialized = 0;
+
+/**
+ * Upper 32 bits of the monotonic time, incremented when the counter is seen wrapping around
+ * The terminal count interrupt makes sure that it is seen at least once per period
+ */
+static volatile uint32_t time_high = 0;
+static volatile uint32_t last_uticks = 0;
+
+/**
+ * Time during which the counter was stopped (deep sleep), added to the monotonic time
+ */
+static volatile uint64_t stopped_us = 0;
+
+/**
+ * @brief Extend the counter to 64 bits
+ * Must be called with the interrupts masked (or from the interrupt)
+ */
+static uint64_t update_time()
+{
+	uint32_t uticks = cyhal_timer_read(&Systick_obj);
+	if (uticks < last_uticks) time_high++;
+	last_uticks = uticks;
+
+	return (((uint64_t) time_high << 32) | uticks) + stopped_us;
+}
+
+static void timer_event_callback(void* callback_arg, cyhal_timer_event_t event)
+{
+	(void) callback_arg;
+	(void) event;
+
+	(void) update_time();
+}
 
 int hal_timer_init()
 {
+	// Shared by several modules (BLE host, UM980), only initialize once
+	if (timer_initialized != 0) return 0;
+
 	const cyhal_timer_cfg_t Systick_cfg =
 	{
 		.compare_value = 0,                  // Timer compare value, not used
@@ -29,8 +69,13 @@ int hal_timer_init()
 	cyhal_timer_init(&Systick_obj, NC, NULL);
 	cyhal_timer_configure(&Systick_obj, &Systick_cfg);
 	cyhal_timer_set_frequency(&Systick_obj, 1000000);
+
+	cyhal_timer_register_callback(&Systick_obj, timer_event_callback, NULL);
+	cyhal_timer_enable_event(&Systick_obj, CYHAL_TIMER_IRQ_TERMINAL_COUNT, TIMER_IRQ_PRIORITY, true);
+
 	cyhal_timer_start(&Systick_obj);
 
+	timer_initialized = 1;
 	return 0;
 }
 
@@ -39,4 +84,27 @@ uint32_t hal_timer_get_uticks(void)
 	return cyhal_timer_read(&Systick_obj);
 }
 
+uint64_t hal_timer_get_time_us(void)
+{
+	uint32_t interrupt_state = cyhal_system_critical_section_enter();
+	uint64_t time = update_time();
+	cyhal_system_critical_section_exit(interrupt_state);
+	return time;
+}
 
+void hal_timer_add_stopped_time(uint32_t duration_us)
+{
+	uint32_t interrupt_state = cyhal_system_critical_section_enter();
+	stopped_us += duration_us;
+	cyhal_system_critical_section_exit(interrupt_state);
+}
+
+uint64_t hal_timer_get_deadline(uint32_t timeout_us)
+{
+	return hal_timer_get_time_us() + timeout_us;
+}
+
+uint8_t hal_timer_is_reached(uint64_t deadline)
+{
+	return (hal_timer_get_time_us() >= deadline) ? 1 : 0;
+}
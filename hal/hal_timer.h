@@ -12,6 +12,40 @@
 
 int hal_timer_init();
 
+/**
+ * @brief Get the raw microsecond counter (wraps around after ~71 minutes)
+ *
+ * Cheap timestamp for short durations: the difference (now - start) computed with uint32_t is correct across the wrap.
+ * The counter is stopped during deep sleep, the durations measured with it do not contain the time slept.
+ */
 uint32_t hal_timer_get_uticks(void);
 
+/**
+ * @brief Get the monotonic time in microseconds since hal_timer_init (does not wrap around)
+ * Contains the deep sleep time reported with hal_timer_add_stopped_time
+ */
+uint64_t hal_timer_get_time_us(void);
+
+/**
+ * @brief Add the time during which the counter was stopped (deep sleep, measured by hal_lowpower) to the monotonic time
+ */
+void hal_timer_add_stopped_time(uint32_t duration_us);
+
+/**
+ * @brief Get the deadline of a timeout starting now
+ *
+ * @param [in] timeout_us Duration of the timeout
+ *
+ * @retval Time (hal_timer_get_time_us) at which the timeout expires
+ */
+uint64_t hal_timer_get_deadline(uint32_t timeout_us);
+
+/**
+ * @brief Check if a deadline has been reached
+ *
+ * @retval 1 Deadline reached or passed
+ * @retval 0 Deadline in the future
+ */
+uint8_t hal_timer_is_reached(uint64_t deadline);
+
 #endif /* HAL_HAL_TIMER_H_ */
@@ -9,13 +9,50 @@
 #include "hal_uart.h"
 
 #include "cyhal_uart.h"
+#include "cyhal_system.h"
 #include "cycfg_pins.h"
 #include "hal_timer.h"
 
 // UART context variables
 cyhal_uart_t uart_obj;
 
-static volatile uint8_t event_occured = 0;
+#if ((HAL_UART_TX_RING_SIZE & (HAL_UART_TX_RING_SIZE - 1)) != 0)
+#error "HAL_UART_TX_RING_SIZE must be a power of two"
+#endif
+
+#if ((HAL_UART_RX_RING_SIZE & (HAL_UART_RX_RING_SIZE - 1)) != 0)
+#error "HAL_UART_RX_RING_SIZE must be a power of two"
+#endif
+
+#define HAL_UART_TX_RING_MASK	(HAL_UART_TX_RING_SIZE - 1)
+#define HAL_UART_RX_RING_MASK	(HAL_UART_RX_RING_SIZE - 1)
+
+// The interrupt empties the hardware FIFO (128 bytes) once it contains this number of bytes
+#define RX_FIFO_LEVEL	32
+
+// Blocking reads wait at most this time
+static const uint32_t rx_timeout_us = 100000;
+
+// Blocking writes wait at most this time for the TX ring to be empty
+static const uint32_t tx_drain_timeout_us = 500000;
+
+/**
+ * TX ring written by hal_uart_write_async (main loop) and consumed by the UART interrupt
+ * The transfer in progress covers [tx_tail, tx_tail + tx_in_flight)
+ */
+static uint8_t tx_ring[HAL_UART_TX_RING_SIZE];
+static volatile uint32_t tx_head = 0;
+static volatile uint32_t tx_tail = 0;
+static volatile uint32_t tx_in_flight = 0;
+
+/**
+ * RX ring filled by the UART interrupt and consumed by the main loop
+ * Received data covers [rx_tail, rx_head)
+ */
+static uint8_t rx_ring[HAL_UART_RX_RING_SIZE];
+static volatile uint32_t rx_head = 0;
+static volatile uint32_t rx_tail = 0;
+static volatile uint32_t rx_overflows = 0;
 
 // Initialize the ARDUINO UART configuration structure
 const cyhal_uart_cfg_t uart_config =
@@ -27,9 +64,68 @@ const cyhal_uart_cfg_t uart_config =
     .rx_buffer_size = 0
 };
 
+/**
+ * @brief Start the transmission of the next contiguous part of the TX ring
+ * Must be called with the UART interrupt masked (or from the interrupt) and no transfer in progress
+ */
+static cy_rslt_t start_next_transfer()
+{
+	uint32_t pending = tx_head - tx_tail;
+	if (pending == 0) return CY_RSLT_SUCCESS;
+
+	uint32_t start = tx_tail & HAL_UART_TX_RING_MASK;
+	uint32_t len = HAL_UART_TX_RING_SIZE - start;
+	if (len > pending) len = pending;
+
+	tx_in_flight = len;
+	cy_rslt_t result = cyhal_uart_write_async(&uart_obj, &tx_ring[start], (size_t) len);
+	if (result != CY_RSLT_SUCCESS) tx_in_flight = 0;
+	return result;
+}
+
+/**
+ * @brief Move everything from the hardware FIFO to the RX ring
+ * Must be called with the UART interrupt masked (or from the interrupt)
+ */
+static void fill_rx_ring()
+{
+	for(;;)
+	{
+		uint32_t free_space = HAL_UART_RX_RING_SIZE - (rx_head - rx_tail);
+		if (free_space == 0)
+		{
+			// Drop what cannot be stored, the FIFO would trigger the interrupt again otherwise
+			uint8_t dropped[16];
+			size_t len = sizeof(dropped);
+			if ((cyhal_uart_read(&uart_obj, dropped, &len) != CY_RSLT_SUCCESS) || (len == 0)) return;
+			rx_overflows += len;
+			continue;
+		}
+
+		uint32_t start = rx_head & HAL_UART_RX_RING_MASK;
+		size_t len = HAL_UART_RX_RING_SIZE - start;
+		if (len > free_space) len = free_space;
+
+		// Not blocking: reads what is inside the FIFO
+		if (cyhal_uart_read(&uart_obj, &rx_ring[start], &len) != CY_RSLT_SUCCESS) return;
+		if (len == 0) return;
+		rx_head += len;
+	}
+}
+
 void hal_uart_callback(void *callback_arg, cyhal_uart_event_t event)
 {
-	event_occured = 1;
+	if ((event & CYHAL_UART_IRQ_TX_DONE) != 0)
+	{
+		tx_tail += tx_in_flight;
+		tx_in_flight = 0;
+		start_next_transfer();
+	}
+
+	if ((event & CYHAL_UART_IRQ_RX_FIFO) != 0)
+	{
+		fill_rx_ring();
+	}
 }
 
 int hal_uart_init()
@@ -41,48 +137,121 @@ int hal_uart_init()
 	result = cyhal_uart_set_baud(&uart_obj, baudrate, &baudrate);
 	if (result != CY_RSLT_SUCCESS) return -2;
 
+	result = cyhal_uart_set_fifo_level(&uart_obj, CYHAL_UART_FIFO_RX, RX_FIFO_LEVEL);
+	if (result != CY_RSLT_SUCCESS) return -3;
+
 	cyhal_uart_register_callback(&uart_obj, hal_uart_callback, NULL);
-	cyhal_uart_enable_event(&uart_obj, CYHAL_UART_IRQ_RX_DONE , 10, 1);
+	cyhal_uart_enable_event(&uart_obj, (cyhal_uart_event_t)(CYHAL_UART_IRQ_RX_FIFO | CYHAL_UART_IRQ_TX_DONE), 10, 1);
 
 	return 0;
 }
 
+/**
+ * @brief Get the bytes below the FIFO level as well (they do not trigger the interrupt)
+ */
+static void drain_rx_fifo()
+{
+	uint32_t saved_intr = cyhal_system_critical_section_enter();
+	fill_rx_ring();
+	cyhal_system_critical_section_exit(saved_intr);
+}
+
 uint32_t hal_uart_readable(void)
 {
-	return cyhal_uart_readable(&uart_obj);
+	drain_rx_fifo();
+	return rx_head - rx_tail;
 }
 
-int hal_uart_read(uint8_t* buffer, uint16_t size)
+uint16_t hal_uart_read_available(const uint8_t** span)
 {
-	const uint32_t timeout_us = 100000; // 100ms
-	size_t toread = (size_t)size;
-	cy_rslt_t result = cyhal_uart_read_async(&uart_obj, buffer, toread);
-	if (result != CY_RSLT_SUCCESS) return -1;
+	drain_rx_fifo();
 
-	uint32_t start_time = hal_timer_get_uticks();
-	for(;;)
+	// Only the main loop writes rx_tail, the interrupt only reads it
+	uint32_t pending = rx_head - rx_tail;
+	if (pending == 0) return 0;
+
+	uint32_t start = rx_tail & HAL_UART_RX_RING_MASK;
+	uint32_t len = HAL_UART_RX_RING_SIZE - start;
+	if (len > pending) len = pending;
+
+	*span = &rx_ring[start];
+	return (uint16_t) len;
+}
+
+void hal_uart_consume(uint16_t len)
+{
+	uint32_t pending = rx_head - rx_tail;
+	if (len > pending) len = (uint16_t) pending;
+	rx_tail += len;
+}
+
+uint32_t hal_uart_get_rx_overflows(void)
+{
+	return rx_overflows;
+}
+
+int hal_uart_read(uint8_t* buffer, uint16_t size)
+{
+	uint16_t copied = 0;
+	uint64_t deadline = hal_timer_get_deadline(rx_timeout_us);
+	while (copied < size)
 	{
-		if (event_occured != 0)
+		const uint8_t* span = NULL;
+		uint16_t len = hal_uart_read_available(&span);
+		if (len == 0)
 		{
-			event_occured = 0;
-			break;
+			if (hal_timer_is_reached(deadline)) return -2;
+			continue;
 		}
 
-		// Check for timeout
-		uint32_t current_time = hal_timer_get_uticks();
-		if (current_time < start_time) return -3;
-		if ((current_time - start_time) > timeout_us)
+		if (len > (size - copied)) len = size - copied;
+		for(uint16_t i = 0; i < len; ++i)
 		{
-			return -2;
+			buffer[copied + i] = span[i];
 		}
+		hal_uart_consume(len);
+		copied += len;
 	}
-	return (int)toread;
+	return (int)copied;
 }
 
 int hal_uart_write(uint8_t* buffer, uint16_t size)
 {
+	// Do not interleave with the data written in the background
+	uint64_t deadline = hal_timer_get_deadline(tx_drain_timeout_us);
+	while(hal_uart_get_tx_pending() > 0)
+	{
+		if (hal_timer_is_reached(deadline)) return -2;
+	}
+
 	size_t towrite = (size_t)size;
 	cy_rslt_t result = cyhal_uart_write(&uart_obj, buffer, &towrite);
 	if (result != CY_RSLT_SUCCESS) return -1;
 	return (int)towrite;
 }
+
+int hal_uart_write_async(uint8_t* buffer, uint16_t size)
+{
+	if (size > (HAL_UART_TX_RING_SIZE - hal_uart_get_tx_pending())) return -1;
+
+	// Only the main loop writes tx_head, the interrupt only reads it
+	uint32_t head = tx_head;
+	for(uint16_t i = 0; i < size; ++i)
+	{
+		tx_ring[(head + i) & HAL_UART_TX_RING_MASK] = buffer[i];
+	}
+
+	uint32_t saved_intr = cyhal_system_critical_section_enter();
+	tx_head = head + size;
+	cy_rslt_t result = CY_RSLT_SUCCESS;
+	if (tx_in_flight == 0) result = start_next_transfer();
+	cyhal_system_critical_section_exit(saved_intr);
+
+	if (result != CY_RSLT_SUCCESS) return -2;
+	return 0;
+}
+
+uint32_t hal_uart_get_tx_pending(void)
+{
+	return tx_head - tx_tail;
+}
@@ -10,6 +10,22 @@
 
 #include <stdint.h>
 
+/**
+ * @def HAL_UART_TX_RING_SIZE
+ * @brief Size of the buffer storing the data written using hal_uart_write_async (must be a power of two)
+ */
+#ifndef HAL_UART_TX_RING_SIZE
+#define HAL_UART_TX_RING_SIZE	4096
+#endif
+
+/**
+ * @def HAL_UART_RX_RING_SIZE
+ * @brief Size of the buffer filled by the UART interrupt with the received data (must be a power of two)
+ */
+#ifndef HAL_UART_RX_RING_SIZE
+#define HAL_UART_RX_RING_SIZE	2048
+#endif
+
 /**
  * @brief Initialize the communication
  *
@@ -19,12 +35,35 @@
 int hal_uart_init();
 
 /**
- * @brief Get how much bytes are available in the UART buffer
+ * @brief Get how much bytes are available in the RX ring
  */
 uint32_t hal_uart_readable(void);
 
 /**
- * @brief Read from the UART module
+ * @brief Get the received data without copy (non blocking)
+ *
+ * The data stays inside the RX ring until hal_uart_consume is called. Only the contiguous part is returned:
+ * call again after hal_uart_consume to get the data stored at the beginning of the ring.
+ *
+ * @param [out] span Start of the received data
+ *
+ * @retval 0 Nothing received
+ * @retval > 0 Number of bytes available at span
+ */
+uint16_t hal_uart_read_available(const uint8_t** span);
+
+/**
+ * @brief Release the first bytes of the RX ring (the span returned by hal_uart_read_available is not valid anymore)
+ */
+void hal_uart_consume(uint16_t len);
+
+/**
+ * @brief Get how much bytes have been dropped because the RX ring was full
+ */
+uint32_t hal_uart_get_rx_overflows(void);
+
+/**
+ * @brief Copy from the RX ring, wait until size bytes have been received
  *
  * @param [out] buffer Buffer in which the read values will be stored
  * @param [in] size Size of the data to be read
@@ -45,4 +84,23 @@ int hal_uart_read(uint8_t* buffer, uint16_t size);
  */
 int hal_uart_write(uint8_t* buffer, uint16_t size);
 
+/**
+ * @brief Copy data inside the TX ring, the transmission is done in the background (interrupt driven)
+ *
+ * The data is either completely stored or not at all
+ *
+ * @param [in] buffer Data to be written to the UART module
+ * @param [in] size Size of the data to be written
+ *
+ * @retval 0 Success
+ * @retval -1 Not enough space inside the TX ring
+ * @retval -2 Error while starting the transmission
+ */
+int hal_uart_write_async(uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Get how much bytes are still waiting inside the TX ring (or being transmitted)
+ */
+uint32_t hal_uart_get_tx_pending(void);
+
 #endif /* HAL_HAL_UART_H_ */
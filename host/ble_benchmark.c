@@ -0,0 +1,459 @@
+/*
+ * ble_benchmark.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+/**
+ * Host benchmark of the notification pipeline (host_main, notification_queue, notification_fabric)
+ *
+ * For each combination of sensor load and link, a client connects to the stand-in stack, starts the push mode and
+ * the sensors produce records during a simulated duration. The queue behaviour, the drops and the latency
+ * (record created -> record received by the client) are reported.
+ * Each combination runs inside its own process: the modules under test keep their state inside static variables.
+ * A last process checks the commands at MTU 23: answers longer than a notification must arrive complete and must not
+ * block the following commands and records.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+#include "host_main.h"
+#include "notification_defs.h"
+#include "hal/hal_timer.h"
+#include "hal_timer_host.h"
+#include "ble_port_linux.h"
+#include "profiler.h"
+#include "hal/hal_i2c_breaker.h"
+
+#define SIMULATION_DURATION_US	10000000
+#define SIMULATION_STEP_US		250
+#define SENSOR_TICK_US			(RUTRONIK_APP_PERIOD_MS * 1000)
+#define MAX_LATENCIES			200000
+
+/**
+ * Size of the answer of the command "get statistics" (26 uint32)
+ */
+#define STATS_ANSWER_SIZE		(27 * 4)
+
+/**
+ * Size of the answer of the command "get profile" for one section (20 uint32)
+ */
+#define PROFILE_ANSWER_SIZE		((4 + PROFILER_HISTOGRAM_BUCKETS) * 4)
+
+/**
+ * Size of the answer of the command "get I2C health" for one address
+ */
+#define I2C_HEALTH_ANSWER_SIZE	14
+#define COMMAND_TIMEOUT_US		1000000
+
+typedef struct
+{
+	uint16_t sensor_id;
+	uint8_t data_size;
+	uint32_t period_us;
+} sensor_load_t;
+
+typedef struct
+{
+	const char* name;
+	const sensor_load_t* sensors;
+	uint16_t sensor_count;
+} load_profile_t;
+
+typedef struct
+{
+	const char* name;
+	ble_port_linux_config_t config;
+} link_profile_t;
+
+static const sensor_load_t environment_sensors[] =
+{
+	{SHT4X_NOTIFICATION_ID, SHT4X_DATA_SIZE, 1000000},
+	{BMP581_NOTIFICATION_ID, BMP581_DATA_SIZE, 100000},
+	{SCD41_NOTIFICATION_ID, SCD41_DATA_SIZE, 5000000},
+	{SGP41_NOTIFICATION_ID, SGP41_DATA_SIZE, 1000000},
+	{BATT_NOTIFICATION_ID, BATT_DATA_SIZE, 1000000},
+};
+
+static const sensor_load_t motion_sensors[] =
+{
+	{BMI270_NOTIFICATION_ID, BMI270_DATA_SIZE, 10000},
+	{BMM350_NOTIFICATION_ID, BMM350_DATA_SIZE, 10000},
+	{TMF8828_NOTIFICATION_ID, TMF8828_DATA_SIZE, 100000},
+	{BMP581_NOTIFICATION_ID, BMP581_DATA_SIZE, 100000},
+	{BATT_NOTIFICATION_ID, BATT_DATA_SIZE, 1000000},
+};
+
+static const sensor_load_t heavy_sensors[] =
+{
+	{BMI270_NOTIFICATION_ID, BMI270_DATA_SIZE, 10000},
+	{BMI323_NOTIFICATION_ID, BMI323_DATA_SIZE, 10000},
+	{BMM350_NOTIFICATION_ID, BMM350_DATA_SIZE, 10000},
+	{TMF8828_8X8_NOTIFICATION_ID, TMF8828_8X8_DATA_SIZE, 50000},
+	{BME688_NOTIFICATION_ID, BME688_DATA_SIZE, 100000},
+	{UM980_NOTIFICATION_ID, UM980_DATA_SIZE, 100000},
+	{SHT4X_NOTIFICATION_ID, SHT4X_DATA_SIZE, 1000000},
+};
+
+static const load_profile_t loads[] =
+{
+	{"environment", environment_sensors, sizeof(environment_sensors) / sizeof(environment_sensors[0])},
+	{"motion", motion_sensors, sizeof(motion_sensors) / sizeof(motion_sensors[0])},
+	{"heavy", heavy_sensors, sizeof(heavy_sensors) / sizeof(heavy_sensors[0])},
+};
+
+static const link_profile_t links[] =
+{
+	{"mtu23/7.5ms/4pkt", {.mtu = 23, .conn_interval_us = 7500, .packets_per_event = 4, .stack_buffers = 8}},
+	{"mtu247/15ms/6pkt", {.mtu = 247, .conn_interval_us = 15000, .packets_per_event = 6, .stack_buffers = 8}},
+	{"mtu512/30ms/4pkt", {.mtu = 512, .conn_interval_us = 30000, .packets_per_event = 4, .stack_buffers = 8}},
+};
+
+static uint32_t latencies_us[MAX_LATENCIES];
+static uint32_t latency_count = 0;
+static uint32_t records_received = 0;
+
+/**
+ * Not used by the benchmark (answer of the command "get available sensors")
+ */
+uint32_t rutronik_application_get_available_sensors_mask(rutronik_application_t* app)
+{
+	return 0;
+}
+
+/**
+ * @brief Client side: parse the records packed inside a notification
+ * The benchmark writes the creation time inside the first 4 bytes of the data of each record
+ */
+static void on_notification(uint8_t* data, uint16_t len)
+{
+	const uint32_t now = hal_timer_get_uticks();
+
+	// ACK of a command
+	if (len < 4) return;
+
+	uint16_t index = 0;
+	while((index + 4) <= len)
+	{
+		uint8_t size = data[index + 2];
+		if ((index + size + 4) > len) break;
+
+		if (size >= 4)
+		{
+			uint32_t created = ((uint32_t) data[index + 3]) | (((uint32_t) data[index + 4]) << 8)
+					| (((uint32_t) data[index + 5]) << 16) | (((uint32_t) data[index + 6]) << 24);
+			if (latency_count < MAX_LATENCIES) latencies_us[latency_count++] = now - created;
+		}
+
+		records_received++;
+		index += size + 4;
+	}
+}
+
+static void produce(const sensor_load_t* sensor)
+{
+	notification_t* notification = notification_fabric_reserve(sensor->sensor_id, sensor->data_size);
+	if (notification == NULL)
+	{
+		// Counted by the host like a failed notification_fabric_create_for_*
+		host_main_add_notification(NULL);
+		return;
+	}
+
+	uint8_t* data = &notification->data[3];
+	memset(data, 0, sensor->data_size);
+	if (sensor->data_size >= 4)
+	{
+		uint32_t now = hal_timer_get_uticks();
+		data[0] = (uint8_t) (now & 0xFF);
+		data[1] = (uint8_t) ((now >> 8) & 0xFF);
+		data[2] = (uint8_t) ((now >> 16) & 0xFF);
+		data[3] = (uint8_t) ((now >> 24) & 0xFF);
+	}
+	notification_fabric_commit(notification);
+
+	host_main_add_notification(notification);
+}
+
+/**
+ * Client side of the command test: answer of the last command, concatenated from its ACK records
+ */
+static uint8_t answer[BLE_ACK_MAX_SIZE];
+static uint16_t answer_len = 0;
+static uint8_t answer_request_id = 0;
+static uint32_t answer_records = 0;
+
+static void on_command_notification(uint8_t* data, uint16_t len)
+{
+	uint16_t index = 0;
+	while((index + 4) <= len)
+	{
+		uint16_t sensor_id = (uint16_t) (data[index] | (data[index + 1] << 8));
+		uint8_t size = data[index + 2];
+		if ((index + size + 4) > len) break;
+
+		if ((sensor_id == ACK_NOTIFICATION_ID) && (size >= 2) && (data[index + 3] == answer_request_id))
+		{
+			uint16_t part_len = size - 2;
+			if ((answer_len + part_len) <= sizeof(answer)) memcpy(&answer[answer_len], &data[index + 5], part_len);
+			answer_len += part_len;
+			answer_records++;
+		}
+		else
+		{
+			records_received++;
+		}
+
+		index += size + 4;
+	}
+}
+
+/**
+ * @brief Write a command to the command characteristic and run the main loop until its answer is complete
+ *
+ * @retval Length of the answer received
+ */
+static uint16_t run_command(uint8_t request_id, const uint8_t* command, uint16_t len, uint16_t answer_size)
+{
+	uint8_t write[16];
+	write[0] = request_id;
+	memcpy(&write[1], command, len);
+
+	answer_request_id = request_id;
+	answer_len = 0;
+	answer_records = 0;
+	if (ble_port_linux_write(BLE_PORT_CHAR_CMD, write, len + 1) != 0) return 0;
+
+	for(uint32_t elapsed = 0; (elapsed < COMMAND_TIMEOUT_US) && (answer_len < answer_size); elapsed += SIMULATION_STEP_US)
+	{
+		host_main_do();
+		hal_timer_host_advance(SIMULATION_STEP_US);
+	}
+
+	// Nothing more should come
+	for(uint32_t elapsed = 0; elapsed < 50000; elapsed += SIMULATION_STEP_US)
+	{
+		host_main_do();
+		hal_timer_host_advance(SIMULATION_STEP_US);
+	}
+
+	return answer_len;
+}
+
+/**
+ * @brief Answers longer than a notification at the smallest MTU: they are split over several ACK records
+ * and the commands and data sent afterwards still go through
+ *
+ * @retval 0 Success
+ * @retval -1 Failure
+ */
+static int run_command_test()
+{
+	const ble_port_linux_config_t config = {.mtu = 23, .conn_interval_us = 7500, .packets_per_event = 4, .stack_buffers = 8};
+	const sensor_load_t sensor = {0x01, 8, 100000};
+
+	ble_port_linux_configure(&config);
+	ble_port_linux_set_client_listener(on_command_notification);
+	profiler_init(SENSOR_TICK_US);
+	Ble_Init(NULL);
+
+	ble_port_linux_connect();
+	host_main_do();
+
+	// Record that could not be created (no free notification)
+	host_main_add_notification(NULL);
+
+	const uint8_t get_stats = 6;
+	uint16_t stats_len = run_command(1, &get_stats, 1, STATS_ANSWER_SIZE);
+	uint32_t stats_records = answer_records;
+	uint32_t stats_no_buffer = (uint32_t) answer[24] | ((uint32_t) answer[25] << 8) | ((uint32_t) answer[26] << 16)
+			| ((uint32_t) answer[27] << 24);
+
+	const uint8_t get_profile[] = {8, PROFILER_SECTION_HOST_MAIN};
+	uint16_t profile_len = run_command(3, get_profile, sizeof(get_profile), PROFILE_ANSWER_SIZE);
+	uint32_t profile_count = (uint32_t) answer[0] | ((uint32_t) answer[1] << 8) | ((uint32_t) answer[2] << 16)
+			| ((uint32_t) answer[3] << 24);
+
+	// One failed transfer to a device
+	(void) hal_i2c_breaker_report(0x44, -1);
+	const uint8_t get_i2c_health[] = {10, 0x44};
+	uint16_t health_len = run_command(4, get_i2c_health, sizeof(get_i2c_health), I2C_HEALTH_ANSWER_SIZE);
+	uint32_t health_records = answer_records;
+	uint8_t health_failures = answer[1];
+
+	// TMF8828 mode without its parameter
+	const uint8_t set_tmf8828_mode = 3;
+	uint16_t mode_len = run_command(5, &set_tmf8828_mode, 1, 1);
+	uint8_t mode_answer = answer[0];
+
+	const uint8_t start_push = 1;
+	uint16_t push_len = run_command(2, &start_push, 1, 1);
+	uint8_t push_answer = answer[0];
+
+	for(uint16_t i = 0; i < 10; ++i)
+	{
+		produce(&sensor);
+		for(uint32_t elapsed = 0; elapsed < sensor.period_us; elapsed += SIMULATION_STEP_US)
+		{
+			host_main_do();
+			hal_timer_host_advance(SIMULATION_STEP_US);
+		}
+	}
+
+	// Records still waiting when the client leaves are freed
+	uint16_t free_count = notification_fabric_get_free_count();
+	for(uint16_t i = 0; i < 3; ++i)
+	{
+		produce(&sensor);
+	}
+	ble_port_linux_disconnect();
+	host_main_do();
+	uint16_t leaked = free_count - notification_fabric_get_free_count();
+
+	printf("Commands at MTU 23: statistics %u/%u bytes in %lu notifications, profile %u/%u bytes (%lu runs of host_main), "
+			"I2C health %u/%u bytes in %lu notification, push mode answer %u, %lu/10 records, %u records kept after disconnection \n",
+			stats_len, STATS_ANSWER_SIZE, (unsigned long) stats_records, profile_len, PROFILE_ANSWER_SIZE,
+			(unsigned long) profile_count, health_len, I2C_HEALTH_ANSWER_SIZE, (unsigned long) health_records,
+			(push_len == 1) ? push_answer : 0, (unsigned long) records_received, leaked);
+
+	if ((stats_len != STATS_ANSWER_SIZE) || (stats_no_buffer != 1) || (push_len != 1) || (push_answer != (start_push + 1))) return -1;
+	if ((profile_len != PROFILE_ANSWER_SIZE) || (profile_count == 0)) return -1;
+	if ((health_len != I2C_HEALTH_ANSWER_SIZE) || (health_records != 1) || (health_failures != 1)) return -1;
+	if ((mode_len != 1) || (mode_answer != BLE_ACK_ERROR)) return -1;
+	if ((records_received != 10) || (leaked != 0)) return -1;
+	if (host_main_get_stats()->dropped_too_long != 0) return -1;
+	return 0;
+}
+
+static int compare_u32(const void* a, const void* b)
+{
+	uint32_t va = *(const uint32_t*) a;
+	uint32_t vb = *(const uint32_t*) b;
+	return (va > vb) - (va < vb);
+}
+
+static double get_percentile_ms(double percentile)
+{
+	if (latency_count == 0) return 0.0;
+	uint32_t index = (uint32_t) (percentile * (latency_count - 1));
+	return latencies_us[index] / 1000.0;
+}
+
+static void run(const load_profile_t* load, const link_profile_t* link)
+{
+	uint32_t next_due_us[16] = {0};
+	uint32_t bytes_per_second = 0;
+
+	for(uint16_t i = 0; i < load->sensor_count; ++i)
+	{
+		bytes_per_second += (uint32_t) ((uint64_t) (load->sensors[i].data_size + 4) * 1000000u / load->sensors[i].period_us);
+	}
+
+	ble_port_linux_configure(&link->config);
+	ble_port_linux_set_client_listener(on_notification);
+	Ble_Init(NULL);
+
+	ble_port_linux_connect();
+	host_main_do();
+
+	const uint8_t start_push = 1;
+	ble_port_linux_write(BLE_PORT_CHAR_DATA, &start_push, 1);
+	host_main_do();
+
+	uint32_t next_tick_us = hal_timer_get_uticks();
+	const uint32_t end_us = hal_timer_get_uticks() + SIMULATION_DURATION_US;
+	while((int32_t)(end_us - hal_timer_get_uticks()) > 0)
+	{
+		const uint32_t now = hal_timer_get_uticks();
+
+		// Sensors are sampled from the 10ms tick of the main loop
+		if ((int32_t)(now - next_tick_us) >= 0)
+		{
+			next_tick_us += SENSOR_TICK_US;
+			for(uint16_t i = 0; i < load->sensor_count; ++i)
+			{
+				if ((int32_t)(now - next_due_us[i]) < 0) continue;
+				next_due_us[i] = now + load->sensors[i].period_us;
+				produce(&load->sensors[i]);
+			}
+		}
+
+		host_main_do();
+		hal_timer_host_advance(SIMULATION_STEP_US);
+	}
+
+	const ble_stats_t* stats = host_main_get_stats();
+	qsort(latencies_us, latency_count, sizeof(latencies_us[0]), compare_u32);
+
+	printf("%-12s %-17s %7lu %7lu %7lu %6lu %6u %8lu %8lu %7.1f %7.1f %7.1f\n",
+			load->name, link->name, (unsigned long) bytes_per_second,
+			(unsigned long) stats->enqueued, (unsigned long) records_received,
+			(unsigned long) (stats->dropped_queue_full + stats->dropped_too_long + stats->dropped_no_buffer), stats->queue_high_water,
+			(unsigned long) stats->bytes_per_second, (unsigned long) stats->gatt_busy_stalls,
+			get_percentile_ms(0.5), get_percentile_ms(0.99), get_percentile_ms(1.0));
+}
+
+int main(int argc, char** argv)
+{
+	printf("%-12s %-17s %7s %7s %7s %6s %6s %8s %8s %7s %7s %7s\n",
+			"load", "link", "load/s", "queued", "rcvd", "drops", "q_hw", "link B/s", "stalls",
+			"p50 ms", "p99 ms", "max ms");
+	fflush(stdout);
+
+	for(uint16_t l = 0; l < (sizeof(loads) / sizeof(loads[0])); ++l)
+	{
+		for(uint16_t k = 0; k < (sizeof(links) / sizeof(links[0])); ++k)
+		{
+			pid_t pid = fork();
+			if (pid < 0)
+			{
+				perror("fork");
+				return 1;
+			}
+
+			if (pid == 0)
+			{
+				run(&loads[l], &links[k]);
+				fflush(stdout);
+				_exit(0);
+			}
+
+			int status = 0;
+			waitpid(pid, &status, 0);
+			if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+			{
+				fprintf(stderr, "Benchmark %s / %s failed\n", loads[l].name, links[k].name);
+				return 1;
+			}
+		}
+	}
+
+	pid_t pid = fork();
+	if (pid < 0)
+	{
+		perror("fork");
+		return 1;
+	}
+
+	if (pid == 0)
+	{
+		int retval = run_command_test();
+		fflush(stdout);
+		_exit((retval == 0) ? 0 : 1);
+	}
+
+	int status = 0;
+	waitpid(pid, &status, 0);
+	if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+	{
+		fprintf(stderr, "Command test failed\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * ble_port_linux.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "ble_port_linux.h"
+#include "host_main.h"
+#include "hal/hal_timer.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define ATT_NOTIFICATION_HEADER_SIZE	3
+#define EVENT_QUEUE_SIZE				16
+
+typedef enum
+{
+	EVENT_CONNECTED,
+	EVENT_DISCONNECTED,
+	EVENT_ADVERTISING,
+	EVENT_MTU_EXCHANGED,
+	EVENT_NOTIFICATION_CONFIG,
+	EVENT_WRITE
+} event_type_e;
+
+typedef struct
+{
+	event_type_e type;
+	uint32_t param;
+	uint8_t characteristic;
+	uint16_t len;
+	uint8_t data[BLE_PORT_MAX_MTU];
+} event_t;
+
+static ble_port_linux_config_t config =
+{
+	.mtu = 247,
+	.conn_interval_us = 7500,
+	.packets_per_event = 6,
+	.stack_buffers = 8
+};
+
+static ble_port_linux_client_listener_t client_listener = NULL;
+
+static uint8_t connected = 0;
+static uint16_t mtu = BLE_PORT_DEFAULT_MTU;
+static uint32_t next_conn_event_us = 0;
+
+// Set when the stack refused a notification, a busy status (free) event is sent once buffers are available again
+static uint8_t was_busy = 0;
+static uint32_t write_errors = 0;
+
+static uint8_t tx_buffers[BLE_PORT_LINUX_MAX_BUFFERS][BLE_PORT_MAX_MTU];
+static uint16_t tx_lens[BLE_PORT_LINUX_MAX_BUFFERS];
+static uint16_t tx_head = 0;
+static uint16_t tx_count = 0;
+
+static event_t events[EVENT_QUEUE_SIZE];
+static uint16_t event_head = 0;
+static uint16_t event_count = 0;
+
+static event_t* push_event(event_type_e type, uint32_t param)
+{
+	if (event_count >= EVENT_QUEUE_SIZE) return NULL;
+
+	event_t* event = &events[(event_head + event_count) % EVENT_QUEUE_SIZE];
+	event->type = type;
+	event->param = param;
+	event_count++;
+	return event;
+}
+
+static void deliver_event(event_t* event)
+{
+	switch(event->type)
+	{
+		case EVENT_CONNECTED:
+			host_main_on_connected(event->param);
+			break;
+		case EVENT_DISCONNECTED:
+			host_main_on_disconnected();
+			break;
+		case EVENT_ADVERTISING:
+			host_main_on_advertising();
+			break;
+		case EVENT_MTU_EXCHANGED:
+			mtu = (uint16_t) event->param;
+			host_main_on_mtu_exchanged(mtu);
+			break;
+		case EVENT_NOTIFICATION_CONFIG:
+			host_main_on_notification_config((uint8_t) event->param);
+			break;
+		case EVENT_WRITE:
+			// Write request: answered once host_main queued it
+			if (host_main_on_write(event->characteristic, event->data, event->len) != 0) write_errors++;
+			break;
+	}
+}
+
+/**
+ * @brief Transmit the buffered notifications at each connection event that elapsed
+ */
+static void run_link()
+{
+	uint32_t now = hal_timer_get_uticks();
+
+	while((int32_t)(now - next_conn_event_us) >= 0)
+	{
+		if (tx_count == 0)
+		{
+			// Nothing to transmit, skip the elapsed connection events
+			uint32_t elapsed_events = (now - next_conn_event_us) / config.conn_interval_us + 1;
+			next_conn_event_us += elapsed_events * config.conn_interval_us;
+			break;
+		}
+
+		for(uint16_t i = 0; (i < config.packets_per_event) && (tx_count > 0); ++i)
+		{
+			uint16_t index = (tx_head + BLE_PORT_LINUX_MAX_BUFFERS - tx_count) % BLE_PORT_LINUX_MAX_BUFFERS;
+			if (client_listener != NULL) client_listener(tx_buffers[index], tx_lens[index]);
+			tx_count--;
+		}
+		next_conn_event_us += config.conn_interval_us;
+	}
+
+	if ((was_busy != 0) && (tx_count < config.stack_buffers))
+	{
+		was_busy = 0;
+		host_main_on_stack_free();
+	}
+}
+
+int ble_port_init()
+{
+	connected = 0;
+	mtu = BLE_PORT_DEFAULT_MTU;
+	was_busy = 0;
+	tx_head = 0;
+	tx_count = 0;
+	event_head = 0;
+	event_count = 0;
+	return 0;
+}
+
+void ble_port_process_events()
+{
+	if (connected != 0) run_link();
+
+	while(event_count > 0)
+	{
+		event_t* event = &events[event_head];
+		event_head = (event_head + 1) % EVENT_QUEUE_SIZE;
+		event_count--;
+		deliver_event(event);
+	}
+}
+
+uint8_t ble_port_has_pending_events()
+{
+	if (event_count > 0) return 1;
+
+	// Buffered notifications are transmitted while processing the events
+	return ((connected != 0) && (tx_count > 0)) ? 1 : 0;
+}
+
+uint8_t ble_port_is_free()
+{
+	if ((connected != 0) && (tx_count < config.stack_buffers)) return 1;
+
+	was_busy = 1;
+	return 0;
+}
+
+int ble_port_notify(uint8_t* content, uint16_t len)
+{
+	if ((len == 0) || (len > (mtu - ATT_NOTIFICATION_HEADER_SIZE))) return -2;
+	if (connected == 0) return -1;
+
+	if (tx_count >= config.stack_buffers)
+	{
+		was_busy = 1;
+		return -1;
+	}
+
+	memcpy(tx_buffers[tx_head], content, len);
+	tx_lens[tx_head] = len;
+	tx_head = (tx_head + 1) % BLE_PORT_LINUX_MAX_BUFFERS;
+	tx_count++;
+	return 0;
+}
+
+void ble_port_linux_configure(const ble_port_linux_config_t* new_config)
+{
+	config = *new_config;
+	if (config.mtu > BLE_PORT_MAX_MTU) config.mtu = BLE_PORT_MAX_MTU;
+	if (config.mtu < BLE_PORT_DEFAULT_MTU) config.mtu = BLE_PORT_DEFAULT_MTU;
+	if (config.stack_buffers > BLE_PORT_LINUX_MAX_BUFFERS) config.stack_buffers = BLE_PORT_LINUX_MAX_BUFFERS;
+	if (config.conn_interval_us == 0) config.conn_interval_us = 7500;
+}
+
+void ble_port_linux_set_client_listener(ble_port_linux_client_listener_t listener)
+{
+	client_listener = listener;
+}
+
+void ble_port_linux_connect()
+{
+	connected = 1;
+	was_busy = 0;
+	tx_count = 0;
+	next_conn_event_us = hal_timer_get_uticks() + config.conn_interval_us;
+
+	push_event(EVENT_CONNECTED, config.conn_interval_us);
+	push_event(EVENT_MTU_EXCHANGED, config.mtu);
+	push_event(EVENT_NOTIFICATION_CONFIG, 1);
+}
+
+void ble_port_linux_disconnect()
+{
+	connected = 0;
+	tx_count = 0;
+	mtu = BLE_PORT_DEFAULT_MTU;
+
+	push_event(EVENT_DISCONNECTED, 0);
+	push_event(EVENT_ADVERTISING, 0);
+}
+
+int ble_port_linux_write(uint8_t characteristic, const uint8_t* data, uint16_t len)
+{
+	if (len > (mtu - ATT_NOTIFICATION_HEADER_SIZE)) return -1;
+
+	event_t* event = push_event(EVENT_WRITE, 0);
+	if (event == NULL) return -1;
+
+	event->characteristic = characteristic;
+	event->len = len;
+	memcpy(event->data, data, len);
+	return 0;
+}
+
+uint32_t ble_port_linux_get_write_errors()
+{
+	return write_errors;
+}
+
+uint16_t ble_port_linux_get_pending()
+{
+	return tx_count;
+}
@@ -0,0 +1,74 @@
+/*
+ * ble_port_linux.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HOST_BLE_PORT_LINUX_H_
+#define HOST_BLE_PORT_LINUX_H_
+
+#include <stdint.h>
+
+#include "ble_port.h"
+
+/**
+ * Stand-in of the BLE stack for the host build (implements ble_port.h)
+ *
+ * The stack has a limited number of TX buffers (busy when all are used).
+ * At each connection event, the link transmits a limited number of notifications to the client.
+ * Events (connection, MTU exchange, busy status, writes) are reported from ble_port_process_events, as on the target.
+ */
+
+/**
+ * @def BLE_PORT_LINUX_MAX_BUFFERS
+ * @brief Maximum number of stack TX buffers that can be configured
+ */
+#define BLE_PORT_LINUX_MAX_BUFFERS	32
+
+typedef struct
+{
+	uint16_t mtu;					/**< MTU requested by the client when connecting */
+	uint32_t conn_interval_us;		/**< Connection interval */
+	uint16_t packets_per_event;		/**< Link capacity: notifications transmitted per connection event */
+	uint16_t stack_buffers;			/**< Notifications the stack can hold before being busy */
+} ble_port_linux_config_t;
+
+/**
+ * @brief Function called when a notification reaches the client
+ */
+typedef void (*ble_port_linux_client_listener_t)(uint8_t* data, uint16_t len);
+
+/**
+ * @brief Configure the simulated link (applies from the next connection)
+ */
+void ble_port_linux_configure(const ble_port_linux_config_t* config);
+
+void ble_port_linux_set_client_listener(ble_port_linux_client_listener_t listener);
+
+/**
+ * @brief A client connects, exchanges the MTU and enables the notifications
+ */
+void ble_port_linux_connect();
+
+void ble_port_linux_disconnect();
+
+/**
+ * @brief The client writes to a characteristic (BLE_PORT_CHAR_DATA or BLE_PORT_CHAR_CMD)
+ *
+ * @retval 0 Success
+ * @retval -1 Write too long or event queue full
+ */
+int ble_port_linux_write(uint8_t characteristic, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief Get the number of writes answered with an error response (command not queued by host_main)
+ */
+uint32_t ble_port_linux_get_write_errors();
+
+/**
+ * @brief Get the number of notifications waiting inside the stack buffers
+ */
+uint16_t ble_port_linux_get_pending();
+
+#endif /* HOST_BLE_PORT_LINUX_H_ */
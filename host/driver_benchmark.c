@@ -0,0 +1,521 @@
+/*
+ * driver_benchmark.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+/**
+ * Host benchmark of the sensor drivers against the models of the virtual I2C bus
+ *
+ * Each driver reads its sensor repeatedly: the values are checked against the simulated environment and the cost of
+ * one read is reported (I2C transfers, bus time, total virtual time including the waits of the driver, CPU time).
+ * Then NACKs are injected to check that the errors are reported and that the driver recovers, and a generated UM980
+ * stream is replayed through the UART to the packet parser.
+ * The I2C trace of a few reads of every driver is recorded, dumped into a file and replayed to the drivers
+ * without the sensor models: the values and the virtual time must be the same.
+ * Finally one device hangs (every transfer times out) while all the drivers are read in rounds: its breaker must keep
+ * the time lost small, the other drivers must keep working and the device must come back once repaired.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "i2c_replay.h"
+#include "virtual_i2c.h"
+#include "virtual_sensors.h"
+#include "hal_timer_host.h"
+#include "hal_uart_host.h"
+#include "hal/hal_i2c.h"
+#include "hal/hal_i2c_breaker.h"
+#include "hal/hal_i2c_trace.h"
+#include "hal/hal_sleep.h"
+#include "hal/hal_timer.h"
+#include "hal/hal_uart.h"
+
+#include "sht4x/sht4x.h"
+#include "sgp40/sgp40.h"
+#include "scd41/scd41.h"
+#include "bmp581/bmp581.h"
+#include "dps310/dps310_app.h"
+#include "veml6030/veml6030.h"
+#include "um980/packet_handler.h"
+
+#define READS_PER_DRIVER	1000
+#define NMEA_SENTENCES		2000
+#define UART_REPLAY_ERRORS	(NMEA_SENTENCES / 500)
+#define TRACED_READS		20
+#define BREAKER_ROUNDS		250
+#define HUNG_DRIVER			3		/**< BMP581 */
+#define ABSENT_ADDRESS		0x7A	/**< No virtual sensor answers */
+
+typedef struct
+{
+	const char* name;
+	virtual_sensor_e sensor;
+	int (*init)();
+	/**
+	 * @brief One read of the sensor
+	 * @retval 0 Value read and plausible, 1 value not ready yet, < 0 error
+	 */
+	int (*read)();
+} driver_case_t;
+
+static const virtual_environment_t environment =
+{
+	.temperature = 23.5f,
+	.humidity = 41.f,
+	.pressure = 101325.f,
+	.co2_ppm = 612,
+	.voc_raw = 28000,
+	.ambient_light = 1234,
+};
+
+static int is_close(float value, float expected, float tolerance)
+{
+	return (fabsf(value - expected) <= tolerance) ? 1 : 0;
+}
+
+static int no_init()
+{
+	return 0;
+}
+
+static int read_sht4x()
+{
+	float temperature = 0;
+	float humidity = 0;
+	if (sht4x_get_temperature_and_humidity(&temperature, &humidity) != 0) return -1;
+	if (!is_close(temperature, environment.temperature, 0.1f) || !is_close(humidity, environment.humidity, 0.1f)) return -2;
+	return 0;
+}
+
+static int read_sgp40()
+{
+	uint16_t voc = 0;
+	if (sgp40_measure_raw_signal_without_compensation(&voc) != 0) return -1;
+	if (voc != environment.voc_raw) return -2;
+	return 0;
+}
+
+static int read_scd41()
+{
+	uint16_t co2 = 0;
+	float temperature = 0;
+	float humidity = 0;
+	uint8_t ready = 0;
+	if (scd41_get_data_ready_status(&ready) != 0) return -1;
+	if (ready == 0) return 1;
+	if (scd41_read_measurement(&co2, &temperature, &humidity) != 0) return -1;
+	if ((co2 != environment.co2_ppm) || !is_close(temperature, environment.temperature, 0.1f)) return -2;
+	return 0;
+}
+
+static int init_bmp581()
+{
+	uint8_t chip_id = 0;
+	if (bmp581_get_chip_id(&chip_id) != 0) return -1;
+	if (bmp581_set_oversampling_mode(3, 1, 1) != 0) return -2;
+	return bmp581_set_power_mode(1, 0x11);
+}
+
+static int read_bmp581()
+{
+	float pressure = 0;
+	float temperature = 0;
+	if (bmp581_read_pressure_and_temperature(&pressure, &temperature) != 0) return -1;
+	if (!is_close(pressure, environment.pressure, 1.f) || !is_close(temperature, environment.temperature, 0.01f)) return -2;
+	return 0;
+}
+
+static int init_dps310()
+{
+	dps310_app_init();
+	return 0;
+}
+
+static int read_dps310()
+{
+	int retval = dps310_app_do();
+	if (retval != 0) return retval;
+
+	float temperature = 0;
+	float pressure = 0;
+	dps310_app_get_last_values(&temperature, &pressure);
+	if (!is_close(pressure, environment.pressure, 2.f) || !is_close(temperature, environment.temperature, 0.5f)) return -2;
+	return 0;
+}
+
+static int read_veml6030()
+{
+	uint16_t als = 0;
+	if (veml6030_get_als_data(&als) != 0) return -1;
+	if (als != environment.ambient_light) return -2;
+	return 0;
+}
+
+static const driver_case_t driver_cases[] =
+{
+	{"SHT4x", VIRTUAL_SENSOR_SHT4X, no_init, read_sht4x},
+	{"SGP40", VIRTUAL_SENSOR_SGP40, no_init, read_sgp40},
+	{"SCD41", VIRTUAL_SENSOR_SCD41, no_init, read_scd41},
+	{"BMP581", VIRTUAL_SENSOR_BMP581, init_bmp581, read_bmp581},
+	{"DPS310", VIRTUAL_SENSOR_DPS310, init_dps310, read_dps310},
+	{"VEML6030", VIRTUAL_SENSOR_VEML6030, veml6030_init, read_veml6030},
+};
+
+static uint64_t get_cpu_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+static void init_drivers()
+{
+	sht4x_init(hal_i2c_read, hal_i2c_write, hal_sleep);
+	sgp40_init(hal_i2c_read, hal_i2c_write, hal_sleep);
+	scd41_init(hal_i2c_read, hal_i2c_write, hal_sleep);
+	bmp581_init_i2c_interface(hal_i2c_read, hal_i2c_write);
+	dps310_app_init_i2c_interface(hal_i2c_read, hal_i2c_write);
+	veml6030_init_hal(hal_i2c_read_register, hal_i2c_write);
+}
+
+/**
+ * @retval 0 Every read succeeded
+ */
+static int run_driver(const driver_case_t* driver)
+{
+	uint32_t ok = 0;
+	uint32_t not_ready = 0;
+	uint32_t errors = 0;
+
+	if (driver->init() != 0)
+	{
+		printf("%-10s init failed\n", driver->name);
+		return -1;
+	}
+
+	virtual_i2c_reset_stats();
+	uint64_t start_time = hal_timer_get_time_us();
+	uint64_t start_cpu = get_cpu_ns();
+
+	for (uint32_t i = 0; i < READS_PER_DRIVER; ++i)
+	{
+		int retval = driver->read();
+		if (retval == 0) ok++;
+		else if (retval > 0) not_ready++;
+		else errors++;
+	}
+
+	uint64_t cpu_ns = get_cpu_ns() - start_cpu;
+	uint64_t elapsed_us = hal_timer_get_time_us() - start_time;
+	const virtual_i2c_stats_t* stats = virtual_i2c_get_stats();
+
+	printf("%-10s %6u %6u %6u %8.2f %9.1f %9.1f %9.1f\n", driver->name, ok, not_ready, errors,
+			(double) stats->transfers / READS_PER_DRIVER,
+			(double) stats->bus_time_us / READS_PER_DRIVER,
+			(double) elapsed_us / READS_PER_DRIVER,
+			(double) cpu_ns / READS_PER_DRIVER);
+
+	return (errors == 0) ? 0 : -1;
+}
+
+/**
+ * @brief Inject NACKs and check that the driver reports them, then reads again
+ */
+static int run_fault_injection(const driver_case_t* driver)
+{
+	virtual_i2c_device_t* device = virtual_sensors_get(driver->sensor);
+
+	device->nack_count = 1;
+	int failed = driver->read();
+
+	// The DPS310 needs more than one read to give a value
+	int recovered = 1;
+	for (int i = 0; (i < 3) && (recovered != 0); ++i)
+	{
+		recovered = driver->read();
+	}
+
+	uint8_t passed = ((failed < 0) && (recovered == 0)) ? 1 : 0;
+	printf("%-10s NACK reported %s, recovered %s\n", driver->name, (failed < 0) ? "yes" : "no", (recovered == 0) ? "yes" : "no");
+	return passed ? 0 : -1;
+}
+
+/**
+ * @brief Write a GGA stream into a file, replay it through the UART and count the packets found by the parser
+ */
+static int run_uart_replay()
+{
+	char path[] = "/tmp/um980_replayXXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) return -1;
+
+	FILE* file = fdopen(fd, "w");
+	for (int i = 0; i < NMEA_SENTENCES; ++i)
+	{
+		fprintf(file, "$GNGGA,%06d.00,4717.11399,N,00833.91590,E,1,12,0.55,499.6,M,48.0,M,,*5B\r\n", i);
+
+		// Sentence longer than the packet buffer: has to be dropped without stopping the stream
+		if ((i % 500) == 10) fprintf(file, "$GNTXT,%0600d\r\n", 0);
+	}
+	fclose(file);
+
+	// Reset before the file is opened: it drops what the UART received
+	packet_handler_init(hal_uart_readable, hal_uart_read_available, hal_uart_consume, hal_uart_write);
+	packet_handler_reset();
+
+	if (hal_uart_host_open_file(path) != 0)
+	{
+		unlink(path);
+		return -1;
+	}
+
+	static uint8_t packet[512];
+	uint32_t packets = 0;
+	uint32_t errors = 0;
+	uint64_t start_cpu = get_cpu_ns();
+	for (;;)
+	{
+		int retval = packet_handler_read_packet(packet, sizeof(packet));
+		if (retval < 0)
+		{
+			// The parser has to move past the bytes in fault
+			if (++errors > UART_REPLAY_ERRORS) break;
+			continue;
+		}
+		if (retval == 0)
+		{
+			// The whole file has been read
+			if (hal_uart_readable() == 0) break;
+			continue;
+		}
+		if (packet_handler_get_packet_type(packet) == PACKET_HANDLER_NMEA_PACKET) packets++;
+	}
+	uint64_t cpu_ns = get_cpu_ns() - start_cpu;
+
+	hal_uart_host_close();
+	unlink(path);
+
+	printf("UM980 replay: %u/%d NMEA packets, %u errors, %.1f ns CPU per packet\n", packets, NMEA_SENTENCES, errors,
+			(packets != 0) ? (double) cpu_ns / packets : 0.0);
+	return ((packets == NMEA_SENTENCES) && (errors == UART_REPLAY_ERRORS)) ? 0 : -1;
+}
+
+static FILE* trace_file = NULL;
+
+static void write_trace_line(const char* line)
+{
+	fprintf(trace_file, "%s\r\n", line);
+}
+
+/**
+ * @brief Init every driver and read it TRACED_READS times
+ *
+ * @retval >= 0 Number of values read
+ * @retval -1 Init or read error
+ */
+static int run_traced_reads(uint16_t driver_count)
+{
+	int values = 0;
+	for (uint16_t i = 0; i < driver_count; ++i)
+	{
+		if (driver_cases[i].init() != 0) return -1;
+		for (uint32_t j = 0; j < TRACED_READS; ++j)
+		{
+			int retval = driver_cases[i].read();
+			if (retval < 0) return -1;
+			if (retval == 0) values++;
+		}
+	}
+	return values;
+}
+
+/**
+ * @brief Record the I2C trace of the drivers, replay it without the sensor models and compare
+ */
+static int run_trace_replay(uint16_t driver_count)
+{
+	char path[] = "/tmp/i2c_traceXXXXXX";
+	int fd = mkstemp(path);
+	if (fd < 0) return -1;
+
+	// Record
+	virtual_sensors_init(&environment);
+	hal_i2c_trace_clear();
+	hal_i2c_trace_enable(1);
+
+	uint64_t start_time = hal_timer_get_time_us();
+	int record_values = run_traced_reads(driver_count);
+	uint64_t record_us = hal_timer_get_time_us() - start_time;
+
+	hal_i2c_trace_enable(0);
+	uint32_t dropped = hal_i2c_trace_get_dropped();
+
+	trace_file = fdopen(fd, "w");
+	hal_i2c_trace_dump(write_trace_line);
+	fclose(trace_file);
+
+	// Replay
+	int records = i2c_replay_load_file(path);
+	unlink(path);
+	if (records <= 0) return -1;
+	i2c_replay_attach();
+
+	start_time = hal_timer_get_time_us();
+	int replay_values = run_traced_reads(driver_count);
+	uint64_t replay_us = hal_timer_get_time_us() - start_time;
+
+	const i2c_replay_stats_t* stats = i2c_replay_get_stats();
+	i2c_replay_print_summary();
+	printf("Replay: %u/%u records, %u mismatches, %u exhausted, %u dropped, virtual time %llu us recorded, %llu us replayed\n",
+			stats->replayed, stats->records, stats->mismatches, stats->exhausted, dropped,
+			(unsigned long long) record_us, (unsigned long long) replay_us);
+
+	int passed = (record_values > 0) && (replay_values == record_values) && (dropped == 0) && (stats->invalid_lines == 0)
+			&& (stats->replayed == stats->records) && (stats->mismatches == 0) && (stats->exhausted == 0)
+			&& (record_us == replay_us);
+
+	i2c_replay_free();
+	virtual_sensors_init(&environment);
+	return passed ? 0 : -1;
+}
+
+/**
+ * @brief Read every driver in rounds while one device hangs, then repair it
+ */
+static int run_breaker(uint16_t driver_count)
+{
+	const driver_case_t* hung = &driver_cases[HUNG_DRIVER];
+	virtual_i2c_device_t* device = virtual_sensors_get(hung->sensor);
+
+	virtual_sensors_init(&environment);
+	hal_i2c_breaker_reset();
+	for (uint16_t i = 0; i < driver_count; ++i)
+	{
+		if (driver_cases[i].init() != 0) return -1;
+	}
+
+	uint32_t healthy_errors = 0;
+	uint32_t repaired_values = 0;
+	uint64_t lost_us = 0;
+	uint64_t worst_round_us = 0;
+	uint64_t start_time = hal_timer_get_time_us();
+	uint64_t hung_time = 0;
+
+	// Transfers last longer than the timeout: the device holds the clock
+	device->latency_us = 2 * HAL_I2C_TIMEOUT_US;
+
+	for (uint32_t round = 0; round < (2 * BREAKER_ROUNDS); ++round)
+	{
+		if (round == BREAKER_ROUNDS)
+		{
+			hung_time = hal_timer_get_time_us() - start_time;
+			device->latency_us = 0;
+		}
+
+		uint64_t round_start = hal_timer_get_time_us();
+		for (uint16_t i = 0; i < driver_count; ++i)
+		{
+			uint64_t read_start = hal_timer_get_time_us();
+			int retval = driver_cases[i].read();
+
+			if (i != HUNG_DRIVER)
+			{
+				if (retval < 0) healthy_errors++;
+			}
+			else if (round < BREAKER_ROUNDS)
+			{
+				lost_us += hal_timer_get_time_us() - read_start;
+			}
+			else if (retval == 0)
+			{
+				repaired_values++;
+			}
+		}
+
+		uint64_t round_us = hal_timer_get_time_us() - round_start;
+		if ((round < BREAKER_ROUNDS) && (round_us > worst_round_us)) worst_round_us = round_us;
+	}
+
+	const hal_i2c_device_stats_t* stats = hal_i2c_breaker_get_device(device->address);
+	const virtual_i2c_stats_t* bus = virtual_i2c_get_stats();
+
+	printf("Breaker: %s hung %.1f s, %.1f ms lost (%u timeouts, %u rejected, %u trips, %lu recoveries), worst round %.1f ms\n",
+			hung->name, (double) hung_time / 1000000.0, (double) lost_us / 1000.0, stats->timeouts, stats->rejected,
+			stats->trips, (unsigned long) hal_i2c_breaker_get_recoveries(), (double) worst_round_us / 1000.0);
+	printf("Breaker: other drivers %u errors, %s repaired: %u values, breaker %s, bus timeouts %u\n",
+			healthy_errors, hung->name, repaired_values, (stats->state == HAL_I2C_BREAKER_CLOSED) ? "closed" : "open",
+			bus->timeouts);
+
+	// Absent board probed (hot-plug): its breaker opens and fails its half-open probes, the bus is never cleared
+	uint32_t recoveries = hal_i2c_breaker_get_recoveries();
+	uint8_t probe = 0;
+	for (uint8_t i = 0; i < HAL_I2C_BREAKER_THRESHOLD; ++i)
+	{
+		(void) hal_i2c_read(ABSENT_ADDRESS, &probe, sizeof(probe));
+	}
+	for (uint8_t i = 0; i < 3; ++i)
+	{
+		hal_timer_host_advance(HAL_I2C_BREAKER_OPEN_MAX_US);
+		(void) hal_i2c_read(ABSENT_ADDRESS, &probe, sizeof(probe));
+	}
+	const hal_i2c_device_stats_t* absent = hal_i2c_breaker_get_device(ABSENT_ADDRESS);
+	uint32_t absent_recoveries = hal_i2c_breaker_get_recoveries() - recoveries;
+
+	printf("Breaker: absent device %u trips, %lu recoveries\n", absent->trips, (unsigned long) absent_recoveries);
+
+	// Without breaker every read of the hung device would cost a timeout
+	uint64_t unprotected_us = (uint64_t) BREAKER_ROUNDS * HAL_I2C_TIMEOUT_US;
+	int passed = (healthy_errors == 0) && (repaired_values > 0) && (stats->state == HAL_I2C_BREAKER_CLOSED)
+			&& ((10 * lost_us) < unprotected_us) && (absent->trips == 4) && (absent_recoveries == 0);
+
+	virtual_sensors_init(&environment);
+	hal_i2c_breaker_reset();
+	return passed ? 0 : -1;
+}
+
+int main(void)
+{
+	int failures = 0;
+	const uint16_t driver_count = sizeof(driver_cases) / sizeof(driver_cases[0]);
+
+	hal_timer_init();
+	hal_i2c_trace_enable(0);
+	virtual_sensors_init(&environment);
+	init_drivers();
+
+	printf("%d reads per driver, costs per read\n", READS_PER_DRIVER);
+	printf("%-10s %6s %6s %6s %8s %9s %9s %9s\n", "driver", "ok", "wait", "error", "xfers", "bus us", "virt us", "cpu ns");
+	for (uint16_t i = 0; i < driver_count; ++i)
+	{
+		if (run_driver(&driver_cases[i]) != 0) failures++;
+	}
+
+	printf("\n");
+	for (uint16_t i = 0; i < driver_count; ++i)
+	{
+		if (run_fault_injection(&driver_cases[i]) != 0) failures++;
+	}
+
+	printf("\n");
+	if (run_uart_replay() != 0) failures++;
+
+	printf("\n");
+	if (run_trace_replay(driver_count) != 0) failures++;
+
+	printf("\n");
+	if (run_breaker(driver_count) != 0) failures++;
+
+	if (failures != 0)
+	{
+		printf("\n%d check(s) failed\n", failures);
+		return 1;
+	}
+	return 0;
+}
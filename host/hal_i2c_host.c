@@ -0,0 +1,256 @@
+/*
+ * hal_i2c_host.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "virtual_i2c.h"
+#include "hal_timer_host.h"
+#include "hal/hal_i2c.h"
+#include "hal/hal_i2c_breaker.h"
+#include "hal/hal_i2c_trace.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/**
+ * Host implementation of hal/hal_i2c.h on top of the virtual bus
+ * The asynchronous transactions are executed when they are submitted, their callbacks are called by hal_i2c_process.
+ * The breakers of the devices are the ones of the target (hal_i2c_breaker.c), recovering the bus only counts.
+ */
+
+// Largest vectored write (BMI270 config upload)
+#define VECTOR_BUFFER_SIZE	8192
+
+static virtual_i2c_device_t* devices = NULL;
+static virtual_i2c_stats_t stats;
+
+static hal_i2c_transaction_t* completed_head = NULL;
+static hal_i2c_transaction_t* completed_tail = NULL;
+
+static virtual_i2c_device_t* find_device(uint8_t address)
+{
+	for (virtual_i2c_device_t* device = devices; device != NULL; device = device->next)
+	{
+		if (device->address == address) return device;
+	}
+	return NULL;
+}
+
+/**
+ * @brief Account the transfer and check if the device acknowledges it
+ *
+ * @retval 0 Acknowledged
+ * @retval -1 Not acknowledged
+ * @retval -2 Timeout
+ */
+static int8_t start_transfer(virtual_i2c_device_t* device, uint16_t len)
+{
+	uint32_t duration_us = HAL_I2C_TRANSFER_TIME_US(len);
+	if (device != NULL) duration_us += device->latency_us;
+
+	stats.transfers++;
+	if (duration_us > HAL_I2C_TIMEOUT_US)
+	{
+		// Aborted by the master
+		stats.timeouts++;
+		stats.bus_time_us += HAL_I2C_TIMEOUT_US;
+		hal_timer_host_advance(HAL_I2C_TIMEOUT_US);
+		return -2;
+	}
+
+	stats.bus_time_us += duration_us;
+	hal_timer_host_advance(duration_us);
+
+	if ((device == NULL) || (device->nack_count > 0))
+	{
+		if (device != NULL) device->nack_count--;
+		stats.nacks++;
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Account the result of a transfer, the bus is recovered when the breaker of the device opens
+ */
+static int8_t report_transfer(uint8_t address, int8_t result)
+{
+	if (hal_i2c_breaker_report(address, result) != 0) (void) hal_i2c_recover();
+	return result;
+}
+
+void virtual_i2c_attach(virtual_i2c_device_t* device)
+{
+	device->next = devices;
+	devices = device;
+}
+
+void virtual_i2c_detach_all()
+{
+	devices = NULL;
+}
+
+int8_t virtual_i2c_write(uint8_t address, const uint8_t* data, uint16_t len)
+{
+	virtual_i2c_device_t* device = find_device(address);
+	int8_t result = start_transfer(device, len);
+	if (result != 0) return result;
+
+	if ((device->write == NULL) || (device->write(device, data, len) != 0))
+	{
+		stats.nacks++;
+		return -1;
+	}
+	return 0;
+}
+
+int8_t virtual_i2c_read(uint8_t address, uint8_t* data, uint16_t len)
+{
+	virtual_i2c_device_t* device = find_device(address);
+	int8_t result = start_transfer(device, len);
+	if (result != 0) return result;
+
+	if ((device->read == NULL) || (device->read(device, data, len) != 0))
+	{
+		stats.nacks++;
+		return -1;
+	}
+	return 0;
+}
+
+const virtual_i2c_stats_t* virtual_i2c_get_stats()
+{
+	return &stats;
+}
+
+void virtual_i2c_reset_stats()
+{
+	memset(&stats, 0, sizeof(stats));
+}
+
+int8_t hal_i2c_init()
+{
+	return 0;
+}
+
+int8_t hal_i2c_recover()
+{
+	hal_i2c_breaker_add_recovery();
+	return 0;
+}
+
+int8_t hal_i2c_read(uint8_t address, uint8_t* data, uint16_t len)
+{
+	if (hal_i2c_breaker_allow(address) == 0) return HAL_I2C_REJECTED;
+
+	HAL_I2C_TRACE_BEGIN(trace_start);
+	int8_t result = virtual_i2c_read(address, data, len);
+	HAL_I2C_TRACE_RECORD(trace_start, address, NULL, 0, data, len, result);
+	return report_transfer(address, result);
+}
+
+int8_t hal_i2c_write(uint8_t address, uint8_t* data, uint16_t len)
+{
+	if (hal_i2c_breaker_allow(address) == 0) return HAL_I2C_REJECTED;
+
+	HAL_I2C_TRACE_BEGIN(trace_start);
+	int8_t result = virtual_i2c_write(address, data, len);
+	HAL_I2C_TRACE_RECORD(trace_start, address, &(hal_i2c_segment_t){ .data = data, .len = len }, 1, NULL, 0, result);
+	return report_transfer(address, result);
+}
+
+int8_t hal_i2c_write_vector(uint8_t address, const hal_i2c_segment_t* segments, uint8_t count)
+{
+	// The models see the transfer as a whole
+	static uint8_t buffer[VECTOR_BUFFER_SIZE];
+	uint16_t len = 0;
+
+	if (hal_i2c_breaker_allow(address) == 0) return HAL_I2C_REJECTED;
+	HAL_I2C_TRACE_BEGIN(trace_start);
+
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		if (segments[i].len > (VECTOR_BUFFER_SIZE - len)) return report_transfer(address, -1);
+		memcpy(&buffer[len], segments[i].data, segments[i].len);
+		len += segments[i].len;
+	}
+
+	int8_t result = virtual_i2c_write(address, buffer, len);
+	HAL_I2C_TRACE_RECORD(trace_start, address, segments, count, NULL, 0, result);
+	return report_transfer(address, result);
+}
+
+int8_t hal_i2c_write_read(uint8_t address, const uint8_t* tx_data, uint16_t tx_len, uint8_t* rx_data, uint16_t rx_len)
+{
+	if (hal_i2c_breaker_allow(address) == 0) return HAL_I2C_REJECTED;
+	HAL_I2C_TRACE_BEGIN(trace_start);
+
+	int8_t result = 0;
+	if (tx_len > 0) result = virtual_i2c_write(address, tx_data, tx_len);
+	if ((result == 0) && (rx_len > 0)) result = virtual_i2c_read(address, rx_data, rx_len);
+
+	HAL_I2C_TRACE_RECORD(trace_start, address, &(hal_i2c_segment_t){ .data = tx_data, .len = tx_len }, 1,
+			rx_data, rx_len, result);
+	return report_transfer(address, result);
+}
+
+int8_t hal_i2c_write_register(uint8_t address, uint8_t reg, uint8_t* data, uint16_t size)
+{
+	hal_i2c_segment_t segments[2] =
+	{
+		{ .data = &reg, .len = 1 },
+		{ .data = data, .len = size },
+	};
+
+	return hal_i2c_write_vector(address, segments, 2);
+}
+
+int8_t hal_i2c_read_register(uint8_t address, uint8_t reg, uint8_t* data, uint16_t size)
+{
+	return hal_i2c_write_read(address, &reg, 1, data, size);
+}
+
+int8_t hal_i2c_submit(hal_i2c_transaction_t* transaction)
+{
+	if ((transaction == NULL) || (transaction->result == HAL_I2C_PENDING)) return -1;
+	if ((transaction->tx_len == 0) && (transaction->rx_len == 0)) return -1;
+
+	transaction->result = hal_i2c_write_read(transaction->address, transaction->tx_data, transaction->tx_len,
+			transaction->rx_data, transaction->rx_len);
+
+	transaction->next = NULL;
+	if (completed_tail == NULL) completed_head = transaction;
+	else completed_tail->next = transaction;
+	completed_tail = transaction;
+
+	return 0;
+}
+
+void hal_i2c_process()
+{
+	while (completed_head != NULL)
+	{
+		hal_i2c_transaction_t* transaction = completed_head;
+		completed_head = transaction->next;
+		if (completed_head == NULL) completed_tail = NULL;
+		transaction->next = NULL;
+
+		if (transaction->callback != NULL) transaction->callback(transaction);
+	}
+}
+
+uint8_t hal_i2c_is_busy()
+{
+	return 0;
+}
+
+uint8_t hal_i2c_has_completed()
+{
+	return (completed_head != NULL) ? 1 : 0;
+}
+
+void hal_i2c_flush()
+{
+}
@@ -0,0 +1,79 @@
+/*
+ * hal_lowpower_host.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "hal_timer_host.h"
+#include "hal/hal_lowpower.h"
+#include "hal/hal_timer.h"
+
+#include <string.h>
+
+/**
+ * Host implementation of hal/hal_lowpower.h on top of the virtual time of hal_timer_host (1 count = 1 us)
+ * Sleeping moves the virtual time to the deadline
+ */
+
+static hal_lowpower_stats_t stats;
+static uint64_t sleep_us = 0;
+static uint64_t latency_sum_us = 0;
+
+int hal_lowpower_init()
+{
+	hal_lowpower_reset_stats();
+	return 0;
+}
+
+uint32_t hal_lowpower_get_frequency()
+{
+	return 1000000;
+}
+
+uint32_t hal_lowpower_get_counts()
+{
+	return hal_timer_get_uticks();
+}
+
+uint8_t hal_lowpower_is_reached(uint32_t deadline)
+{
+	return ((int32_t)(hal_lowpower_get_counts() - deadline) >= 0) ? 1 : 0;
+}
+
+void hal_lowpower_idle_until(uint32_t deadline, uint8_t allow_deep_sleep)
+{
+	uint32_t now = hal_lowpower_get_counts();
+	if ((int32_t)(now - deadline) >= 0) return;
+
+	hal_timer_host_advance(deadline - now);
+	sleep_us += deadline - now;
+	stats.sleep_time_ms = (uint32_t)(sleep_us / 1000u);
+
+	if ((allow_deep_sleep != 0) && ((deadline - now) >= HAL_LOWPOWER_DEEP_SLEEP_MIN_US)) stats.deep_sleeps++;
+	else stats.sleeps++;
+}
+
+void hal_lowpower_record_wakeup(uint32_t deadline)
+{
+	uint32_t latency_us = hal_lowpower_get_counts() - deadline;
+	if ((int32_t) latency_us < 0) return;
+
+	stats.wakeups++;
+	latency_sum_us += latency_us;
+	if (latency_us > stats.latency_max_us) stats.latency_max_us = latency_us;
+	if (latency_us > HAL_LOWPOWER_LATE_US) stats.late_wakeups++;
+}
+
+const hal_lowpower_stats_t* hal_lowpower_get_stats()
+{
+	if (stats.wakeups != 0) stats.latency_avg_us = (uint32_t)(latency_sum_us / stats.wakeups);
+	return &stats;
+}
+
+void hal_lowpower_reset_stats()
+{
+	memset(&stats, 0, sizeof(stats));
+	sleep_us = 0;
+	latency_sum_us = 0;
+}
@@ -0,0 +1,23 @@
+/*
+ * hal_sleep_host.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "hal_timer_host.h"
+#include "hal/hal_sleep.h"
+
+/**
+ * Host implementation of hal/hal_sleep.h: the waits move the virtual time forward
+ */
+
+void hal_sleep(uint32_t ms)
+{
+	hal_timer_host_advance(ms * 1000u);
+}
+
+void hal_sleep_us(uint16_t us)
+{
+	hal_timer_host_advance(us);
+}
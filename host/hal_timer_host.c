@@ -0,0 +1,47 @@
+/*
+ * hal_timer_host.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "hal_timer_host.h"
+#include "hal/hal_timer.h"
+
+static uint64_t time_us = 0;
+
+int hal_timer_init()
+{
+	return 0;
+}
+
+uint32_t hal_timer_get_uticks(void)
+{
+	return (uint32_t) time_us;
+}
+
+uint64_t hal_timer_get_time_us(void)
+{
+	return time_us;
+}
+
+void hal_timer_add_stopped_time(uint32_t duration_us)
+{
+	// The virtual time never stops
+	(void) duration_us;
+}
+
+uint64_t hal_timer_get_deadline(uint32_t timeout_us)
+{
+	return time_us + timeout_us;
+}
+
+uint8_t hal_timer_is_reached(uint64_t deadline)
+{
+	return (time_us >= deadline) ? 1 : 0;
+}
+
+void hal_timer_host_advance(uint32_t delta_us)
+{
+	time_us += delta_us;
+}
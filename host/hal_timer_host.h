@@ -0,0 +1,23 @@
+/*
+ * hal_timer_host.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HOST_HAL_TIMER_HOST_H_
+#define HOST_HAL_TIMER_HOST_H_
+
+#include <stdint.h>
+
+/**
+ * Host implementation of hal/hal_timer.h
+ * The time is virtual: it only moves when the simulation advances it (deterministic and faster than real time)
+ */
+
+/**
+ * @brief Move the virtual time forward
+ */
+void hal_timer_host_advance(uint32_t delta_us);
+
+#endif /* HOST_HAL_TIMER_HOST_H_ */
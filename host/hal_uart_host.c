@@ -0,0 +1,182 @@
+/*
+ * hal_uart_host.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#define _GNU_SOURCE
+
+#include "hal_uart_host.h"
+#include "hal/hal_uart.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define HAL_UART_RX_RING_MASK	(HAL_UART_RX_RING_SIZE - 1)
+
+// Blocking reads wait at most this time (real time: the other side of a pseudo terminal is a real process)
+static const int rx_timeout_ms = 100;
+
+static int rx_fd = -1;
+static int tx_fd = -1;
+static uint32_t tx_count = 0;
+
+/**
+ * Same ring as the target (hal_uart.c), filled from the file descriptor instead of the interrupt
+ */
+static uint8_t rx_ring[HAL_UART_RX_RING_SIZE];
+static uint32_t rx_head = 0;
+static uint32_t rx_tail = 0;
+
+static void fill_rx_ring()
+{
+	if (rx_fd < 0) return;
+
+	for(;;)
+	{
+		uint32_t free_space = HAL_UART_RX_RING_SIZE - (rx_head - rx_tail);
+		if (free_space == 0) return;
+
+		uint32_t start = rx_head & HAL_UART_RX_RING_MASK;
+		uint32_t len = HAL_UART_RX_RING_SIZE - start;
+		if (len > free_space) len = free_space;
+
+		ssize_t retval = read(rx_fd, &rx_ring[start], len);
+		if (retval <= 0) return;
+		rx_head += (uint32_t) retval;
+	}
+}
+
+int hal_uart_host_open_file(const char* path)
+{
+	hal_uart_host_close();
+
+	rx_fd = open(path, O_RDONLY | O_NONBLOCK);
+	if (rx_fd < 0) return -1;
+	return 0;
+}
+
+int hal_uart_host_open_pty(char* name, size_t size)
+{
+	hal_uart_host_close();
+
+	int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0) return -1;
+
+	if ((grantpt(fd) != 0) || (unlockpt(fd) != 0) || (ptsname_r(fd, name, size) != 0))
+	{
+		close(fd);
+		return -1;
+	}
+
+	rx_fd = fd;
+	tx_fd = fd;
+	return 0;
+}
+
+void hal_uart_host_close()
+{
+	if (rx_fd >= 0) close(rx_fd);
+	if ((tx_fd >= 0) && (tx_fd != rx_fd)) close(tx_fd);
+	rx_fd = -1;
+	tx_fd = -1;
+
+	rx_head = 0;
+	rx_tail = 0;
+	tx_count = 0;
+}
+
+uint32_t hal_uart_host_get_tx_count()
+{
+	return tx_count;
+}
+
+int hal_uart_init()
+{
+	return 0;
+}
+
+uint32_t hal_uart_readable(void)
+{
+	fill_rx_ring();
+	return rx_head - rx_tail;
+}
+
+uint16_t hal_uart_read_available(const uint8_t** span)
+{
+	fill_rx_ring();
+
+	uint32_t pending = rx_head - rx_tail;
+	if (pending == 0) return 0;
+
+	uint32_t start = rx_tail & HAL_UART_RX_RING_MASK;
+	uint32_t len = HAL_UART_RX_RING_SIZE - start;
+	if (len > pending) len = pending;
+
+	*span = &rx_ring[start];
+	return (uint16_t) len;
+}
+
+void hal_uart_consume(uint16_t len)
+{
+	uint32_t pending = rx_head - rx_tail;
+	if (len > pending) len = (uint16_t) pending;
+	rx_tail += len;
+}
+
+uint32_t hal_uart_get_rx_overflows(void)
+{
+	// The file descriptor keeps what does not fit inside the ring
+	return 0;
+}
+
+int hal_uart_read(uint8_t* buffer, uint16_t size)
+{
+	uint16_t copied = 0;
+	uint8_t waited = 0;
+	while (copied < size)
+	{
+		const uint8_t* span = NULL;
+		uint16_t len = hal_uart_read_available(&span);
+		if (len == 0)
+		{
+			if ((rx_fd < 0) || (waited != 0)) return -2;
+
+			struct pollfd pfd = { .fd = rx_fd, .events = POLLIN };
+			(void) poll(&pfd, 1, rx_timeout_ms);
+			waited = 1;
+			continue;
+		}
+
+		if (len > (size - copied)) len = size - copied;
+		memcpy(&buffer[copied], span, len);
+		hal_uart_consume(len);
+		copied += len;
+	}
+	return (int)copied;
+}
+
+int hal_uart_write(uint8_t* buffer, uint16_t size)
+{
+	tx_count += size;
+	if (tx_fd < 0) return (int)size;
+
+	ssize_t retval = write(tx_fd, buffer, size);
+	if (retval < 0) return -1;
+	return (int)retval;
+}
+
+int hal_uart_write_async(uint8_t* buffer, uint16_t size)
+{
+	if (hal_uart_write(buffer, size) != (int)size) return -2;
+	return 0;
+}
+
+uint32_t hal_uart_get_tx_pending(void)
+{
+	return 0;
+}
@@ -0,0 +1,46 @@
+/*
+ * hal_uart_host.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HOST_HAL_UART_HOST_H_
+#define HOST_HAL_UART_HOST_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Host implementation of hal/hal_uart.h
+ * The received data comes from a file (replay of a recorded stream) or from a pseudo terminal (live tool on the other side).
+ * Without source, nothing is received and the written data is discarded.
+ */
+
+/**
+ * @brief Receive the content of a file, the written data is discarded
+ *
+ * @retval 0 Success
+ * @retval -1 File cannot be opened
+ */
+int hal_uart_host_open_file(const char* path);
+
+/**
+ * @brief Receive and send through a pseudo terminal
+ *
+ * @param [out] name Path of the terminal to be opened by the other side
+ * @param [in] size Size of name
+ *
+ * @retval 0 Success
+ * @retval -1 Pseudo terminal cannot be created
+ */
+int hal_uart_host_open_pty(char* name, size_t size);
+
+void hal_uart_host_close();
+
+/**
+ * @brief Get how much bytes have been written (sent or discarded)
+ */
+uint32_t hal_uart_host_get_tx_count();
+
+#endif /* HOST_HAL_UART_HOST_H_ */
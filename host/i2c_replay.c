@@ -0,0 +1,304 @@
+/*
+ * i2c_replay.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "i2c_replay.h"
+
+#include "virtual_i2c.h"
+#include "hal_timer_host.h"
+#include "hal/hal_i2c.h"
+#include "hal/hal_i2c_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ADDRESSES	128
+#define MAX_LINE_SIZE	1024
+
+typedef struct
+{
+	hal_i2c_trace_record_t record;
+	uint8_t data[HAL_I2C_TRACE_MAX_RECORD_SIZE];	/**< Encoded record (the decoded one points inside) */
+	uint16_t len;
+} replay_record_t;
+
+/**
+ * Device answering the transfers of one address
+ */
+typedef struct
+{
+	virtual_i2c_device_t device;
+	uint32_t next;							/**< Index from which the next record of the address is searched */
+	replay_record_t* pending;				/**< Write-read record whose write has been replayed */
+	char name[8];
+} replay_device_t;
+
+static replay_record_t* records = NULL;
+static uint32_t record_count = 0;
+static uint32_t record_capacity = 0;
+
+static replay_device_t devices[MAX_ADDRESSES];
+static uint8_t attached = 0;
+static i2c_replay_stats_t stats;
+
+static int hex_value(char c)
+{
+	if ((c >= '0') && (c <= '9')) return c - '0';
+	if ((c >= 'A') && (c <= 'F')) return c - 'A' + 10;
+	if ((c >= 'a') && (c <= 'f')) return c - 'a' + 10;
+	return -1;
+}
+
+/**
+ * @brief Decode one line of hex and add the record
+ *
+ * @retval 0 Added
+ * @retval -1 Invalid line
+ */
+static int add_record(const char* hex)
+{
+	uint8_t data[HAL_I2C_TRACE_MAX_RECORD_SIZE];
+	uint16_t len = 0;
+
+	for (; (hex[0] != '\0') && (hex[0] != '\r') && (hex[0] != '\n'); hex += 2)
+	{
+		int high = hex_value(hex[0]);
+		int low = (high >= 0) ? hex_value(hex[1]) : -1;
+		if ((low < 0) || (len >= sizeof(data))) return -1;
+		data[len++] = (uint8_t)((high << 4) | low);
+	}
+
+	if (record_count == record_capacity)
+	{
+		uint32_t capacity = (record_capacity == 0) ? 256 : (2 * record_capacity);
+		replay_record_t* resized = realloc(records, capacity * sizeof(replay_record_t));
+		if (resized == NULL) return -1;
+		records = resized;
+		record_capacity = capacity;
+	}
+
+	replay_record_t* record = &records[record_count];
+	memcpy(record->data, data, len);
+	record->len = len;
+	if (hal_i2c_trace_decode(record->data, len, &record->record) != len) return -1;
+
+	record_count++;
+	return 0;
+}
+
+/**
+ * @brief Get the next record of the address of the device
+ */
+static replay_record_t* take_next(replay_device_t* device)
+{
+	for (; device->next < record_count; ++device->next)
+	{
+		if (records[device->next].record.address == device->device.address)
+		{
+			return &records[device->next++];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief Move the virtual time forward to the recorded duration (the bus already accounted the transfers)
+ */
+static int8_t finish(replay_record_t* replay)
+{
+	const hal_i2c_trace_record_t* record = &replay->record;
+
+	uint32_t bus_us = 0;
+	if ((record->flags & HAL_I2C_TRACE_FLAG_WRITE) != 0) bus_us += HAL_I2C_TRANSFER_TIME_US(record->tx_len);
+	if ((record->flags & HAL_I2C_TRACE_FLAG_READ) != 0) bus_us += HAL_I2C_TRANSFER_TIME_US(record->rx_len);
+	if (record->duration_us > bus_us) hal_timer_host_advance(record->duration_us - bus_us);
+
+	stats.replayed++;
+	return (record->result == 0) ? 0 : -1;
+}
+
+static int8_t replay_write(virtual_i2c_device_t* device, const uint8_t* data, uint16_t len)
+{
+	replay_device_t* replay_device = (replay_device_t*) device;
+
+	replay_record_t* replay = take_next(replay_device);
+	if (replay == NULL)
+	{
+		stats.exhausted++;
+		return -1;
+	}
+
+	const hal_i2c_trace_record_t* record = &replay->record;
+	uint16_t stored = (len < HAL_I2C_TRACE_MAX_PAYLOAD) ? len : HAL_I2C_TRACE_MAX_PAYLOAD;
+	if (((record->flags & HAL_I2C_TRACE_FLAG_WRITE) == 0) || (record->tx_len != len)
+			|| (memcmp(record->tx_data, data, stored) != 0))
+	{
+		stats.mismatches++;
+	}
+
+	// Read part replayed by the next read
+	if (((record->flags & HAL_I2C_TRACE_FLAG_READ) != 0) && (record->result == 0))
+	{
+		replay_device->pending = replay;
+		return 0;
+	}
+
+	return finish(replay);
+}
+
+static int8_t replay_read(virtual_i2c_device_t* device, uint8_t* data, uint16_t len)
+{
+	replay_device_t* replay_device = (replay_device_t*) device;
+
+	replay_record_t* replay = replay_device->pending;
+	replay_device->pending = NULL;
+	if (replay == NULL) replay = take_next(replay_device);
+	if (replay == NULL)
+	{
+		stats.exhausted++;
+		return -1;
+	}
+
+	const hal_i2c_trace_record_t* record = &replay->record;
+	if (((record->flags & HAL_I2C_TRACE_FLAG_READ) == 0) || (record->rx_len != len))
+	{
+		stats.mismatches++;
+	}
+
+	// The bytes after HAL_I2C_TRACE_MAX_PAYLOAD have not been recorded
+	memset(data, 0, len);
+	uint16_t stored = (record->rx_len < HAL_I2C_TRACE_MAX_PAYLOAD) ? record->rx_len : HAL_I2C_TRACE_MAX_PAYLOAD;
+	if (stored > len) stored = len;
+	if (stored > 0) memcpy(data, record->rx_data, stored);
+
+	return finish(replay);
+}
+
+int i2c_replay_load_file(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (file == NULL) return -1;
+
+	i2c_replay_free();
+
+	static char line[MAX_LINE_SIZE];
+	while (fgets(line, sizeof(line), file) != NULL)
+	{
+		// Lines can be prefixed by the terminal (time stamps)
+		const char* trace = strstr(line, HAL_I2C_TRACE_LINE_PREFIX);
+		if (trace == NULL) continue;
+		trace += strlen(HAL_I2C_TRACE_LINE_PREFIX);
+
+		if (strncmp(trace, "BEGIN", 5) == 0)
+		{
+			// Following dump: contains the previous records again
+			record_count = 0;
+			stats.invalid_lines = 0;
+			continue;
+		}
+		if (strncmp(trace, "END", 3) == 0) continue;
+
+		if (add_record(trace) != 0) stats.invalid_lines++;
+	}
+
+	fclose(file);
+
+	// The array has been moved while growing
+	for (uint32_t i = 0; i < record_count; ++i)
+	{
+		(void) hal_i2c_trace_decode(records[i].data, records[i].len, &records[i].record);
+	}
+
+	stats.records = record_count;
+	return (int) record_count;
+}
+
+void i2c_replay_attach()
+{
+	virtual_i2c_detach_all();
+	memset(devices, 0, sizeof(devices));
+	attached = 1;
+
+	uint32_t invalid_lines = stats.invalid_lines;
+	memset(&stats, 0, sizeof(stats));
+	stats.records = record_count;
+	stats.invalid_lines = invalid_lines;
+
+	for (uint32_t i = 0; i < record_count; ++i)
+	{
+		uint8_t address = records[i].record.address;
+		if (address >= MAX_ADDRESSES) continue;
+
+		replay_device_t* device = &devices[address];
+		if (device->device.write != NULL) continue;
+
+		snprintf(device->name, sizeof(device->name), "0x%02X", address);
+		device->device.name = device->name;
+		device->device.address = address;
+		device->device.write = replay_write;
+		device->device.read = replay_read;
+		device->device.state = device;
+		virtual_i2c_attach(&device->device);
+	}
+}
+
+const i2c_replay_stats_t* i2c_replay_get_stats()
+{
+	return &stats;
+}
+
+uint32_t i2c_replay_get_span_us()
+{
+	if (record_count == 0) return 0;
+
+	const hal_i2c_trace_record_t* first = &records[0].record;
+	const hal_i2c_trace_record_t* last = &records[record_count - 1].record;
+	return (last->time_us - first->time_us) + last->duration_us;
+}
+
+void i2c_replay_print_summary()
+{
+	uint32_t span_us = i2c_replay_get_span_us();
+	printf("Trace: %u records over %.1f ms\n", record_count, (double) span_us / 1000.0);
+	printf("%-8s %8s %8s %8s %8s %10s %7s\n", "address", "xfers", "written", "read", "errors", "bus us", "load %");
+
+	for (uint16_t address = 0; address < MAX_ADDRESSES; ++address)
+	{
+		uint32_t transfers = 0;
+		uint32_t written = 0;
+		uint32_t read = 0;
+		uint32_t errors = 0;
+		uint64_t bus_us = 0;
+
+		for (uint32_t i = 0; i < record_count; ++i)
+		{
+			const hal_i2c_trace_record_t* record = &records[i].record;
+			if (record->address != address) continue;
+
+			transfers++;
+			written += record->tx_len;
+			read += record->rx_len;
+			if (record->result != 0) errors++;
+			bus_us += record->duration_us;
+		}
+		if (transfers == 0) continue;
+
+		printf("0x%02X     %8u %8u %8u %8u %10llu %7.2f\n", address, transfers, written, read, errors,
+				(unsigned long long) bus_us, (span_us != 0) ? (100.0 * (double) bus_us / span_us) : 0.0);
+	}
+}
+
+void i2c_replay_free()
+{
+	if (attached != 0) virtual_i2c_detach_all();
+	attached = 0;
+	free(records);
+	records = NULL;
+	record_count = 0;
+	record_capacity = 0;
+	memset(&stats, 0, sizeof(stats));
+}
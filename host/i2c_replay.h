@@ -0,0 +1,64 @@
+/*
+ * i2c_replay.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HOST_I2C_REPLAY_H_
+#define HOST_I2C_REPLAY_H_
+
+#include <stdint.h>
+
+/**
+ * Replay of a recorded I2C trace (hal/hal_i2c_trace.h) on the virtual bus of the host build
+ *
+ * One device is attached per address found inside the trace. A device answers the transfers sent to its address
+ * with the records of that address, in their order: the read data and the result (not acknowledged) are the recorded ones
+ * and the virtual time moves forward by the recorded duration. The transfers sent to different devices can be
+ * reordered (scheduler changes) without breaking the replay.
+ * A transfer that differs from its record (direction, length or written data) is counted as a mismatch.
+ */
+
+typedef struct
+{
+	uint32_t records;			/**< Records loaded */
+	uint32_t invalid_lines;		/**< Trace lines that could not be decoded */
+	uint32_t replayed;			/**< Records used by a transfer */
+	uint32_t mismatches;		/**< Transfers that differ from their record */
+	uint32_t exhausted;			/**< Transfers sent after the last record of their address (not acknowledged) */
+} i2c_replay_stats_t;
+
+/**
+ * @brief Load the trace lines (HAL_I2C_TRACE_LINE_PREFIX) of a log of the debug UART
+ * The other lines are ignored. If the log contains several dumps, the last one is used.
+ *
+ * @retval >= 0 Number of records loaded
+ * @retval -1 File cannot be read
+ */
+int i2c_replay_load_file(const char* path);
+
+/**
+ * @brief Disconnect every device from the virtual bus and attach the devices of the loaded trace
+ * The replay starts from the first record.
+ */
+void i2c_replay_attach();
+
+const i2c_replay_stats_t* i2c_replay_get_stats();
+
+/**
+ * @brief Get the time between the start of the first record and the end of the last one
+ */
+uint32_t i2c_replay_get_span_us();
+
+/**
+ * @brief Print the workload of every address: transfers, bytes, errors, bus time and its share of the trace duration
+ */
+void i2c_replay_print_summary();
+
+/**
+ * @brief Detach the devices and free the loaded trace
+ */
+void i2c_replay_free();
+
+#endif /* HOST_I2C_REPLAY_H_ */
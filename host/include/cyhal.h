@@ -0,0 +1,16 @@
+/*
+ * cyhal.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+/**
+ * Host build only: some sensor headers (included by notification_fabric.h) include the PSoC6 headers.
+ * The modules built for the host do not use anything from them.
+ */
+
+#ifndef HOST_CYHAL_H_
+#define HOST_CYHAL_H_
+
+#endif /* HOST_CYHAL_H_ */
@@ -0,0 +1,86 @@
+/*
+ * virtual_i2c.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HOST_VIRTUAL_I2C_H_
+#define HOST_VIRTUAL_I2C_H_
+
+#include <stdint.h>
+
+/**
+ * Virtual I2C bus of the host build (hal_i2c_host.c implements hal/hal_i2c.h on top of it)
+ *
+ * A device answers the transfers sent to its address. Every transfer moves the virtual time (hal_timer_host)
+ * forward by its duration on a 400kHz bus plus the latency of the device. A transfer lasting longer than
+ * HAL_I2C_TIMEOUT_US (hung device) is aborted after HAL_I2C_TIMEOUT_US.
+ */
+
+typedef struct virtual_i2c_device virtual_i2c_device_t;
+
+struct virtual_i2c_device
+{
+	const char* name;
+	uint8_t address;
+	uint32_t latency_us;		/**< Added to the duration of every transfer (clock stretching, slow device) */
+	uint16_t nack_count;		/**< Number of the next transfers not acknowledged (fault injection) */
+
+	/**
+	 * @brief Data written by the master (one transfer, from start to stop or repeated start)
+	 * @retval 0 Acknowledged, else not acknowledged
+	 */
+	int8_t (*write)(virtual_i2c_device_t* device, const uint8_t* data, uint16_t len);
+
+	/**
+	 * @brief Data read by the master
+	 * @retval 0 Acknowledged, else not acknowledged
+	 */
+	int8_t (*read)(virtual_i2c_device_t* device, uint8_t* data, uint16_t len);
+
+	void* state;				/**< Model of the device */
+	virtual_i2c_device_t* next;	/**< Used by the bus */
+};
+
+typedef struct
+{
+	uint32_t transfers;			/**< Transfers (write or read) seen by the bus */
+	uint32_t nacks;				/**< Transfers not acknowledged (absent device, injected or refused by the model) */
+	uint32_t timeouts;			/**< Transfers aborted after HAL_I2C_TIMEOUT_US */
+	uint64_t bus_time_us;		/**< Time spent on the bus (transfers and latency) */
+} virtual_i2c_stats_t;
+
+/**
+ * @brief Connect a device to the bus (the structure stays owned by the caller)
+ */
+void virtual_i2c_attach(virtual_i2c_device_t* device);
+
+/**
+ * @brief Disconnect every device
+ */
+void virtual_i2c_detach_all();
+
+/**
+ * @brief Execute a write transfer
+ *
+ * @retval 0 Acknowledged
+ * @retval -1 Not acknowledged
+ * @retval -2 Timeout
+ */
+int8_t virtual_i2c_write(uint8_t address, const uint8_t* data, uint16_t len);
+
+/**
+ * @brief Execute a read transfer
+ *
+ * @retval 0 Acknowledged
+ * @retval -1 Not acknowledged
+ * @retval -2 Timeout
+ */
+int8_t virtual_i2c_read(uint8_t address, uint8_t* data, uint16_t len);
+
+const virtual_i2c_stats_t* virtual_i2c_get_stats();
+
+void virtual_i2c_reset_stats();
+
+#endif /* HOST_VIRTUAL_I2C_H_ */
@@ -0,0 +1,288 @@
+/*
+ * virtual_sensors.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "virtual_sensors.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define REGISTER_MAP_SIZE		512
+#define MAX_ANSWER_SIZE			9
+
+/**
+ * Register map device
+ * width is the size of one register (VEML6030: 16-bit registers, least significant byte first)
+ */
+typedef struct
+{
+	uint8_t width;
+	uint16_t index;							/**< Byte read or written next */
+	uint8_t bytes[REGISTER_MAP_SIZE];
+	uint8_t set_on_read[REGISTER_MAP_SIZE];	/**< Bits always read as 1 (status bits) */
+} register_map_t;
+
+typedef struct command_device command_device_t;
+
+/**
+ * Command device (Sensirion protocol)
+ * answer() prepares the words returned for a command, the model adds the CRC of each word
+ */
+struct command_device
+{
+	uint8_t command_len;					/**< 1 (SHT4x) or 2 bytes */
+	uint8_t answer[MAX_ANSWER_SIZE];
+	uint8_t answer_len;
+	uint8_t (*answer_words)(uint16_t command, uint16_t* words);
+};
+
+static virtual_environment_t environment;
+
+static register_map_t bmp581_registers;
+static register_map_t dps310_registers;
+static register_map_t veml6030_registers;
+
+static uint8_t sht4x_answer(uint16_t command, uint16_t* words);
+static uint8_t sgp40_answer(uint16_t command, uint16_t* words);
+static uint8_t scd41_answer(uint16_t command, uint16_t* words);
+
+static command_device_t sht4x_commands = { .command_len = 1, .answer_words = sht4x_answer };
+static command_device_t sgp40_commands = { .command_len = 2, .answer_words = sgp40_answer };
+static command_device_t scd41_commands = { .command_len = 2, .answer_words = scd41_answer };
+
+static virtual_i2c_device_t devices[VIRTUAL_SENSORS];
+
+/**
+ * Register map devices
+ */
+static int8_t register_map_write(virtual_i2c_device_t* device, const uint8_t* data, uint16_t len)
+{
+	register_map_t* map = (register_map_t*) device->state;
+	if (len == 0) return 0;
+
+	map->index = (uint16_t)(data[0] * map->width) % REGISTER_MAP_SIZE;
+	for (uint16_t i = 1; i < len; ++i)
+	{
+		map->bytes[map->index] = data[i];
+		map->index = (map->index + 1) % REGISTER_MAP_SIZE;
+	}
+	return 0;
+}
+
+static int8_t register_map_read(virtual_i2c_device_t* device, uint8_t* data, uint16_t len)
+{
+	register_map_t* map = (register_map_t*) device->state;
+
+	for (uint16_t i = 0; i < len; ++i)
+	{
+		data[i] = map->bytes[map->index] | map->set_on_read[map->index];
+		map->index = (map->index + 1) % REGISTER_MAP_SIZE;
+	}
+	return 0;
+}
+
+static void set_register(register_map_t* map, uint8_t reg, uint32_t value, uint8_t len)
+{
+	uint16_t index = (uint16_t)(reg * map->width);
+	for (uint8_t i = 0; i < len; ++i)
+	{
+		map->bytes[(index + i) % REGISTER_MAP_SIZE] = (uint8_t)(value >> (8 * i));
+	}
+}
+
+/**
+ * Command devices
+ */
+static uint8_t crc8(const uint8_t* data, uint8_t length)
+{
+	uint8_t crc = 0xFF;
+	for (uint8_t i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for (uint8_t bit = 8; bit > 0; --bit)
+		{
+			if (crc & 0x80) crc = (crc << 1) ^ 0x31;
+			else crc = (crc << 1);
+		}
+	}
+	return crc;
+}
+
+static int8_t command_write(virtual_i2c_device_t* device, const uint8_t* data, uint16_t len)
+{
+	command_device_t* model = (command_device_t*) device->state;
+	if (len < model->command_len) return -1;
+
+	uint16_t command = (model->command_len == 1) ? data[0] : (uint16_t)((data[0] << 8) | data[1]);
+
+	uint16_t words[MAX_ANSWER_SIZE / 3];
+	uint8_t count = model->answer_words(command, words);
+
+	model->answer_len = 0;
+	for (uint8_t i = 0; i < count; ++i)
+	{
+		uint8_t* word = &model->answer[model->answer_len];
+		word[0] = (uint8_t)(words[i] >> 8);
+		word[1] = (uint8_t)(words[i] & 0xFF);
+		word[2] = crc8(word, 2);
+		model->answer_len += 3;
+	}
+	return 0;
+}
+
+static int8_t command_read(virtual_i2c_device_t* device, uint8_t* data, uint16_t len)
+{
+	command_device_t* model = (command_device_t*) device->state;
+	if ((model->answer_len == 0) || (len > model->answer_len)) return -1;
+
+	memcpy(data, model->answer, len);
+	model->answer_len = 0;
+	return 0;
+}
+
+static uint16_t to_ticks(float value, float offset, float range)
+{
+	float ticks = (value + offset) * 65535.f / range;
+	if (ticks < 0) return 0;
+	if (ticks > 65535.f) return 65535;
+	return (uint16_t) ticks;
+}
+
+static uint8_t sht4x_answer(uint16_t command, uint16_t* words)
+{
+	switch (command)
+	{
+		case 0xFD:	// Measure with high precision
+			words[0] = to_ticks(environment.temperature, 45.f, 175.f);
+			words[1] = to_ticks(environment.humidity, 6.f, 125.f);
+			return 2;
+
+		case 0x89:	// Serial number
+			words[0] = 0x1234;
+			words[1] = 0x5678;
+			return 2;
+	}
+	return 0;
+}
+
+static uint8_t sgp40_answer(uint16_t command, uint16_t* words)
+{
+	switch (command)
+	{
+		case 0x260F:	// Measure raw signal
+			words[0] = environment.voc_raw;
+			return 1;
+
+		case 0x3682:	// Serial number
+			words[0] = 0x0001;
+			words[1] = 0x0203;
+			words[2] = 0x0405;
+			return 3;
+	}
+	return 0;
+}
+
+static uint8_t scd41_answer(uint16_t command, uint16_t* words)
+{
+	switch (command)
+	{
+		case 0x3682:	// Serial number
+			words[0] = 0x0A0B;
+			words[1] = 0x0C0D;
+			words[2] = 0x0E0F;
+			return 3;
+
+		case 0xE4B8:	// Data ready status
+			words[0] = 0x8006;
+			return 1;
+
+		case 0xEC05:	// Read measurement
+			words[0] = environment.co2_ppm;
+			words[1] = to_ticks(environment.temperature, 45.f, 175.f);
+			words[2] = to_ticks(environment.humidity, 0.f, 100.f);
+			return 3;
+	}
+	return 0;
+}
+
+/**
+ * @brief Write the values of the environment inside the registers of the register map devices
+ */
+static void update_registers()
+{
+	// BMP581: temperature (1/65536 degree) then pressure (1/64 Pa), 24 bits each
+	set_register(&bmp581_registers, 0x1D, (uint32_t)(int32_t)(environment.temperature * 65536.f), 3);
+	set_register(&bmp581_registers, 0x20, (uint32_t)(environment.pressure * 64.f), 3);
+
+	// DPS310: the coefficients give the values directly (raw measurements are 0): T = C0 / 2, P = C00 (Pa)
+	int32_t c0 = (int32_t)(environment.temperature * 2.f) & 0xFFF;
+	int32_t c00 = (int32_t)(environment.pressure) & 0xFFFFF;
+	dps310_registers.bytes[0x10] = (uint8_t)(c0 >> 4);
+	dps310_registers.bytes[0x11] = (uint8_t)((c0 & 0x0F) << 4);
+	dps310_registers.bytes[0x13] = (uint8_t)(c00 >> 12);
+	dps310_registers.bytes[0x14] = (uint8_t)(c00 >> 4);
+	dps310_registers.bytes[0x15] = (uint8_t)((c00 & 0x0F) << 4);
+
+	// VEML6030: ambient light
+	set_register(&veml6030_registers, 0x04, environment.ambient_light, 2);
+}
+
+static void init_device(virtual_sensor_e sensor, const char* name, uint8_t address, void* state,
+		int8_t (*write)(virtual_i2c_device_t*, const uint8_t*, uint16_t),
+		int8_t (*read)(virtual_i2c_device_t*, uint8_t*, uint16_t))
+{
+	virtual_i2c_device_t* device = &devices[sensor];
+	memset(device, 0, sizeof(*device));
+	device->name = name;
+	device->address = address;
+	device->write = write;
+	device->read = read;
+	device->state = state;
+	virtual_i2c_attach(device);
+}
+
+void virtual_sensors_init(const virtual_environment_t* new_environment)
+{
+	memset(&bmp581_registers, 0, sizeof(bmp581_registers));
+	bmp581_registers.width = 1;
+	bmp581_registers.bytes[0x01] = 0x50;	// Chip ID
+
+	memset(&dps310_registers, 0, sizeof(dps310_registers));
+	dps310_registers.width = 1;
+	dps310_registers.bytes[0x0D] = 0x10;	// Revision 1, product 0
+	dps310_registers.bytes[0x28] = 0x80;	// External temperature sensor used for the coefficients
+	dps310_registers.set_on_read[0x08] = 0xF0;	// Coefficients, sensor, temperature and pressure ready
+
+	memset(&veml6030_registers, 0, sizeof(veml6030_registers));
+	veml6030_registers.width = 2;
+	set_register(&veml6030_registers, 0x07, 0xC481, 2);	// ID (address 0x10)
+
+	sht4x_commands.answer_len = 0;
+	sgp40_commands.answer_len = 0;
+	scd41_commands.answer_len = 0;
+
+	virtual_i2c_detach_all();
+	init_device(VIRTUAL_SENSOR_SHT4X, "SHT4x", 0x44, &sht4x_commands, command_write, command_read);
+	init_device(VIRTUAL_SENSOR_SGP40, "SGP40", 0x59, &sgp40_commands, command_write, command_read);
+	init_device(VIRTUAL_SENSOR_SCD41, "SCD41", 0x62, &scd41_commands, command_write, command_read);
+	init_device(VIRTUAL_SENSOR_BMP581, "BMP581", 0x47, &bmp581_registers, register_map_write, register_map_read);
+	init_device(VIRTUAL_SENSOR_DPS310, "DPS310", 0x77, &dps310_registers, register_map_write, register_map_read);
+	init_device(VIRTUAL_SENSOR_VEML6030, "VEML6030", 0x10, &veml6030_registers, register_map_write, register_map_read);
+
+	virtual_sensors_set_environment(new_environment);
+}
+
+void virtual_sensors_set_environment(const virtual_environment_t* new_environment)
+{
+	environment = *new_environment;
+	update_registers();
+}
+
+virtual_i2c_device_t* virtual_sensors_get(virtual_sensor_e sensor)
+{
+	if (sensor >= VIRTUAL_SENSORS) return NULL;
+	return &devices[sensor];
+}
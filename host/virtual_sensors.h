@@ -0,0 +1,62 @@
+/*
+ * virtual_sensors.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef HOST_VIRTUAL_SENSORS_H_
+#define HOST_VIRTUAL_SENSORS_H_
+
+#include <stdint.h>
+
+#include "virtual_i2c.h"
+
+/**
+ * Models of the sensors for the virtual I2C bus, enough for their drivers to work
+ * - Register map devices (BMP581, DPS310, VEML6030): a write sets the register address (and writes the data that follows),
+ *   a read returns the registers from that address (auto increment)
+ * - Command devices (SHT4x, SGP40, SCD41): a write sends a command, the following read returns its answer (Sensirion CRC)
+ *   A read without answer is not acknowledged, like a measurement that is not finished yet.
+ */
+
+typedef enum
+{
+	VIRTUAL_SENSOR_SHT4X = 0,
+	VIRTUAL_SENSOR_SGP40,
+	VIRTUAL_SENSOR_SCD41,
+	VIRTUAL_SENSOR_BMP581,
+	VIRTUAL_SENSOR_DPS310,
+	VIRTUAL_SENSOR_VEML6030,
+	VIRTUAL_SENSORS
+} virtual_sensor_e;
+
+/**
+ * Values returned by the sensors
+ */
+typedef struct
+{
+	float temperature;			/**< Degree Celsius */
+	float humidity;				/**< % */
+	float pressure;				/**< Pa */
+	uint16_t co2_ppm;
+	uint16_t voc_raw;
+	uint16_t ambient_light;		/**< Raw ALS counts */
+} virtual_environment_t;
+
+/**
+ * @brief Reset the models (registers, pending answers, latency, injected NACKs) and attach them to the virtual bus
+ */
+void virtual_sensors_init(const virtual_environment_t* environment);
+
+/**
+ * @brief Change the values returned by the sensors
+ */
+void virtual_sensors_set_environment(const virtual_environment_t* environment);
+
+/**
+ * @brief Get the device of a sensor (latency and NACK injection)
+ */
+virtual_i2c_device_t* virtual_sensors_get(virtual_sensor_e sensor);
+
+#endif /* HOST_VIRTUAL_SENSORS_H_ */
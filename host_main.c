@@ -7,6 +7,8 @@
 *              throughput service. The BLE sends notification data to the BLE
 *              GATT client device which is used by the client for BLE 
 *              throughput measurement. 
+*              The BLE stack is accessed through the port layer (ble_port.h),
+*              this file does not depend on the PSoC6 BLE middleware.
 *
 * Related Document: CE222046_Throughput_Measurement.pdf
 *
@@ -46,16 +48,18 @@
 
 #include "host_main.h"
 
-#include "cy_pdl.h"
-#include "cyhal.h"
-#include "cybsp.h"
-#include "cy_syslib.h"
-#include "cy_sysint.h"
-#include "cycfg.h"
-#include "cycfg_ble.h"
+#include <string.h>
+
+#include "ble_port.h"
+#include "profiler.h"
+#include "hal/hal_i2c_breaker.h"
+#include "hal/hal_i2c_trace.h"
+#include "hal/hal_lowpower.h"
+#include "hal/hal_timer.h"
 
 #ifdef UM980_SUPPORT
 #include "hal/hal_uart.h"
+#include "um980/rtcm_reassembler.h"
 #endif
 
 
@@ -65,18 +69,9 @@
 #define ENABLE      (1u)
 #define DISABLE     (0u)
 
-#define DEBUG_BLE_ENABLE    	DISABLE
 #define DEBUG_BLE_LOGIC_ENABLE	DISABLE
 
-#if (DEBUG_BLE_ENABLE || DEBUG_BLE_LOGIC_ENABLE)
 #include <stdio.h>
-#endif
-
-#if DEBUG_BLE_ENABLE
-#define DEBUG_BLE       printf
-#else
-#define DEBUG_BLE(...)
-#endif
 
 #if DEBUG_BLE_LOGIC_ENABLE
 #define DEBUG_BLE_LOGIC       printf
@@ -85,61 +80,16 @@
 #endif
 
 
-#define DEFAULT_MTU_SIZE            (23) 
-#define NOTIFICATION_PKT_SIZE       (BLEMAX_MTU_SIZE)
-#define SUCCESS                     (0u)
-#define TARGET_BDADDR       {{0xFF, 0xBB, 0xAA, 0x50, 0xA0, 0x00}, 0}
+#define ATT_NOTIFICATION_HEADER_SIZE (3)
 
 /**
- * Get access to the custom characteristic and to its descriptor.
- * The characteristic can be configured using the Bluetooth Configurator tool
- * The descriptor enables to configure the behavior of the characteristic.
- * In our case, it will be used to enable or disable notifications
+ * Buffer used to read an entry out of the command queue (source byte + longest write)
  */
-#define CUSTOM_DESCR_HANDLE	cy_ble_customsConfig.attrInfo[0].customServInfo[0].customServCharDesc[0]
-#define CUSTOM_CHAR_HANDLE	cy_ble_customsConfig.attrInfo[0].customServInfo[0].customServCharHandle
+#define CMD_ENTRY_MAX_SIZE	(BLEMAX_MTU_SIZE + 1)
 
 
 static host_main_t app;
 
-/*******************************************************************************
-* Variables
-*******************************************************************************/
-
-/**
- * Buffer storing 512 bytes (maximum MTU size)
- * Used when sending notifications
- */
-uint8 notification_buffer[NOTIFICATION_PKT_SIZE];
-
-/**
- * Store the size of the MTU transfer
- */
-uint16 negotiatedMtu = DEFAULT_MTU_SIZE;
-
-cy_stc_ble_gap_bd_addr_t local_addr = TARGET_BDADDR;
-cy_stc_ble_conn_handle_t appConnHandle;
-cy_stc_ble_gatts_handle_value_ntf_t notificationPacket;
-
-/* BLESS interrupt configuration.
- * It is used when BLE middleware operates in BLE Single CM4 Core mode. */
-const cy_stc_sysint_t blessIsrCfg =
-{
-    /* The BLESS interrupt */
-    .intrSrc      = bless_interrupt_IRQn,
-
-    /* The interrupt priority number */
-    .intrPriority = 1u
-};
-
-/*******************************************************************************
-*        Function Prototypes
-*******************************************************************************/
-void BlessInterrupt(void);
-void IasEventHandler(uint32_t event, void *eventParam);
-void StackEventHandler(uint32 event, void* eventParam);
-void SendAnswerNotification(uint16_t len, uint8_t* content);
-
 /*******************************************************************************
 * Function Name: HostMain()
 ********************************************************************************
@@ -158,139 +108,885 @@ void SendAnswerNotification(uint16_t len, uint8_t* content);
 *
 *******************************************************************************/
 
+/**
+ * Upper bound (in us) of each bucket of the latency histogram (last bucket has no upper bound)
+ */
+static const uint32_t latency_bucket_limits_us[BLE_STATS_LATENCY_BUCKETS - 1] =
+{
+	5000, 10000, 20000, 50000, 100000, 200000, 500000
+};
+
+/**
+ * Time when each record of the frame buffer has been handed to the host (used for the latency histogram)
+ */
+static uint32_t frame_timestamps_us[BLE_FRAME_MAX_SIZE / 4];
+static uint16_t frame_records = 0;
+
+/**
+ * Set while data is waiting and the stack is busy (a stall is counted once, when it starts)
+ */
+static uint8_t stalled = 0;
+
+/**
+ * Overhead of an ACK record: sensor id, size, request id, command and crc
+ */
+#define ACK_RECORD_OVERHEAD	6
+
+/**
+ * Notification carrying the part of the ACK being sent
+ */
+static uint8_t ack_part[BLE_ACK_MAX_SIZE + ACK_RECORD_OVERHEAD];
+
+/**
+ * Size of the answer of CMD_GET_STATS (11 counters + histogram + 7 low power counters, uint32 each)
+ */
+#define BLE_STATS_ENCODED_SIZE	((11 + BLE_STATS_LATENCY_BUCKETS + 7) * 4)
+
+static void reset_stats()
+{
+	memset(&app.stats, 0, sizeof(app.stats));
+	app.stats.window_start_us = hal_timer_get_uticks();
+	hal_lowpower_reset_stats();
+}
+
+static void add_latency(uint32_t latency_us)
+{
+	uint16_t bucket = 0;
+	while((bucket < (BLE_STATS_LATENCY_BUCKETS - 1)) && (latency_us > latency_bucket_limits_us[bucket])) bucket++;
+	app.stats.latency_histogram[bucket]++;
+}
+
+/**
+ * @brief Account a notification packet handed to the stack and update the throughput
+ */
+static void add_sent_packet(uint16_t len)
+{
+	app.stats.packets_sent++;
+	app.stats.bytes_sent += len;
+	app.stats.window_bytes += len;
+}
+
+static void update_rate()
+{
+	uint32_t elapsed = hal_timer_get_uticks() - app.stats.window_start_us;
+	if (elapsed < BLE_STATS_RATE_WINDOW_US) return;
+
+	app.stats.bytes_per_second = (uint32_t)(((uint64_t) app.stats.window_bytes * 1000000u) / elapsed);
+	app.stats.window_bytes = 0;
+	app.stats.window_start_us += elapsed;
+}
+
 int host_main_add_notification(notification_t* notification)
 {
+	if (notification == NULL)
+	{
+		// The record could not be created: no free block
+		app.stats.dropped_no_buffer++;
+		return -1;
+	}
+
 	// Add to the list?
 	if ((app.notification_enabled == 0) || (app.mode != BLE_MODE_PUSH_DATA))
 	{
+		app.stats.dropped_not_push++;
 		notification_fabric_free_notification(notification);
 		return -1;
 	}
 
-	// Add to the list
-	linked_list_add_element(&app.notification_list, (void*)notification);
+	notification->timestamp_us = hal_timer_get_uticks();
+
+	// Add to the queue according to the policy of the stream (freed if the queue is full)
+	if (notification_queue_push(&app.notification_queue, notification) == NOTIFICATION_QUEUE_DROPPED)
+	{
+		app.stats.dropped_queue_full++;
+		return -1;
+	}
+
+	app.stats.enqueued++;
+	uint16_t count = notification_queue_get_count(&app.notification_queue);
+	if (count > app.stats.queue_high_water) app.stats.queue_high_water = count;
+
 	return 0;
 }
 
-int host_main_do()
+uint8_t host_main_is_subscribed(uint16_t sensor_id)
 {
-	enum commands {
-		CMD_GET_AVAILABLE_SENSORS = 0,
-		CMD_START_PUSH_MODE = 1,
-		CMD_STOP_PUSH_MODE = 2,
-		CMD_ENABLED_DISABLE_TMF8828_8x8_MODE = 3,
-		CMD_NTRIP_DATA = 4
-	};
+	if ((app.notification_enabled == 0) || (app.mode != BLE_MODE_PUSH_DATA)) return 0;
+	if (sensor_id >= 32) return 1;
 
-    // Cy_Ble_ProcessEvents() allows BLE stack to process pending events
-    Cy_BLE_ProcessEvents();
+	return ((app.subscription_mask & (1UL << sensor_id)) != 0) ? 1 : 0;
+}
 
-    // Any pending command to process
-    if (app.cmd_to_process != 0)
-    {
-    	DEBUG_BLE_LOGIC("Command is : %d \r\n", app.cmd.command);
+void host_main_notify_available_sensors(uint32_t mask, uint8_t boot_done)
+{
+	if (app.notification_enabled == 0) return;
 
-    	enum commands command = (enum commands) app.cmd.command;
-    	switch(command)
-    	{
-			case CMD_GET_AVAILABLE_SENSORS:
-			{
-				uint32_t sensor_mask = rutronik_application_get_available_sensors_mask(app.rutronik_app);
-				app.ack_to_send = 1;
-				app.ack_len = 4;
-				*((uint32_t *)app.ack_content) = sensor_mask;
-				DEBUG_BLE_LOGIC("Sensor mask: %lu \r\n", sensor_mask);
-				break;
-			}
+	app.sensors_len = notification_fabric_encode_available_sensors(app.sensors_content, BLE_SENSORS_RECORD_MAX_SIZE, mask, boot_done);
+	if (app.sensors_len > 0) app.sensors_to_send = 1;
+}
 
-			case CMD_START_PUSH_MODE:
-				app.ack_to_send = 1;
-				app.ack_len = 1;
-				app.ack_content[0] = app.cmd.command + 1;
-				DEBUG_BLE_LOGIC("Activate push mode \r\n");
-				app.mode = BLE_MODE_PUSH_DATA;
-				break;
+/**
+ * @brief Get the maximum payload of a notification for the negotiated MTU
+ */
+static uint16_t get_frame_capacity()
+{
+	uint16_t capacity = app.mtu - ATT_NOTIFICATION_HEADER_SIZE;
+	if (capacity > BLE_FRAME_MAX_SIZE) capacity = BLE_FRAME_MAX_SIZE;
+	return capacity;
+}
+
+static void reset_frame()
+{
+	app.frame_len = 0;
+	app.frame_full = 0;
+	frame_records = 0;
+}
+
+/**
+ * @brief Account the records of the frame that has just been handed to the stack
+ */
+static void add_sent_frame()
+{
+	uint32_t now = hal_timer_get_uticks();
+	for(uint16_t i = 0; i < frame_records; ++i)
+	{
+		add_latency(now - frame_timestamps_us[i]);
+	}
+	app.stats.sent += frame_records;
+}
+
+/**
+ * @brief Move as many queued records as possible inside the frame buffer
+ */
+static void fill_frame()
+{
+	const uint16_t capacity = get_frame_capacity();
+
+	for(;;)
+	{
+		notification_t* notification = notification_queue_peek(&app.notification_queue);
+		if (notification == NULL) return;
+
+		// Record can never be sent with the actual MTU, drop it
+		if (notification->length > capacity)
+		{
+			DEBUG_BLE_LOGIC("Record too long for MTU: %u \r\n", notification->length);
+			app.stats.dropped_too_long++;
+			notification_queue_pop(&app.notification_queue);
+			continue;
+		}
+
+		if ((app.frame_len + notification->length) > capacity)
+		{
+			app.frame_full = 1;
+			return;
+		}
+
+		if (app.frame_len == 0)
+		{
+			app.frame_start_us = hal_timer_get_uticks();
+		}
+
+		memcpy(&app.frame[app.frame_len], notification->data, notification->length);
+		app.frame_len += notification->length;
+		frame_timestamps_us[frame_records++] = notification->timestamp_us;
+		notification_queue_pop(&app.notification_queue);
+	}
+}
+
+/**
+ * @brief Check if the frame has to be sent (frame full or flush timeout elapsed)
+ */
+static uint8_t is_frame_ready()
+{
+	if (app.frame_len == 0) return 0;
+	if (app.frame_full != 0) return 1;
+
+	uint32_t elapsed = hal_timer_get_uticks() - app.frame_start_us;
+	if (elapsed >= BLE_FRAME_FLUSH_TIMEOUT_US) return 1;
+
+	return 0;
+}
+
+/**
+ * @brief Prepare the next frame of the throughput test inside the frame buffer
+ * The pattern is only written again when the negotiated MTU changes
+ *
+ * @retval Length of the frame
+ */
+static uint16_t fill_test_frame()
+{
+	const uint16_t capacity = get_frame_capacity();
+
+	if (app.test_frame_len != capacity)
+	{
+		for(uint16_t i = BLE_TEST_FRAME_HEADER_SIZE; i < capacity; ++i)
+		{
+			app.frame[i] = (uint8_t) (i & 0xFF);
+		}
+		app.test_frame_len = capacity;
+	}
+
+	uint32_t now = hal_timer_get_uticks();
+	app.frame[0] = (uint8_t) (BLE_TEST_FRAME_ID & 0xFF);
+	app.frame[1] = (uint8_t) (BLE_TEST_FRAME_ID >> 8);
+	for(uint16_t i = 0; i < 4; ++i)
+	{
+		app.frame[2 + i] = (uint8_t) ((app.test_sequence >> (8 * i)) & 0xFF);
+		app.frame[6 + i] = (uint8_t) ((now >> (8 * i)) & 0xFF);
+	}
+
+	return capacity;
+}
+
+/**
+ * @brief Start a new credit window if the connection interval elapsed
+ */
+static void refresh_tx_credits()
+{
+	uint32_t now = hal_timer_get_uticks();
+	if ((now - app.conn_interval_start_us) < app.conn_interval_us) return;
+
+	app.packets_per_interval = app.packets_in_interval;
+	if (app.packets_per_interval > app.stats.packets_per_interval_max)
+		app.stats.packets_per_interval_max = app.packets_per_interval;
+
+	app.packets_in_interval = 0;
+	app.conn_interval_start_us = now;
+	app.tx_credits = BLE_TX_CREDITS_MAX;
+}
+
+/**
+ * @brief Hand a notification to the stack and consume a TX credit
+ *
+ * @retval 0 Success
+ * @retval -1 The stack could not accept the notification (no more credits until the next interval)
+ * @retval -2 The notification can never be sent, it has to be dropped
+ */
+static int send_with_credit(uint16_t len, uint8_t* content)
+{
+	if ((len == 0) || (len > get_frame_capacity())) return -2;
+
+	int retval = ble_port_notify(content, len);
+	if (retval == -2) return -2;
+	if (retval != 0)
+	{
+		if (stalled == 0) app.stats.gatt_busy_stalls++;
+		stalled = 1;
+		app.tx_credits = 0;
+		return -1;
+	}
+
+	app.tx_credits--;
+	app.packets_in_interval++;
+	add_sent_packet(len);
+	return 0;
+}
+
+static void reset_tx_credits(uint32_t conn_interval_us)
+{
+	app.tx_credits = BLE_TX_CREDITS_MAX;
+	app.conn_interval_us = conn_interval_us;
+	app.conn_interval_start_us = hal_timer_get_uticks();
+	app.packets_in_interval = 0;
+	app.packets_per_interval = 0;
+}
+
+enum commands {
+	CMD_GET_AVAILABLE_SENSORS = 0,
+	CMD_START_PUSH_MODE = 1,
+	CMD_STOP_PUSH_MODE = 2,
+	CMD_ENABLED_DISABLE_TMF8828_8x8_MODE = 3,
+	CMD_NTRIP_DATA = 4,
+	CMD_SET_SUBSCRIPTION_MASK = 5,
+	CMD_GET_STATS = 6,
+	CMD_START_THROUGHPUT_TEST = 7,
+	CMD_GET_PROFILE = 8,
+	CMD_GET_I2C_TRACE = 9,
+	CMD_GET_I2C_HEALTH = 10
+};
+
+/**
+ * @brief Prepare the ACK of the command being processed
+ * Commands received on the command characteristic are acknowledged with an ACK record carrying the request id
+ * An answer that does not fit inside one notification is split over several ones (see get_next_ack_part)
+ */
+static void set_ack(uint8_t* payload, uint8_t len)
+{
+	if ((len == 0) || (len > BLE_ACK_MAX_SIZE)) return;
+
+	memcpy(app.ack_content, payload, len);
+	app.ack_len = len;
+	app.ack_sent = 0;
+	app.ack_has_request_id = app.cmd.has_request_id;
+	app.ack_request_id = app.cmd.request_id;
+	app.ack_command = app.cmd.command;
+	app.ack_to_send = 1;
+}
+
+/**
+ * @brief Prepare the next notification of the ACK
+ * Each notification carries as much of the remaining answer as the MTU allows (inside an ACK record if the command
+ * has a request id), the client concatenates them
+ *
+ * @param [out] content Notification to send
+ * @param [out] part_len Bytes of the answer carried by the notification
+ *
+ * @retval Length of the notification (0 if it cannot be encoded)
+ */
+static uint16_t get_next_ack_part(uint8_t** content, uint16_t* part_len)
+{
+	const uint16_t capacity = get_frame_capacity();
+	uint16_t remaining = app.ack_len - app.ack_sent;
+
+	if (app.ack_has_request_id == 0)
+	{
+		*part_len = (remaining > capacity) ? capacity : remaining;
+		*content = &app.ack_content[app.ack_sent];
+		return *part_len;
+	}
+
+	*part_len = capacity - ACK_RECORD_OVERHEAD;
+	if (*part_len > remaining) *part_len = remaining;
+	*content = ack_part;
+	return notification_fabric_encode_ack(ack_part, sizeof(ack_part), app.ack_request_id, app.ack_command,
+			&app.ack_content[app.ack_sent], (uint8_t) *part_len);
+}
+
+/**
+ * @brief Acknowledge a command without specific answer (payload is command + 1)
+ */
+static void set_ack_done()
+{
+	uint8_t done = app.cmd.command + 1;
+	set_ack(&done, 1);
+}
+
+/**
+ * @brief Answer a command that cannot be executed (payload is BLE_ACK_ERROR)
+ */
+static void set_ack_error()
+{
+	uint8_t error = BLE_ACK_ERROR;
+	set_ack(&error, 1);
+}
+
+/**
+ * @brief Read the oldest received command inside app.cmd
+ *
+ * @retval 1 A command is available
+ * @retval 0 No command to process
+ */
+static uint8_t read_next_command()
+{
+	static uint8_t entry[CMD_ENTRY_MAX_SIZE];
+
+	for(;;)
+	{
+		uint16_t entry_len = command_queue_pop(&app.cmd_queue, entry, CMD_ENTRY_MAX_SIZE);
+		if (entry_len == 0) return 0;
+		if (entry_len > CMD_ENTRY_MAX_SIZE) entry_len = CMD_ENTRY_MAX_SIZE;
+
+		// Header (source) + command at least
+		uint16_t index = 1;
+		if (entry[0] == BLE_CMD_SOURCE_CMD_CHAR)
+		{
+			if (entry_len < 3) continue;
+			app.cmd.has_request_id = 1;
+			app.cmd.request_id = entry[index++];
+		}
+		else
+		{
+			if (entry_len < 2) continue;
+			app.cmd.has_request_id = 0;
+		}
+
+		app.cmd.command = entry[index++];
+		app.cmd.len = entry_len - index + 1;
+		memcpy(app.cmd.parameters, &entry[index], entry_len - index);
+		return 1;
+	}
+}
+
+static uint16_t write_u32(uint8_t* buffer, uint16_t index, uint32_t value)
+{
+	buffer[index++] = (uint8_t) (value & 0xFF);
+	buffer[index++] = (uint8_t) ((value >> 8) & 0xFF);
+	buffer[index++] = (uint8_t) ((value >> 16) & 0xFF);
+	buffer[index++] = (uint8_t) ((value >> 24) & 0xFF);
+	return index;
+}
+
+/**
+ * @brief Encode the statistics as answer of CMD_GET_STATS (uint32, little endian)
+ * enqueued, sent, packets sent, dropped (queue full), dropped (not in push mode), dropped (too long), dropped (no buffer),
+ * GATT busy stalls, bytes sent, bytes per second, queue high water, packets per interval max, latency histogram,
+ * then the low power statistics of the main loop: sleep time (ms), sleeps, deep sleeps, wake-ups, late wake-ups,
+ * maximum and average wake-up latency (us)
+ *
+ * @retval Length of the encoded statistics
+ */
+static uint16_t encode_stats(uint8_t* buffer)
+{
+	uint16_t index = 0;
+	index = write_u32(buffer, index, app.stats.enqueued);
+	index = write_u32(buffer, index, app.stats.sent);
+	index = write_u32(buffer, index, app.stats.packets_sent);
+	index = write_u32(buffer, index, app.stats.dropped_queue_full);
+	index = write_u32(buffer, index, app.stats.dropped_not_push);
+	index = write_u32(buffer, index, app.stats.dropped_too_long);
+	index = write_u32(buffer, index, app.stats.dropped_no_buffer);
+	index = write_u32(buffer, index, app.stats.gatt_busy_stalls);
+	index = write_u32(buffer, index, app.stats.bytes_sent);
+	index = write_u32(buffer, index, app.stats.bytes_per_second);
+	index = write_u32(buffer, index, app.stats.queue_high_water);
+	index = write_u32(buffer, index, app.stats.packets_per_interval_max);
+	for(uint16_t i = 0; i < BLE_STATS_LATENCY_BUCKETS; ++i)
+	{
+		index = write_u32(buffer, index, app.stats.latency_histogram[i]);
+	}
+
+	const hal_lowpower_stats_t* lowpower = hal_lowpower_get_stats();
+	index = write_u32(buffer, index, lowpower->sleep_time_ms);
+	index = write_u32(buffer, index, lowpower->sleeps);
+	index = write_u32(buffer, index, lowpower->deep_sleeps);
+	index = write_u32(buffer, index, lowpower->wakeups);
+	index = write_u32(buffer, index, lowpower->late_wakeups);
+	index = write_u32(buffer, index, lowpower->latency_max_us);
+	index = write_u32(buffer, index, lowpower->latency_avg_us);
+	return index;
+}
+
+#ifdef PROFILER_SUPPORT
+/**
+ * Size of the answer of CMD_GET_PROFILE (4 values + histogram, uint32 each)
+ */
+#define PROFILE_ENCODED_SIZE	((4 + PROFILER_HISTOGRAM_BUCKETS) * 4)
+
+/**
+ * @brief Encode the counters of the main loop: missed ticks, tick overruns
+ */
+static uint16_t encode_profile_summary(uint8_t* buffer)
+{
+	uint16_t index = 0;
+	index = write_u32(buffer, index, profiler_get_missed_ticks());
+	index = write_u32(buffer, index, profiler_get_tick_overruns());
+	return index;
+}
+
+/**
+ * @brief Encode the statistics of one section: count, min, average, max (us), log2 histogram
+ *
+ * @retval 0 Section not used
+ */
+static uint16_t encode_profile_section(uint8_t* buffer, uint16_t section)
+{
+	const profiler_section_t* stats = profiler_get_section(section);
+	if (stats == NULL) return 0;
+
+	uint32_t average = (stats->count != 0) ? (uint32_t) (stats->total_us / stats->count) : 0;
+
+	uint16_t index = 0;
+	index = write_u32(buffer, index, stats->count);
+	index = write_u32(buffer, index, stats->min_us);
+	index = write_u32(buffer, index, average);
+	index = write_u32(buffer, index, stats->max_us);
+	for(uint16_t i = 0; i < PROFILER_HISTOGRAM_BUCKETS; ++i)
+	{
+		index = write_u32(buffer, index, stats->histogram[i]);
+	}
+	return index;
+}
+#endif
+
+/**
+ * Size of the answer of CMD_GET_I2C_HEALTH for one address (2 uint8, 1 uint32, 4 uint16)
+ * Fits inside one ACK record at the smallest MTU (20 bytes)
+ */
+#define I2C_HEALTH_ENCODED_SIZE	(2 + 4 + 4 * 2)
 
-			case CMD_STOP_PUSH_MODE:
-				app.ack_to_send = 1;
-				app.ack_len = 1;
-				app.ack_content[0] = app.cmd.command + 1;
-				DEBUG_BLE_LOGIC("Activate configuration mode \r\n");
-				app.mode = BLE_MODE_CONFIGURATION;
+/**
+ * @brief Write a counter as uint16 (little endian), saturated at 0xFFFF
+ */
+static uint16_t write_u16_saturated(uint8_t* buffer, uint16_t index, uint32_t value)
+{
+	if (value > 0xFFFF) value = 0xFFFF;
+	buffer[index++] = (uint8_t) (value & 0xFF);
+	buffer[index++] = (uint8_t) ((value >> 8) & 0xFF);
+	return index;
+}
+
+/**
+ * @brief Encode the counters of one I2C address: state, failures in a row (uint8), transfers (uint32),
+ * failures, timeouts, rejected, trips (uint16, saturated)
+ *
+ * @retval 0 Nothing sent to the address yet
+ */
+static uint16_t encode_i2c_health(uint8_t* buffer, uint8_t address)
+{
+	const hal_i2c_device_stats_t* device = hal_i2c_breaker_get_device(address);
+	if (device == NULL) return 0;
+
+	uint16_t index = 0;
+	buffer[index++] = device->state;
+	buffer[index++] = device->consecutive_failures;
+	index = write_u32(buffer, index, device->transfers);
+	index = write_u16_saturated(buffer, index, device->failures);
+	index = write_u16_saturated(buffer, index, device->timeouts);
+	index = write_u16_saturated(buffer, index, device->rejected);
+	index = write_u16_saturated(buffer, index, device->trips);
+	return index;
+}
+
+#ifdef I2C_TRACE_SUPPORT
+/**
+ * @brief Print one line of the I2C trace on the debug UART
+ */
+static void print_i2c_trace_line(const char* line)
+{
+	printf("%s\r\n", line);
+}
+#endif
+
+const ble_stats_t* host_main_get_stats()
+{
+	return &app.stats;
+}
+
+void host_main_print_stats()
+{
+	printf("BLE stats: enqueued %lu, sent %lu (%lu packets), dropped full %lu, not push %lu, too long %lu, no buffer %lu \r\n",
+			(unsigned long) app.stats.enqueued, (unsigned long) app.stats.sent, (unsigned long) app.stats.packets_sent,
+			(unsigned long) app.stats.dropped_queue_full, (unsigned long) app.stats.dropped_not_push,
+			(unsigned long) app.stats.dropped_too_long, (unsigned long) app.stats.dropped_no_buffer);
+	printf("BLE stats: %lu B/s, %lu bytes, busy stalls %lu, queue high water %u, packets/interval max %u \r\n",
+			(unsigned long) app.stats.bytes_per_second, (unsigned long) app.stats.bytes_sent,
+			(unsigned long) app.stats.gatt_busy_stalls, app.stats.queue_high_water, app.stats.packets_per_interval_max);
+	printf("BLE stats: latency <=5ms %lu, <=10ms %lu, <=20ms %lu, <=50ms %lu, <=100ms %lu, <=200ms %lu, <=500ms %lu, >500ms %lu \r\n",
+			(unsigned long) app.stats.latency_histogram[0], (unsigned long) app.stats.latency_histogram[1],
+			(unsigned long) app.stats.latency_histogram[2], (unsigned long) app.stats.latency_histogram[3],
+			(unsigned long) app.stats.latency_histogram[4], (unsigned long) app.stats.latency_histogram[5],
+			(unsigned long) app.stats.latency_histogram[6], (unsigned long) app.stats.latency_histogram[7]);
+
+	const hal_lowpower_stats_t* lowpower = hal_lowpower_get_stats();
+	printf("Low power: slept %lu ms (%lu sleeps, %lu deep sleeps), wake-ups %lu, late %lu, latency max %lu us, avg %lu us \r\n",
+			(unsigned long) lowpower->sleep_time_ms, (unsigned long) lowpower->sleeps, (unsigned long) lowpower->deep_sleeps,
+			(unsigned long) lowpower->wakeups, (unsigned long) lowpower->late_wakeups,
+			(unsigned long) lowpower->latency_max_us, (unsigned long) lowpower->latency_avg_us);
+}
+
+static void process_command()
+{
+	DEBUG_BLE_LOGIC("Command is : %d \r\n", app.cmd.command);
+
+	enum commands command = (enum commands) app.cmd.command;
+	switch(command)
+	{
+		case CMD_GET_AVAILABLE_SENSORS:
+		{
+			uint32_t sensor_mask = rutronik_application_get_available_sensors_mask(app.rutronik_app);
+			set_ack((uint8_t*) &sensor_mask, sizeof(sensor_mask));
+			DEBUG_BLE_LOGIC("Sensor mask: %lu \r\n", sensor_mask);
+			break;
+		}
+
+		case CMD_START_PUSH_MODE:
+			set_ack_done();
+			DEBUG_BLE_LOGIC("Activate push mode \r\n");
+			app.mode = BLE_MODE_PUSH_DATA;
+			break;
+
+		case CMD_STOP_PUSH_MODE:
+			set_ack_done();
+			DEBUG_BLE_LOGIC("Activate configuration mode \r\n");
+			app.mode = BLE_MODE_CONFIGURATION;
+			reset_frame();
+			app.test_frame_len = 0;
+			break;
+
+		case CMD_START_THROUGHPUT_TEST:
+			// Stopped using CMD_STOP_PUSH_MODE. Statistics are reset to measure the test only
+			set_ack_done();
+			DEBUG_BLE_LOGIC("Activate throughput test mode \r\n");
+			app.mode = BLE_MODE_THROUGHPUT_TEST;
+			notification_queue_clear(&app.notification_queue);
+			reset_frame();
+			reset_stats();
+			app.test_sequence = 0;
+			app.test_frame_len = 0;
+			break;
+
+		case CMD_ENABLED_DISABLE_TMF8828_8x8_MODE:
+			// Parameter: uint8, mode of the TMF8828
+			if (app.cmd.len < 2)
+			{
+				DEBUG_BLE_LOGIC("CMD_ENABLED_DISABLE_TMF8828_8x8_MODE invalid len: %u \r\n", app.cmd.len);
+				set_ack_error();
 				break;
+			}
 
-			case CMD_ENABLED_DISABLE_TMF8828_8x8_MODE:
-				DEBUG_BLE_LOGIC("CMD_ENABLED_DISABLE_TMF8828_8x8_MODE param: %u \r\n", app.cmd.parameters[0]);
+			DEBUG_BLE_LOGIC("CMD_ENABLED_DISABLE_TMF8828_8x8_MODE param: %u \r\n", app.cmd.parameters[0]);
 #ifdef AMS_TMF_SUPPORT
-				// Set 3x3 mode
-				rutronik_application_set_tmf8828_mode(app.rutronik_app, app.cmd.parameters[0]);
+			// Set 3x3 mode
+			rutronik_application_set_tmf8828_mode(app.rutronik_app, app.cmd.parameters[0]);
+			set_ack_done();
+#else
+			set_ack_error();
 #endif
-				break;
+			break;
 
-			case CMD_NTRIP_DATA:
-				DEBUG_BLE_LOGIC("CMD_NTRIP_DATA len: %u \r\n", app.cmd.len);
+		case CMD_NTRIP_DATA:
+			DEBUG_BLE_LOGIC("CMD_NTRIP_DATA len: %u \r\n", app.cmd.len);
 #ifdef UM980_SUPPORT
-				// TODO: do not directly push? -> Make it in another file?
-				// Remark: do not send the ACK (App is in push mode configuration)
-				// In the future, use another characteristic for configuration?
-				{
-					uint16_t index = 0;
-					uint16_t count = app.cmd.len - 1;
-					while(count > 0)
-					{
-						size_t tosend_uart = count;
-						int written = hal_uart_write(&app.cmd.parameters[index], tosend_uart);
-						if (written < 0 )
-						{
-							DEBUG_BLE_LOGIC("UM980 ntrip write error %d \r\n", written);
-							break;
-						}
-						count -= written;
-						index += written;
-					}
-				}
+			// Remark: do not send the ACK (App is in push mode configuration)
+			// Frames are reassembled across writes and sent to the UM980 in the background
+			rtcm_reassembler_push(app.cmd.parameters, app.cmd.len - 1);
+#endif
+			break;
+
+		case CMD_GET_STATS:
+		{
+			// Parameter (optional): 1 to reset the statistics once read
+			uint8_t stats[BLE_STATS_ENCODED_SIZE];
+			uint16_t len = encode_stats(stats);
+			set_ack(stats, (uint8_t) len);
+			host_main_print_stats();
+
+			if ((app.cmd.len > 1) && (app.cmd.parameters[0] == 1)) reset_stats();
+			break;
+		}
+
+		case CMD_GET_PROFILE:
+		{
+			// Parameter (optional): section index to get its statistics, 0xFF to reset all the statistics
+			// Without parameter, all the sections are printed on the debug UART
+#ifdef PROFILER_SUPPORT
+			uint8_t profile[PROFILE_ENCODED_SIZE];
+			uint16_t len = 0;
+			if (app.cmd.len < 2)
+			{
+				profiler_print();
+				len = encode_profile_summary(profile);
+			}
+			else if (app.cmd.parameters[0] == 0xFF)
+			{
+				profiler_reset();
+				len = encode_profile_summary(profile);
+			}
+			else
+			{
+				len = encode_profile_section(profile, app.cmd.parameters[0]);
+			}
+
+			if (len > 0) set_ack(profile, (uint8_t) len);
+			else set_ack_done();
+#else
+			set_ack_done();
+#endif
+			break;
+		}
+
+		case CMD_GET_I2C_HEALTH:
+		{
+			// Parameter (optional): I2C address to get its counters, 0xFF to reset all the counters
+			// Without parameter, the counters of every address are printed on the debug UART
+			uint8_t health[I2C_HEALTH_ENCODED_SIZE];
+			uint16_t len = 0;
+			if ((app.cmd.len < 2) || (app.cmd.parameters[0] == 0xFF))
+			{
+				if (app.cmd.len < 2) hal_i2c_breaker_print();
+				else hal_i2c_breaker_reset();
+
+				len = write_u32(health, len, hal_i2c_breaker_get_open_count());
+				len = write_u32(health, len, hal_i2c_breaker_get_recoveries());
+			}
+			else
+			{
+				len = encode_i2c_health(health, app.cmd.parameters[0]);
+			}
+
+			if (len > 0) set_ack(health, (uint8_t) len);
+			else set_ack_done();
+			break;
+		}
+
+		case CMD_GET_I2C_TRACE:
+		{
+			// Parameter (optional): 0xFF to clear the trace
+			// Without parameter, the trace is printed on the debug UART
+#ifdef I2C_TRACE_SUPPORT
+			uint8_t trace_stats[8];
+			uint16_t len = 0;
+			len = write_u32(trace_stats, len, hal_i2c_trace_get_records());
+			len = write_u32(trace_stats, len, hal_i2c_trace_get_dropped());
+
+			if ((app.cmd.len > 1) && (app.cmd.parameters[0] == 0xFF)) hal_i2c_trace_clear();
+			else hal_i2c_trace_dump(print_i2c_trace_line);
+
+			set_ack(trace_stats, (uint8_t) len);
+#else
+			set_ack_done();
 #endif
+			break;
+		}
+
+		case CMD_SET_SUBSCRIPTION_MASK:
+			// Parameter: uint32 (little endian), bit n enables the stream of sensor id n
+			if (app.cmd.len < 5)
+			{
+				DEBUG_BLE_LOGIC("CMD_SET_SUBSCRIPTION_MASK invalid len: %u \r\n", app.cmd.len);
+				set_ack_error();
 				break;
+			}
+			app.subscription_mask = ((uint32_t) app.cmd.parameters[0])
+					| (((uint32_t) app.cmd.parameters[1]) << 8)
+					| (((uint32_t) app.cmd.parameters[2]) << 16)
+					| (((uint32_t) app.cmd.parameters[3]) << 24);
+			set_ack_done();
+			DEBUG_BLE_LOGIC("Subscription mask: %lx \r\n", (unsigned long) app.subscription_mask);
+			break;
 
-			default:
-				DEBUG_BLE_LOGIC("Unknown command: %d \r\n", app.cmd.command);
+		default:
+			DEBUG_BLE_LOGIC("Unknown command: %d \r\n", app.cmd.command);
 
-    	}
+	}
+}
 
-    	app.cmd_to_process = 0;
+int host_main_do()
+{
+    PROFILER_BEGIN(host_start);
+
+    // Let the BLE stack process its pending events
+    PROFILER_BEGIN(ble_start);
+    ble_port_process_events();
+    PROFILER_END(PROFILER_SECTION_BLE_EVENTS, ble_start);
+
+    // Process the received commands (one ACK slot: wait until the previous ACK is sent)
+    while((app.ack_to_send == 0) && (read_next_command() != 0))
+    {
+    	process_command();
     }
 
 
     if(app.notification_enabled != 0)
     {
-    	if(Cy_BLE_GATT_GetBusyStatus(appConnHandle.attId) == CY_BLE_STACK_STATE_FREE)
+    	refresh_tx_credits();
+
+    	// Send as long as the stack accepts data and credits are available
+    	while((app.tx_credits > 0) && (ble_port_is_free() != 0))
     	{
     		// Any acknowledge to be sent?
     		if (app.ack_to_send != 0)
     		{
     			DEBUG_BLE_LOGIC("Send ack: %d \r\n", app.ack_content[0]);
 
-    			SendAnswerNotification(app.ack_len, app.ack_content);
-    			app.ack_to_send = 0;
+    			uint8_t* content = NULL;
+    			uint16_t part_len = 0;
+    			uint16_t len = get_next_ack_part(&content, &part_len);
+    			int retval = send_with_credit(len, content);
+    			if (retval == -1) break;
+    			if (retval == -2)
+    			{
+    				DEBUG_BLE_LOGIC("ACK cannot be sent, dropped: %u \r\n", app.ack_len);
+    				app.stats.dropped_too_long++;
+    				app.ack_to_send = 0;
+    				continue;
+    			}
+
+    			app.ack_sent += part_len;
+    			if (app.ack_sent >= app.ack_len) app.ack_to_send = 0;
+    			continue;
+    		}
+
+    		// Boards came online
+    		if (app.sensors_to_send != 0)
+    		{
+    			int retval = send_with_credit(app.sensors_len, app.sensors_content);
+    			if (retval == -1) break;
+    			if (retval == -2) app.stats.dropped_too_long++;
+    			app.sensors_to_send = 0;
+    			continue;
+    		}
+
+    		// Throughput test: fill every notification, as long as the stack accepts them
+    		if (app.mode == BLE_MODE_THROUGHPUT_TEST)
+    		{
+    			uint16_t len = fill_test_frame();
+    			if (send_with_credit(len, app.frame) != 0) break;
+    			app.test_sequence++;
+    			continue;
     		}
 
     		// Push mode?
-    		if (app.mode == BLE_MODE_PUSH_DATA)
+    		if (app.mode != BLE_MODE_PUSH_DATA) break;
+
+    		// Pack the oldest records inside one notification
+    		fill_frame();
+    		if (!is_frame_ready()) break;
+
+    		int retval = send_with_credit(app.frame_len, app.frame);
+    		if (retval == -1) break;
+    		if (retval == -2) app.stats.dropped_too_long += frame_records;
+    		else add_sent_frame();
+    		reset_frame();
+    	}
+
+    	// Data waiting but the stack cannot accept it
+    	if (ble_port_is_free() == 0)
+    	{
+    		if ((stalled == 0) && ((app.ack_to_send != 0) || (app.sensors_to_send != 0) || (app.frame_len > 0)
+    				|| (notification_queue_get_count(&app.notification_queue) > 0)))
     		{
-    			// Something inside the list
-    			if (app.notification_list.element_count > 0)
-    			{
-    				notification_t* notification = (notification_t*)app.notification_list.last->content;
-    				SendAnswerNotification(notification->length, notification->data);
-    				linked_list_remove_last_element(&app.notification_list);
-    			}
+    			app.stats.gatt_busy_stalls++;
+    			stalled = 1;
     		}
     	}
+    	else
+    	{
+    		stalled = 0;
+    	}
     }
 
+    update_rate();
+
+    PROFILER_END(PROFILER_SECTION_HOST_MAIN, host_start);
 	return 0;
 }
 
+/**
+ * @brief Get the time remaining before a hal_timer based timeout elapses
+ */
+static uint32_t get_remaining_us(uint32_t start_us, uint32_t timeout_us)
+{
+	uint32_t elapsed = hal_timer_get_uticks() - start_us;
+	return (elapsed < timeout_us) ? (timeout_us - elapsed) : 0;
+}
+
+uint32_t host_main_get_idle_time_us()
+{
+	if (ble_port_has_pending_events() != 0) return 0;
+
+	// Commands can be processed as soon as the ACK slot is free
+	if ((app.ack_to_send == 0) && (command_queue_get_used(&app.cmd_queue) > 0)) return 0;
+
+	if (app.notification_enabled == 0) return HOST_MAIN_IDLE_FOREVER;
+
+	uint8_t has_data = (app.ack_to_send != 0) || (app.sensors_to_send != 0) || (app.mode == BLE_MODE_THROUGHPUT_TEST) || (app.frame_len > 0)
+			|| (notification_queue_get_count(&app.notification_queue) > 0);
+	if (has_data == 0) return HOST_MAIN_IDLE_FOREVER;
+
+	// The stack reports when its buffers are flushed
+	if (ble_port_is_free() == 0) return HOST_MAIN_IDLE_FOREVER;
+
+	if (app.tx_credits == 0) return get_remaining_us(app.conn_interval_start_us, app.conn_interval_us);
+
+	if ((app.ack_to_send != 0) || (app.sensors_to_send != 0) || (app.mode == BLE_MODE_THROUGHPUT_TEST)) return 0;
+	if ((notification_queue_get_count(&app.notification_queue) > 0) || (app.frame_full != 0)) return 0;
+
+	// Partial frame waiting for more records
+	return get_remaining_us(app.frame_start_us, BLE_FRAME_FLUSH_TIMEOUT_US);
+}
+
 /*******************************************************************************
 * Function Name: Ble_Init()
 ********************************************************************************
@@ -303,539 +999,112 @@ int host_main_do()
 *
 *******************************************************************************/
 
-static void free_notification(void* notification)
-{
-	notification_t* casted = (notification_t*) notification;
-	notification_fabric_free_notification(casted);
-}
-
 static void init_app()
 {
 	app.notification_enabled = 0;
-	app.cmd_to_process = 0;
+	app.mtu = BLE_PORT_DEFAULT_MTU;
+	command_queue_init(&app.cmd_queue);
+	app.cmd_dropped = 0;
 	app.mode = BLE_MODE_CONFIGURATION;
+	app.subscription_mask = BLE_SUBSCRIPTION_ALL;
 	app.ack_to_send = 0;
+	app.sensors_to_send = 0;
 	app.notification_to_send = 0;
 
-	linked_list_init(&app.notification_list, free_notification);
+	notification_queue_init(&app.notification_queue);
+	reset_frame();
+
+	reset_stats();
+	app.test_sequence = 0;
+	app.test_frame_len = 0;
+	reset_tx_credits(BLE_DEFAULT_CONN_INTERVAL_US);
 }
 
 void Ble_Init(rutronik_application_t* rutronik_app)
 {
-    cy_en_ble_api_result_t apiResult;
-    cy_stc_ble_stack_lib_version_t stackVersion;
-
     DEBUG_BLE_LOGIC("RDK3 BLE Throughput Measurement\r\n");
     DEBUG_BLE_LOGIC("Role : Server\r\n");
 
 	init_app();
 	app.rutronik_app = rutronik_app;
 
-	notificationPacket.handleValPair.value.val = notification_buffer;
-	notificationPacket.handleValPair.value.len = NOTIFICATION_PKT_SIZE;
+	// Used for the flush timeout of the frames
+	hal_timer_init();
 
-    /* Initialize the BLESS interrupt */
-    cy_ble_config.hw->blessIsrConfig = &blessIsrCfg;
-    Cy_SysInt_Init(cy_ble_config.hw->blessIsrConfig, BlessInterrupt);
+#ifdef UM980_SUPPORT
+	rtcm_reassembler_init(hal_uart_write_async);
+#endif
 
-    /* Register the generic event handler */
-    Cy_BLE_RegisterEventCallback(StackEventHandler);
+	ble_port_init();
+    
+}
 
-    /* Initialize the BLE */
-    Cy_BLE_Init(&cy_ble_config);
+int host_main_on_write(uint8_t characteristic, uint8_t* data, uint16_t len)
+{
+	if (len == 0)
+	{
+		DEBUG_BLE_LOGIC("Not a valid command. Length is 0 ... \r\n");
+		return -1;
+	}
 
-    /* Enable BLE */
-    Cy_BLE_Enable();
+	uint8_t source = (characteristic == BLE_PORT_CHAR_CMD) ? BLE_CMD_SOURCE_CMD_CHAR : BLE_CMD_SOURCE_DATA_CHAR;
+	if (command_queue_push(&app.cmd_queue, source, data, len) != 0)
+	{
+		DEBUG_BLE_LOGIC("Command queue full, command dropped \r\n");
+		app.cmd_dropped++;
+		return -2;
+	}
 
-    /* Register the IAS CallBack */
-    Cy_BLE_IAS_RegisterAttrCallback(IasEventHandler);
-    
-    apiResult = Cy_BLE_GetStackLibraryVersion(&stackVersion);
-    
-    if(apiResult != CY_BLE_SUCCESS)
-    {
-        DEBUG_BLE("Cy_BLE_GetStackLibraryVersion API Error: 0x%2.2x \r\n",apiResult);
-    }
-    else
-    {
-        DEBUG_BLE("Stack Version: %d.%d.%d.%d \r\n", stackVersion.majorVersion, 
-        stackVersion.minorVersion, stackVersion.patch, stackVersion.buildNumber);
-    }
-    
+	return 0;
 }
 
-/*******************************************************************************
-* Function Name: StackEventHandler()
-********************************************************************************
-*
-* Summary:
-*   This is an event callback function to receive events from the BLE Component.
-*
-*  event - the event code
-*  *eventParam - the event parameters
-*
-* Return:
-*   None
-*
-*******************************************************************************/
-void StackEventHandler(uint32 event, void* eventParam)
+void host_main_on_connected(uint32_t conn_interval_us)
 {
-    cy_en_ble_api_result_t apiResult;
-
-    switch(event)
-    {
-         /* There are some events generated by the BLE component
-        *  that are not required for this code example. */
-        
-        /**********************************************************
-        *                       General Events
-        ***********************************************************/
-        /* This event is received when the BLE component is Started */
-        case CY_BLE_EVT_STACK_ON:
-        {
-            DEBUG_BLE("CY_BLE_EVT_STACK_ON, Start Advertisement \r\n");
-            /* Enter into discoverable mode so that remote device can search it */
-            Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST, CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
-            
-            break;
-        }    
-        /* This event is received when there is a timeout. */
-        case CY_BLE_EVT_TIMEOUT:
-        {
-			DEBUG_BLE("CY_BLE_EVT_TIMEOUT \r\n"); 
-            
-            break;
-		}   
-        /* This event indicates that some internal HW error has occurred. */    
-		case CY_BLE_EVT_HARDWARE_ERROR:    
-        {
-			DEBUG_BLE("Hardware Error \r\n");
-            
-			break;
-		}   
-        /*  This event will be triggered by host stack if BLE stack is busy or 
-         *  not busy. Parameter corresponding to this event will be the state 
-    	 *  of BLE stack.
-         *  BLE stack busy = CY_BLE_STACK_STATE_BUSY,
-    	 *  BLE stack not busy = CY_BLE_STACK_STATE_FREE 
-         */
-    	case CY_BLE_EVT_STACK_BUSY_STATUS:
-        {
-			DEBUG_BLE("CY_BLE_EVT_STACK_BUSY_STATUS: %x\r\n", *(uint8 *)eventParam);
-            
-			break;
-		}
-        /* This event indicates completion of Set LE event mask. */
-        case CY_BLE_EVT_LE_SET_EVENT_MASK_COMPLETE:
-        {
-			DEBUG_BLE("CY_BLE_EVT_LE_SET_EVENT_MASK_COMPLETE \r\n");
-            
-            break;
-		}            
-        /* This event indicates set device address command completed. */
-        case CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE:
-        {
-            DEBUG_BLE("CY_BLE_EVT_SET_DEVICE_ADDR_COMPLETE \r\n");
-            
-            cy_stc_ble_events_param_generic_t *param = \
-			(cy_stc_ble_events_param_generic_t *) eventParam;
-        
-            if( param->status != SUCCESS)
-            {
-                DEBUG_BLE("Failed to Set Local BDAddress [Status 0x%02X]\r\n",\
-                    param->status);
-               
-            }
-            else
-            {
-                DEBUG_BLE("Local Address Set successfully \r\n");
-                DEBUG_BLE("BdAddress set to: %02X:%02X:%02X:%02X:%02X:%02X \r\n",\
-                    local_addr.bdAddr[5],local_addr.bdAddr[4], local_addr.bdAddr[3],\
-                    local_addr.bdAddr[2], local_addr.bdAddr[1], local_addr.bdAddr[0]);  
-                          
-                Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST,\
-				CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
-            }
-            
-            break;
-        }
-            
-        /* This event indicates get device address command completed
-           successfully */
-        case CY_BLE_EVT_GET_DEVICE_ADDR_COMPLETE:
-        {
-			DEBUG_BLE("CY_BLE_EVT_GET_DEVICE_ADDR_COMPLETE: ");
-            DEBUG_BLE("\n\rAdvertising with Address: ");
-            for(uint8_t i = CY_BLE_GAP_BD_ADDR_SIZE; i > 0u; i--)
-            {
-                DEBUG_BLE("%2.2X ", ((cy_stc_ble_bd_addrs_t *)\
-				((cy_stc_ble_events_param_generic_t *)eventParam)->eventParams)\
-				  ->publicBdAddr[i-1]);
-            }
-            DEBUG_BLE("\r\n");
-            
-            break;
-		}
-        /* This event indicates set Tx Power command completed. */
-        case CY_BLE_EVT_SET_TX_PWR_COMPLETE:
-        {
-			DEBUG_BLE("CY_BLE_EVT_SET_TX_PWR_COMPLETE \r\n");
-            
-            break;
-		}                       
-            
-        /**********************************************************
-        *                       GAP Events
-        ***********************************************************/
-       
-        /* This event indicates peripheral device has started/stopped
-           advertising. */
-        case CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP:
-        {
-            DEBUG_BLE("CY_BLE_EVT_GAPP_ADVERTISEMENT_START_STOP: ");
-            if(Cy_BLE_GetConnectionState(appConnHandle) == CY_BLE_CONN_STATE_DISCONNECTED)
-            {
-                DEBUG_BLE(" <Restart ADV> \r\n");
-                DEBUG_BLE_LOGIC("Advertising...\r\n\n");
-                Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST,\
-                               				   CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
-                app.notification_enabled = 0;
-                app.mode = BLE_MODE_CONFIGURATION;
-            }
-           
-            break;
-        }
-            
-        /* This event is triggered instead of 'CY_BLE_EVT_GAP_DEVICE_CONNECTED', 
-        if Link Layer Privacy is enabled in component customizer. */
-        case CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE:
-        {
-            /* BLE link is established */
-            /* This event will be triggered since link layer privacy is enabled */
-            DEBUG_BLE("CY_BLE_EVT_GAP_ENHANCE_CONN_COMPLETE \r\n");
-            
-#if (DEBUG_BLE_ENABLE || DEBUG_BLE_LOGIC_ENABLE)
-            cy_stc_ble_gap_enhance_conn_complete_param_t *param = \
-            (cy_stc_ble_gap_enhance_conn_complete_param_t *)eventParam;
-            
-            DEBUG_BLE_LOGIC("Connected to Device ");
-
-			DEBUG_BLE_LOGIC("%02X:%02X:%02X:%02X:%02X:%02X\r\n\n",param->peerBdAddr[5],\
-					param->peerBdAddr[4], param->peerBdAddr[3], param->peerBdAddr[2],\
-					param->peerBdAddr[1], param->peerBdAddr[0]);
-
-			DEBUG_BLE("\r\nBDhandle : 0x%02X\r\n", param->bdHandle);
-#endif
-            cyhal_gpio_write((cyhal_gpio_t)LED2, CYBSP_LED_STATE_ON);
-            break;
-        }
-        
-        /* This event is triggered when there is a change to either the maximum Payload 
-        length or the maximum transmission time of Data Channel PDUs in either direction */
-        case CY_BLE_EVT_DATA_LENGTH_CHANGE:
-        {
-            DEBUG_BLE("CY_BLE_EVT_DATA_LENGTH_CHANGE \r\n");
-            cy_stc_ble_set_phy_info_t phyParam;
-            
-            /* Configure the BLE Component for 2Mbps data rate */
-            phyParam.bdHandle = appConnHandle.bdHandle;
-            phyParam.allPhyMask = CY_BLE_PHY_NO_PREF_MASK_NONE;
-            phyParam.phyOption = 0;
-			// Set to 1M (bug with iPhone 16 when set to 2M)
-            phyParam.rxPhyMask = CY_BLE_PHY_MASK_LE_1M;
-            phyParam.txPhyMask = CY_BLE_PHY_MASK_LE_1M;
-            
-            Cy_BLE_EnablePhyUpdateFeature();
-            apiResult = Cy_BLE_SetPhy(&phyParam);
-            if(apiResult != CY_BLE_SUCCESS)
-            {
-                DEBUG_BLE("Failed to set PHY..[bdHandle 0x%02X] : 0x%4x\r\n",
-                    phyParam.bdHandle, apiResult);
-            }
-            else
-            {
-                DEBUG_BLE("Setting PHY.[bdHandle 0x%02X] \r\n", phyParam.bdHandle);
-            }
-            
-            break;
-        }
-        
-        /* This event is generated at the GAP Peripheral end after connection 
-           is completed with peer Central device. */
-        case CY_BLE_EVT_GAP_DEVICE_CONNECTED: 
-		{
-			DEBUG_BLE("CY_BLE_EVT_GAP_DEVICE_CONNECTED \r\n");
-			app.notification_enabled = 0;
-                      
-            break;
-		}            
-        /* This event is generated when disconnected from remote device or 
-           failed to establish connection. */
-        case CY_BLE_EVT_GAP_DEVICE_DISCONNECTED:   
-		{
-			if(Cy_BLE_GetConnectionState(appConnHandle) == CY_BLE_CONN_STATE_DISCONNECTED)
-            {
-                DEBUG_BLE("CY_BLE_EVT_GAP_DEVICE_DISCONNECTED %d\r\n",\
-                    CY_BLE_CONN_STATE_DISCONNECTED);
-            }
-            
-            /* Device disconnected; restart advertisement */
-            negotiatedMtu = DEFAULT_MTU_SIZE;
-            Cy_BLE_GAPP_StartAdvertisement(CY_BLE_ADVERTISING_FAST,\
-                CY_BLE_PERIPHERAL_CONFIGURATION_0_INDEX);
-            
-            break;
-		}            
-        /* This event is generated at the GAP Central and the peripheral end 
-           after connection parameter update is requested from the host to 
-           the controller. */
-        case CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE:
-		{
-			DEBUG_BLE("CY_BLE_EVT_GAP_CONNECTION_UPDATE_COMPLETE \r\n");
-            
-            break;
-		}
-        /* This event indicates completion of the Cy_BLE_SetPhy API*/
-		case CY_BLE_EVT_SET_PHY_COMPLETE:
-        {
-            DEBUG_BLE("Updating the Phy.....\r\n");
-            cy_stc_ble_events_param_generic_t * param =\
-            (cy_stc_ble_events_param_generic_t *) eventParam;
-            if(param->status ==SUCCESS)
-            {
-                DEBUG_BLE("SET PHY updated to 2 Mbps\r\n");
-                Cy_BLE_GetPhy(appConnHandle.bdHandle);
-            }
-            else
-            {
-                DEBUG_BLE("SET PHY Could not update to 2 Mbps\r\n");
-                Cy_BLE_GetPhy(appConnHandle.bdHandle);
-            }
-            
-            break;
-        }
-        /* This event indicates completion of the Cy_BLE_GetPhy API */
-        case CY_BLE_EVT_GET_PHY_COMPLETE:
-        {
-            /* To remove unused parameter warning when UART debug is disabled */
-            #if (DEBUG_BLE == ENABLE)
-            cy_stc_ble_events_param_generic_t *param =\
-            cy_stc_ble_events_param_generic_t *)eventParam;
-            cy_stc_ble_phy_param_t *phyparam = NULL;
-                      
-            if(param->status == SUCCESS)
-            {
-                phyparam = (cy_stc_ble_phy_param_t *)param->eventParams;
-                DEBUG_BLE("RxPhy Mask : 0x%02X\r\nTxPhy Mask : 0x%02X\r\n", \
-                    phyparam->rxPhyMask, phyparam->txPhyMask);            
-            }
-            #endif
-            
-            break;
-
-        }
-        /* This event indicates that the controller has changed the transmitter
-           PHY or receiver PHY in use */
-        case CY_BLE_EVT_PHY_UPDATE_COMPLETE:
-        {
-            DEBUG_BLE("UPDATE PHY parameters\r\n");
-             /* To remove unused parameter warning when UART debug is disabled */
-            #if (DEBUG_BLE == ENABLE)
-            cy_stc_ble_events_param_generic_t *param =\
-           (cy_stc_ble_events_param_generic_t *)eventParam;
-            cy_stc_ble_phy_param_t *phyparam = NULL;
-            if(param->status == SUCCESS)
-            {
-                phyparam = (cy_stc_ble_phy_param_t *)param->eventParams;
-                DEBUG_BLE("RxPhy Mask : 0x%02X\r\nTxPhy Mask : 0x%02X\r\n",\
-                    phyparam->rxPhyMask, phyparam->txPhyMask);            
-            }
-            #endif
-            
-            break;
-        }		
-            
-        /**********************************************************
-        *                       GATT Events
-        ***********************************************************/
-            
-        /* This event is generated at the GAP Peripheral end after connection 
-           is completed with peer Central device. */
-        case CY_BLE_EVT_GATT_CONNECT_IND:
-        {
-            appConnHandle = *(cy_stc_ble_conn_handle_t *)eventParam;
-            DEBUG_BLE("CY_BLE_EVT_GATT_CONNECT_IND: %x, %x \r\n", 
-                        appConnHandle.attId, 
-                        appConnHandle.bdHandle);
-            
-            /* Update Notification packet with the data. */
-            notificationPacket.connHandle = appConnHandle;
-            notificationPacket.handleValPair.attrHandle = CUSTOM_CHAR_HANDLE;
-            
-            Cy_BLE_GetPhy(appConnHandle.bdHandle);                   
-           
-            break;
-        }    
-        /* This event is generated at the GAP Peripheral end after disconnection. */
-        case CY_BLE_EVT_GATT_DISCONNECT_IND:
-        {
-            DEBUG_BLE("CY_BLE_EVT_GATT_DISCONNECT_IND \r\n");
-            if(appConnHandle.bdHandle == (*(cy_stc_ble_conn_handle_t *)eventParam).bdHandle)
-            {
-            	DEBUG_BLE_LOGIC("Disconnected. \r\n\n");
-                appConnHandle.bdHandle = CY_BLE_INVALID_CONN_HANDLE_VALUE;
-                appConnHandle.attId    = CY_BLE_INVALID_CONN_HANDLE_VALUE;
-            }
-            cyhal_gpio_write((cyhal_gpio_t)LED2, CYBSP_LED_STATE_OFF);
-            
-            break;
-        }
-        /* This event is triggered when 'GATT MTU Exchange Request' 
-           received from GATT client device. */
-        case CY_BLE_EVT_GATTS_XCNHG_MTU_REQ:
-        {
-            negotiatedMtu = (((cy_stc_ble_gatt_xchg_mtu_param_t *)eventParam)->mtu < CY_BLE_GATT_MTU) ?
-                            ((cy_stc_ble_gatt_xchg_mtu_param_t *)eventParam)->mtu : CY_BLE_GATT_MTU;
-            //DEBUG_BLE("CY_BLE_EVT_GATTS_XCNHG_MTU_REQ negotiated = %d\r\n", negotiatedMtu);
-            DEBUG_BLE_LOGIC("Negotiated MTU size: %d \r\n", negotiatedMtu);
-            
-            break;
-        }   
-        /* This event is triggered when there is a write request from the 
-           Client device */
-        case CY_BLE_EVT_GATTS_WRITE_REQ:
-        {
-        	DEBUG_BLE_LOGIC("StackEventHandler CY_BLE_EVT_GATTS_WRITE_REQ. Event : %ld \r\n", event);
-
-            DEBUG_BLE("CY_BLE_EVT_GATTS_WRITE_REQ \r\n");  
-            cy_stc_ble_gatt_write_param_t *write_req_param = \
-            (cy_stc_ble_gatt_write_param_t *)eventParam;
-            cy_stc_ble_gatts_db_attr_val_info_t attr_param;
-                        
-            DEBUG_BLE("Received GATT Write Request [bdHandle %02X]\r\n",\
-                write_req_param->connHandle.bdHandle);
-            attr_param.connHandle.bdHandle = write_req_param->connHandle.bdHandle;
-            attr_param.connHandle.attId = write_req_param->connHandle.attId;
-            attr_param.flags = CY_BLE_GATT_DB_PEER_INITIATED;
-            attr_param.handleValuePair = write_req_param->handleValPair;
-            attr_param.offset = 0;
-            
-            DEBUG_BLE("write_req_param->handleValPair.attrHandle = %d  \r\n", write_req_param->handleValPair.attrHandle);
-            DEBUG_BLE("CUSTOM_DESCR_HANDLE (%d)\r\n CUSTOM_CHAR_HANDLE(%d)\r\n",CUSTOM_DESCR_HANDLE, CUSTOM_CHAR_HANDLE);
-                  
-           
-			if(write_req_param->handleValPair.attrHandle == (CUSTOM_DESCR_HANDLE))
-            {
-                if(Cy_BLE_GATTS_WriteRsp(write_req_param->connHandle) != CY_BLE_SUCCESS)
-                {
-                    DEBUG_BLE("Failed to send write response \r\n");
-                    DEBUG_BLE_LOGIC("Error... \r\n");
-                }
-                else
-                {
-                    DEBUG_BLE("GATT write response sent \r\n");
-                    app.notification_enabled = attr_param.handleValuePair.value.val[0];
-                    DEBUG_BLE("app.notification_enabled = %d\r\n", app.notification_enabled);
-                    DEBUG_BLE_LOGIC("Notification Enabled.\r\n\n");
-                    notificationPacket.connHandle = appConnHandle;
-                    notificationPacket.handleValPair.attrHandle = CUSTOM_CHAR_HANDLE;
-                }
-
-                DEBUG_BLE_LOGIC("Allright \r\n");
-            }
-			else if(write_req_param->handleValPair.attrHandle == (CUSTOM_CHAR_HANDLE))
-			{
-				DEBUG_BLE_LOGIC("Write to custom characteristic detected. \r\n");
-
-				// Send the ACK
-				if(Cy_BLE_GATTS_WriteRsp(write_req_param->connHandle) != CY_BLE_SUCCESS)
-				{
-					DEBUG_BLE("Failed to send write response \r\n");
-					DEBUG_BLE_LOGIC("Error... \r\n");
-				}
-				else
-				{
-					uint16_t len = write_req_param->handleValPair.value.len;
-					if (len > 0)
-					{
-						// First byte is the command, then the parameters
-						app.cmd.command = write_req_param->handleValPair.value.val[0];
-						app.cmd.len = len;
-
-						for(uint16_t i = 0; (i < len - 1) && (i < BLE_CMD_PARAM_MAX_SIZE); ++i)
-							app.cmd.parameters[i] = write_req_param->handleValPair.value.val[i + 1];
-
-						DEBUG_BLE_LOGIC("len is: %u \r\n", len);
-
-						app.cmd_to_process = 1;
-					}
-					else
-					{
-						DEBUG_BLE_LOGIC("Not a valid command. Length is 0 ... \r\n");
-					}
-				}
+	app.notification_enabled = 0;
+	reset_tx_credits(conn_interval_us);
+}
 
-			}
-			else
-			{
-				DEBUG_BLE_LOGIC("Not correct is %d but should be %d or %d \r\n", write_req_param->handleValPair.attrHandle, CUSTOM_DESCR_HANDLE, CUSTOM_CHAR_HANDLE);
-			}
-            break;
-        }
-        case CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ:
-        {
-            DEBUG_BLE("CY_BLE_EVT_GATTS_READ_CHAR_VAL_ACCESS_REQ \r\n");  
-            break;
-        }
-        /**********************************************************
-        *                       Other Events
-        ***********************************************************/
-        default:
-            DEBUG_BLE("OTHER event: %lx \r\n", (unsigned long) event);
-			break;
-        
-    }
+void host_main_on_conn_interval(uint32_t conn_interval_us)
+{
+	reset_tx_credits(conn_interval_us);
 }
 
-void SendAnswerNotification(uint16_t len, uint8_t* content)
+void host_main_on_disconnected()
 {
-    cy_en_ble_api_result_t apiResult;
-    notificationPacket.handleValPair.value.len = len;
+	app.mtu = BLE_PORT_DEFAULT_MTU;
+	app.subscription_mask = BLE_SUBSCRIPTION_ALL;
+	app.sensors_to_send = 0;
+	// The commands and the ACK of the previous client are not answered, its records are not sent to the next one
+	app.ack_to_send = 0;
+	command_queue_init(&app.cmd_queue);
+	notification_queue_clear(&app.notification_queue);
+	reset_frame();
+#ifdef UM980_SUPPORT
+	rtcm_reassembler_reset();
+#endif
+}
 
-    for(uint16 i = 0; i < len; ++i)
-    	notificationPacket.handleValPair.value.val[i] = content[i];
+void host_main_on_advertising()
+{
+	app.notification_enabled = 0;
+	app.mode = BLE_MODE_CONFIGURATION;
+	app.subscription_mask = BLE_SUBSCRIPTION_ALL;
+}
 
-    apiResult = Cy_BLE_GATTS_Notification(&notificationPacket);
-    if(apiResult == CY_BLE_ERROR_INVALID_PARAMETER)
-    {
-        DEBUG_BLE("Couldn't send notification. [CY_BLE_ERROR_INVALID_PARAMETER]\r\n");
-    }
-    else if(apiResult != CY_BLE_SUCCESS)
-    {
-        DEBUG_BLE("Attrhandle = 0x%4X  Cy_BLE_GATTS_Notification API Error:"\
-            "0x%2.2x \r\n", notificationPacket.handleValPair.attrHandle, apiResult);
-    }
-    // Set back
-    notificationPacket.handleValPair.value.len = NOTIFICATION_PKT_SIZE;
+void host_main_on_mtu_exchanged(uint16_t mtu)
+{
+	app.mtu = mtu;
 }
 
-/*******************************************************************************
-* Function Name: BlessInterrupt
-********************************************************************************
-* BLESS ISR
-* It is used used when BLE middleware operates in BLE single CM4
-*
-*******************************************************************************/
-/* BLESS ISR */
-void BlessInterrupt(void)
+void host_main_on_notification_config(uint8_t enabled)
 {
-    /* Call interrupt processing */
-    Cy_BLE_BlessIsrHandler();
+	app.notification_enabled = enabled;
 }
 
-void IasEventHandler(uint32_t event, void *eventParam)
+void host_main_on_stack_free()
 {
-    (void) eventParam;
+	app.tx_credits = BLE_TX_CREDITS_MAX;
 }
 
+
 /* [] END OF FILE */
@@ -11,21 +11,117 @@
 #include <stdint.h>
 
 #include "notification_fabric.h"
-#include "linked_list.h"
+#include "notification_queue.h"
+#include "command_queue.h"
 #include "rutronik_application.h"
 
 #define BLEMAX_MTU_SIZE	512
 
 #define BLE_CMD_PARAM_MAX_SIZE (BLEMAX_MTU_SIZE - 1) // -1 because first by is the command type
-#define BLE_ACK_MAX_SIZE 32
+#define BLE_ACK_MAX_SIZE 128
+#define BLE_SENSORS_RECORD_MAX_SIZE 16
+
+/**
+ * @def BLE_ACK_ERROR
+ * @brief Answer of a command whose parameters are not valid
+ */
+#define BLE_ACK_ERROR 0xFF
+
+/**
+ * @def BLE_FRAME_MAX_SIZE
+ * @brief Maximum size of a notification (length of the custom characteristic)
+ * Several records (sensor id, size, data, crc) are packed inside one notification
+ */
+#define BLE_FRAME_MAX_SIZE	495
+
+/**
+ * @def BLE_FRAME_FLUSH_TIMEOUT_US
+ * @brief Maximum time a record waits inside a partially filled frame before the frame is sent
+ */
+#define BLE_FRAME_FLUSH_TIMEOUT_US	20000
+
+/**
+ * @def BLE_TX_CREDITS_MAX
+ * @brief Maximum number of notifications handed to the stack during one connection interval
+ * Should match the number of link layer TX buffers configured for the controller
+ */
+#define BLE_TX_CREDITS_MAX	8
+
+/**
+ * @def BLE_DEFAULT_CONN_INTERVAL_US
+ * @brief Connection interval used until the real one is known (7.5ms is the minimum allowed)
+ */
+#define BLE_DEFAULT_CONN_INTERVAL_US	7500
 
 #define BLE_MODE_CONFIGURATION	1
 #define BLE_MODE_PUSH_DATA 		2
+#define BLE_MODE_THROUGHPUT_TEST	3	/**< Synthetic frames are sent as fast as the link allows (no sensor data) */
+
+/**
+ * @def BLE_TEST_FRAME_ID
+ * @brief First 2 bytes (uint16, little endian) of the frames sent in throughput test mode
+ * Frame: id, sequence number (uint32), timestamp in us (uint32), pattern (byte n = n & 0xFF) up to the negotiated MTU - 3
+ */
+#define BLE_TEST_FRAME_ID			0xFFFE
+#define BLE_TEST_FRAME_HEADER_SIZE	10
+
+/**
+ * @def BLE_SUBSCRIPTION_ALL
+ * @brief Default subscription mask: every stream is sent (bit n corresponds to sensor id n)
+ */
+#define BLE_SUBSCRIPTION_ALL	0xFFFFFFFFUL
+
+/**
+ * @def BLE_STATS_LATENCY_BUCKETS
+ * @brief Number of buckets of the latency histogram (time between the notification is handed to the host and its transmission)
+ * Upper bounds: 5ms, 10ms, 20ms, 50ms, 100ms, 200ms, 500ms, above
+ */
+#define BLE_STATS_LATENCY_BUCKETS	8
+
+/**
+ * @def BLE_STATS_RATE_WINDOW_US
+ * @brief Window used to compute the throughput (bytes per second)
+ */
+#define BLE_STATS_RATE_WINDOW_US	1000000
+
+/**
+ * Statistics of the notification pipeline
+ * Counters are in records (one notification packet contains several records) unless specified otherwise
+ */
+typedef struct
+{
+	uint32_t enqueued;						/**< Records added to the notification queue */
+	uint32_t sent;							/**< Records handed to the stack */
+	uint32_t packets_sent;					/**< Notification packets handed to the stack */
+	uint32_t dropped_queue_full;			/**< Records dropped because the queue was full */
+	uint32_t dropped_not_push;				/**< Records dropped because notifications or push mode were not active */
+	uint32_t dropped_too_long;				/**< Records (and ACKs) dropped because they do not fit inside a notification with the actual MTU */
+	uint32_t dropped_no_buffer;				/**< Records lost because no notification could be reserved (slabs exhausted) */
+	uint32_t gatt_busy_stalls;				/**< Data was waiting but the stack was busy (or refused the notification) */
+	uint32_t bytes_sent;					/**< Bytes handed to the stack (notification payloads) */
+	uint32_t bytes_per_second;				/**< Throughput measured during the last complete window */
+	uint16_t queue_high_water;				/**< Maximum number of records waiting inside the queue */
+	uint16_t packets_per_interval_max;		/**< Maximum number of notifications sent during one connection interval */
+	uint32_t latency_histogram[BLE_STATS_LATENCY_BUCKETS];	/**< Number of records per latency bucket */
+
+	uint32_t window_start_us;				/**< Start of the actual throughput window */
+	uint32_t window_bytes;					/**< Bytes sent during the actual throughput window */
+} ble_stats_t;
+
+/**
+ * Origin of a received command (header byte of the command queue entries)
+ * BLE_CMD_SOURCE_DATA_CHAR: [command, parameters...] written to the notification characteristic (legacy)
+ * BLE_CMD_SOURCE_CMD_CHAR: [request id, command, parameters...] written to the command characteristic
+ */
+#define BLE_CMD_SOURCE_DATA_CHAR	0
+#define BLE_CMD_SOURCE_CMD_CHAR		1
 
 typedef struct
 {
 	uint8_t command;
-	uint16_t len;
+	uint16_t len;							/**< Length of the command and of its parameters */
+	uint8_t has_request_id;					/**< Command received on the command characteristic, the ACK carries the request id */
+	uint8_t request_id;
 	uint8_t parameters[BLE_CMD_PARAM_MAX_SIZE];
 } ble_cmt_t;
 
@@ -33,28 +129,151 @@ typedef struct
 typedef struct
 {
 	uint8_t notification_enabled;			/**< Store if notification on the characteristic are enabled or not. The app must activate them */
+	uint16_t mtu;							/**< Negotiated ATT MTU */
 
-	uint8_t cmd_to_process;					/**< Store if a command is ready to be processed or not */
-	ble_cmt_t cmd;							/**< Store the command to be processed (once available) */
+	command_queue_t cmd_queue;				/**< Received commands waiting to be processed */
+	ble_cmt_t cmd;							/**< Store the command being processed */
+	uint16_t cmd_dropped;					/**< Number of commands dropped because the command queue was full */
 
 	uint8_t ack_to_send;					/**< Store if an ACK has to be send */
-	uint16_t ack_len;						/**< Length of the ACK packet */
-	uint8_t ack_content[BLE_ACK_MAX_SIZE];	/**< Content of the ACK packet */
+	uint16_t ack_len;						/**< Length of the answer */
+	uint16_t ack_sent;						/**< Bytes of the answer already sent (a long answer is split over several notifications) */
+	uint8_t ack_has_request_id;				/**< The answer is sent inside ACK records carrying the request id */
+	uint8_t ack_request_id;
+	uint8_t ack_command;
+	uint8_t ack_content[BLE_ACK_MAX_SIZE];	/**< Answer of the command */
+
+	uint8_t sensors_to_send;				/**< Store if the available sensors record (boards came online) has to be sent */
+	uint16_t sensors_len;					/**< Length of the available sensors record */
+	uint8_t sensors_content[BLE_SENSORS_RECORD_MAX_SIZE];	/**< Content of the available sensors record */
 
 	uint8_t notification_to_send;			/**< Something to send? */
 	notification_t* notification;
 
-	linked_list_t notification_list;
+	notification_queue_t notification_queue;	/**< Notifications waiting to be sent (FIFO) */
+
+	uint16_t frame_len;						/**< Number of bytes packed inside the frame buffer */
+	uint8_t frame_full;						/**< Next record does not fit inside the frame, send it */
+	uint32_t frame_start_us;				/**< Time when the first record has been packed inside the frame */
+	uint8_t frame[BLE_FRAME_MAX_SIZE];		/**< Frame buffer (concatenated records) */
+
+	uint8_t tx_credits;						/**< Number of notifications that can still be sent during the actual connection interval */
+	uint32_t conn_interval_us;				/**< Connection interval of the actual connection */
+	uint32_t conn_interval_start_us;		/**< Start time of the actual connection interval */
+	uint16_t packets_in_interval;			/**< Number of notifications sent during the actual connection interval */
+	uint16_t packets_per_interval;			/**< Number of notifications sent during the last complete connection interval */
+
+	ble_stats_t stats;						/**< Statistics of the notification pipeline */
+
+	uint32_t test_sequence;					/**< Sequence number of the next frame sent in throughput test mode */
+	uint16_t test_frame_len;				/**< Length of the test frame whose pattern is inside the frame buffer (0: pattern to be written) */
 
 	rutronik_application_t* rutronik_app;
 
 	uint8_t mode;							/**< Store the actual configuration mode */
+	uint32_t subscription_mask;				/**< Streams requested by the client (bit n corresponds to sensor id n) */
 } host_main_t;
 
 void Ble_Init(rutronik_application_t* rutronik_app);
 
 int host_main_do();
 
+/**
+ * @def HOST_MAIN_IDLE_FOREVER
+ * @brief Returned by host_main_get_idle_time_us when only a BLE event (interrupt) can create work
+ */
+#define HOST_MAIN_IDLE_FOREVER	UINT32_MAX
+
+/**
+ * @brief Get how long host_main_do has nothing to do (the main loop can sleep during that time)
+ * Has to be called after host_main_do
+ *
+ * @retval 0 Work pending (BLE events, commands, data that can be sent)
+ * @retval HOST_MAIN_IDLE_FOREVER Waiting for a BLE event only (deep sleep possible, hal_timer is not needed)
+ * @retval Other Time until the next TX credit window or frame flush timeout
+ */
+uint32_t host_main_get_idle_time_us();
+
+/**
+ * @brief Hand a record to the host (queued if push mode is active, freed otherwise)
+ * NULL (notification_fabric_create_for_* failed) is counted as dropped_no_buffer
+ *
+ * @retval 0 Queued
+ * @retval -1 Dropped
+ */
 int host_main_add_notification(notification_t* notification);
 
+/**
+ * @brief Inform the connected client that the available sensors changed (boards initialised after BLE is started)
+ * Sent in every mode, as soon as the ACK slot is free. Only the latest mask is kept.
+ * Ignored if no client has enabled the notifications (the client asks with CMD_GET_AVAILABLE_SENSORS after connecting).
+ *
+ * @param [in] mask See rutronik_application_get_available_sensors_mask
+ * @param [in] boot_done 1 once every board has been probed (mask is final)
+ */
+void host_main_notify_available_sensors(uint32_t mask, uint8_t boot_done);
+
+/**
+ * @brief Check if the values of a sensor are currently sent to a client
+ * Enables to skip the acquisition (I2C transfers, encoding) of sensors nobody listens to
+ *
+ * @param [in] sensor_id Notification id of the sensor (see notification_defs.h)
+ *
+ * @retval 1 Notifications are enabled, push mode is active and the stream is part of the subscription mask
+ * @retval 0 Otherwise
+ */
+uint8_t host_main_is_subscribed(uint16_t sensor_id);
+
+/**
+ * Events reported by the BLE port layer (see ble_port.h)
+ */
+
+/**
+ * @brief A write has been received (copied inside the command queue)
+ * Called before the write is answered: a write request that has not been queued is answered with an error
+ *
+ * @param [in] characteristic BLE_PORT_CHAR_DATA or BLE_PORT_CHAR_CMD
+ *
+ * @retval 0 Command queued
+ * @retval -1 Invalid command (empty)
+ * @retval -2 Command queue full, command dropped
+ */
+int host_main_on_write(uint8_t characteristic, uint8_t* data, uint16_t len);
+
+void host_main_on_connected(uint32_t conn_interval_us);
+
+/**
+ * @brief Connection interval known or updated
+ */
+void host_main_on_conn_interval(uint32_t conn_interval_us);
+
+void host_main_on_disconnected();
+
+/**
+ * @brief Advertising restarted while no client is connected
+ */
+void host_main_on_advertising();
+
+void host_main_on_mtu_exchanged(uint16_t mtu);
+
+/**
+ * @brief Client configuration descriptor of the notification characteristic written
+ */
+void host_main_on_notification_config(uint8_t enabled);
+
+/**
+ * @brief Stack buffers have been flushed, new notifications can be accepted
+ */
+void host_main_on_stack_free();
+
+/**
+ * @brief Get the statistics of the notification pipeline
+ */
+const ble_stats_t* host_main_get_stats();
+
+/**
+ * @brief Print the statistics of the notification pipeline over the debug UART
+ */
+void host_main_print_stats();
+
 #endif /* HOST_MAIN_H_ */
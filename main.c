@@ -56,12 +56,14 @@
 #include "cy_retarget_io.h"
 
 #include "hal/hal_i2c.h"
+#include "hal/hal_lowpower.h"
 #include "hal/hal_sleep.h"
 #include "sht4x/sht4x.h"
 #include "bmp581/bmp581.h"
 
 #include "host_main.h"
 #include "notification_fabric.h"
+#include "profiler.h"
 #include "rutronik_application.h"
 #include "battery_booster.h"
 
@@ -72,49 +74,80 @@
  */
 #define WDT_TIMEOUT_MS	4000
 
-static cyhal_timer_t sensor_timer;
-static uint8_t timer_interrupt = 0;
+/**
+ * The LED1 toggles every LED_TOGGLE_TICKS ticks of the application (RUTRONIK_APP_PERIOD_MS)
+ */
+#define LED_TOGGLE_TICKS	10
+
 static cyhal_wdt_t watchdog;
 
-static void sensor_timer_isr(void *callback_arg, cyhal_timer_event_t event)
-{
-	(void) callback_arg;
-	(void) event;
+/**
+ * Deadline of the next tick of the application, in counts of the low power timer
+ * Ticks are computed from a base time to avoid accumulating rounding errors (32768 Hz is not a multiple of 100 Hz)
+ */
+static uint32_t tick_base = 0;
+static uint32_t ticks_since_base = 0;
 
-	timer_interrupt = 1;
+static uint32_t get_tick_deadline()
+{
+	uint64_t counts = ((uint64_t) ticks_since_base * hal_lowpower_get_frequency() * RUTRONIK_APP_PERIOD_MS) / 1000u;
+	return tick_base + (uint32_t) counts;
 }
 
-static cy_rslt_t sensor_timer_init(void)
+/**
+ * @brief Start counting the ticks again from now (the next tick is one period later)
+ */
+static void restart_ticks()
 {
-	const uint32_t timer_frequency_hz = 10000;
-	const uint32_t isr_frequency_hz = 100;
+	tick_base = hal_lowpower_get_counts();
+	ticks_since_base = 1;
+}
 
-	const uint8_t priority = 6;
-	cyhal_timer_cfg_t configuration;
-	cy_rslt_t result;
+#ifdef PROFILER_SUPPORT
+/**
+ * @brief Get the number of ticks whose deadline already passed (they are not executed)
+ */
+static uint32_t get_missed_ticks()
+{
+	uint32_t period_counts = (hal_lowpower_get_frequency() * RUTRONIK_APP_PERIOD_MS) / 1000u;
+	if (period_counts == 0) return 1;
+	return ((hal_lowpower_get_counts() - get_tick_deadline()) / period_counts) + 1;
+}
+#endif
 
-	configuration.compare_value = 0;
-	configuration.period = (timer_frequency_hz / isr_frequency_hz);
-	configuration.direction = CYHAL_TIMER_DIR_UP;
-	configuration.is_compare = false;
-	configuration.is_continuous = true;
-	configuration.value = 0;
+/**
+ * @brief Sleep until the next deadline of the application or of the BLE host, if there is nothing to do
+ * Data ready interrupts of the sensors wake the CPU up earlier
+ *
+ * @param [in] allow_deep_sleep 1 if the sensors allow deep sleep
+ */
+static void idle(rutronik_application_t* app, uint8_t allow_deep_sleep)
+{
+	// Interrupts occurring from now on wake the CPU up immediately
+	uint32_t interrupt_state = cyhal_system_critical_section_enter();
 
-	result = cyhal_timer_init(&sensor_timer, NC, NULL);
-	if (result != CY_RSLT_SUCCESS) return result;
+	uint32_t host_idle_us = host_main_get_idle_time_us();
+	if ((host_idle_us != 0) && (rutronik_application_has_pending_events(app) == 0) && (hal_i2c_has_completed() == 0))
+	{
+		uint32_t deadline = get_tick_deadline();
 
-	result = cyhal_timer_configure(&sensor_timer, &configuration);
-	if (result != CY_RSLT_SUCCESS) return result;
+		// The I2C block and hal_timer (timeout of the transfer) have to run until the queue is empty
+		if (hal_i2c_is_busy()) allow_deep_sleep = 0;
 
-	result = cyhal_timer_set_frequency(&sensor_timer, timer_frequency_hz);
-	if (result != CY_RSLT_SUCCESS) return result;
+		if (host_idle_us != HOST_MAIN_IDLE_FOREVER)
+		{
+			// hal_timer (used by the BLE host for its timeouts) is stopped during deep sleep
+			allow_deep_sleep = 0;
 
-	cyhal_timer_register_callback(&sensor_timer, sensor_timer_isr, NULL);
+			uint32_t host_deadline = hal_lowpower_get_counts()
+					+ (uint32_t)(((uint64_t) host_idle_us * hal_lowpower_get_frequency()) / 1000000u);
+			if ((int32_t)(host_deadline - deadline) < 0) deadline = host_deadline;
+		}
 
-	cyhal_timer_enable_event(&sensor_timer, CYHAL_TIMER_IRQ_TERMINAL_COUNT, priority, true);
+		hal_lowpower_idle_until(deadline, allow_deep_sleep);
+	}
 
-	result = cyhal_timer_start(&sensor_timer);
-	return result;
+	cyhal_system_critical_section_exit(interrupt_state);
 }
 
 static void init_watchdog()
@@ -169,9 +202,9 @@ int main(void)
     	CY_ASSERT(0);
     }
 
-    // Initialise timer
-    res = sensor_timer_init();
-    printf("sensor timer init retval: %d \r\n", res);
+    // Initialise the time base of the main loop
+    res = hal_lowpower_init();
+    printf("low power timer init retval: %d \r\n", res);
 
     /*Charger control*/
     result = cyhal_gpio_init(CHR_DIS, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, false);
@@ -191,6 +224,12 @@ int main(void)
     	CY_ASSERT(0);
     }
 
+#ifdef PROFILER_SUPPORT
+    // Before the sensors: the scheduler names the sections of the sensors
+    profiler_init(RUTRONIK_APP_PERIOD_MS * 1000);
+#endif
+
+    // Boards are initialised later by the main loop: BLE advertises during their start-up
     rutronik_application_init(&rutronik_app);
 
     Ble_Init(&rutronik_app);
@@ -198,25 +237,60 @@ int main(void)
     init_watchdog();
 
     uint32_t counter = 0;
+    restart_ticks();
 
     for (;;)
     {
-    	if (timer_interrupt)
+    	uint32_t deadline = get_tick_deadline();
+    	if (hal_lowpower_is_reached(deadline))
     	{
-    		timer_interrupt = 0;
+    		hal_lowpower_record_wakeup(deadline);
 
+    		PROFILER_BEGIN(tick_start);
     		rutronik_application_do(&rutronik_app);
+    		PROFILER_END(PROFILER_SECTION_TICK, tick_start);
 
-    		if ((counter % 10) == 0)
+    		if ((counter % LED_TOGGLE_TICKS) == 0)
 			{
     			cyhal_gpio_toggle(LED1);
 			}
     		counter++;
+    		ticks_since_base++;
+
+    		// Sleep over the ticks without sensor to call (the LED tick is never skipped)
+    		uint16_t skipped = rutronik_application_get_idle_ticks(&rutronik_app);
+    		uint16_t before_led = (LED_TOGGLE_TICKS - (counter % LED_TOGGLE_TICKS)) % LED_TOGGLE_TICKS;
+    		if (skipped > before_led) skipped = before_led;
+    		rutronik_application_skip_ticks(&rutronik_app, skipped);
+    		counter += skipped;
+    		ticks_since_base += skipped;
+
+    		// More than one period late: ticks are not caught up (a sensor would be called twice in a row)
+    		if (hal_lowpower_is_reached(get_tick_deadline()))
+    		{
+    			PROFILER_ADD_MISSED_TICKS(get_missed_ticks());
+    			restart_ticks();
+    		}
     	}
 
+    	// Sensors read on their data ready interrupt
+    	PROFILER_BEGIN(data_ready_start);
+    	rutronik_application_process_events(&rutronik_app);
+    	PROFILER_END(PROFILER_SECTION_DATA_READY, data_ready_start);
+
+    	// Callbacks of the asynchronous I2C transactions
+    	hal_i2c_process();
+
     	host_main_do();
 
     	cyhal_wdt_kick(&watchdog);
+
+    	uint8_t allow_deep_sleep = 0;
+#ifdef DEEP_SLEEP_SUPPORT
+    	// Depends on the boards found during the boot
+    	allow_deep_sleep = rutronik_application_is_deep_sleep_allowed(&rutronik_app);
+#endif
+    	idle(&rutronik_app, allow_deep_sleep);
     }
 }
 
@@ -8,88 +8,144 @@
 #ifndef NOTIFICATION_DEFS_H_
 #define NOTIFICATION_DEFS_H_
 
+/**
+ * Queueing policy of a stream (see notification_queue)
+ * NOTIFICATION_LATEST_ONLY: a new value replaces the value still waiting to be sent (slow sensors)
+ * NOTIFICATION_KEEP_ALL: every value is queued (high rate streams)
+ * NOTIFICATION_PRIO_HIGH: sent before any low priority stream
+ * NOTIFICATION_PRIO_LOW: sent when no high priority value is waiting
+ */
+#define NOTIFICATION_KEEP_ALL		0x00
+#define NOTIFICATION_LATEST_ONLY	0x01
+#define NOTIFICATION_PRIO_HIGH		0x00
+#define NOTIFICATION_PRIO_LOW		0x02
+
+/**
+ * Policy used for sensor ids without explicit policy
+ */
+#define DEFAULT_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
+
 #define SHT4X_NOTIFICATION_ID 		0x1
+#define SHT4X_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define SHT4X_DATA_SIZE 			8
 
 #define BMP581_NOTIFICATION_ID 		0x2
+#define BMP581_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define BMP581_DATA_SIZE 			8
 
 #define SGP40_NOTIFICATION_ID 		0x3
+#define SGP40_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define SGP40_DATA_SIZE 			6
 
 #define SCD41_NOTIFICATION_ID 		0x4
+#define SCD41_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define SCD41_DATA_SIZE 			10
 
 #define TMF8828_NOTIFICATION_ID 	0x5
+#define TMF8828_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define TMF8828_DATA_SIZE 			40
 
 #define BATT_NOTIFICATION_ID 		0x6
+#define BATT_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define BATT_DATA_SIZE 				5
 
 #define TMF8828_8X8_NOTIFICATION_ID	0x7
+#define TMF8828_8X8_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define TMF8828_8X8_DATA_SIZE 		128
 
 #define PASCO2_NOTIFICATION_ID 		0x8
+#define PASCO2_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define PASCO2_DATA_SIZE 			2
 
 #define RADAR_NOTIFICATION_ID 		0x9
 #define RADAR_DATA_SIZE 			25
 
 #define DPS310_NOTIFICATION_ID 		0xA
+#define DPS310_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define DPS310_DATA_SIZE 			8
 
 #define BMI270_NOTIFICATION_ID 		0xB
+#define BMI270_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define BMI270_DATA_SIZE 			12
 
 #define BME688_NOTIFICATION_ID 		0xC
+#define BME688_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define BME688_DATA_SIZE 			160
 
 #define UM980_NOTIFICATION_ID 		0xD
+#define UM980_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_HIGH)
 #define UM980_DATA_SIZE 			66
 
 #define VCNL4030X01_NOTIFICATION_ID 0xE
+#define VCNL4030X01_NOTIFICATION_POLICY (NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define VCNL4030X01_DATA_SIZE       6
 
 #define REALSENSE_NOTIFICATION_ID 	0xF
 
 #define SGP41_NOTIFICATION_ID 		0x10
+#define SGP41_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define SGP41_DATA_SIZE 			12
 
 #define BMM350_NOTIFICATION_ID 		0x11
+#define BMM350_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define BMM350_DATA_SIZE 			16
 
 #define BME690_NOTIFICATION_ID 		0x12
+#define BME690_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_HIGH)
 #define BME690_DATA_SIZE 			22
 
 #define BMP585_NOTIFICATION_ID 		0x13
+#define BMP585_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define BMP585_DATA_SIZE 			8
 
 #define DPS368_NOTIFICATION_ID 		0x14
+#define DPS368_NOTIFICATION_POLICY	(NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define DPS368_DATA_SIZE 			8
 
 #define BMI323_NOTIFICATION_ID		0x15
+#define BMI323_NOTIFICATION_POLICY	(NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define BMI323_DATA_SIZE 			12
 
 #define VCNL3682XX_NOTIFICATION_ID         0x17
+#define VCNL3682XX_NOTIFICATION_POLICY     (NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define VCNL3682XX_DATA_SIZE               2
 
 #define VCNL4035X01_NOTIFICATION_ID        0x18
+#define VCNL4035X01_NOTIFICATION_POLICY    (NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define VCNL4035X01_DATA_SIZE              6
 
 #define VCNL403X_NOTIFICATION_ID        0x1D
+#define VCNL403X_NOTIFICATION_POLICY    (NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define VCNL403X_DATA_SIZE_SINGLE       2
 #define VCNL403X_DATA_SIZE_GESTURE      7
 
 #define VCNL4035X01_GES_NOTIFICATION_ID    0x19
+#define VCNL4035X01_GES_NOTIFICATION_POLICY (NOTIFICATION_KEEP_ALL | NOTIFICATION_PRIO_LOW)
 #define VCNL4035X01_GES_DATA_SIZE          6
 
 #define VEML6030_NOTIFICATION_ID           0x1A
+#define VEML6030_NOTIFICATION_POLICY       (NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define VEML6030_DATA_SIZE                 2
 
 #define VEML6031X00_NOTIFICATION_ID        0x1B
+#define VEML6031X00_NOTIFICATION_POLICY    (NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define VEML6031X00_DATA_SIZE              4
 
 #define VEML6046X00_NOTIFICATION_ID        0x1C
+#define VEML6046X00_NOTIFICATION_POLICY    (NOTIFICATION_LATEST_ONLY | NOTIFICATION_PRIO_HIGH)
 #define VEML6046X00_DATA_SIZE              8
 
+/**
+ * ACK of a command received on the command characteristic
+ * Data: request id, command, answer (sensor mask or command + 1)
+ */
+#define ACK_NOTIFICATION_ID                0x1E
+
+/**
+ * Sent when a board comes online during the boot (the boards are initialised after BLE is started)
+ * Data: sensor mask (uint32, same as the answer of CMD_GET_AVAILABLE_SENSORS), boot done (1 once every board has been probed)
+ */
+#define AVAILABLE_SENSORS_NOTIFICATION_ID  0x1F
+#define AVAILABLE_SENSORS_DATA_SIZE        5
+
 #endif /* NOTIFICATION_DEFS_H_ */
\ No newline at end of file
@@ -8,43 +8,185 @@
 #include "notification_fabric.h"
 #include "notification_defs.h"
 
-#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
 
 static const uint8_t notification_overhead = 4;
 
+/**
+ * @def NOTIFICATION_SMALL_BLOCK_SIZE
+ * @brief Size of the blocks used for small records (most of the sensors)
+ */
+#define NOTIFICATION_SMALL_BLOCK_SIZE	32
+
+/**
+ * @def NOTIFICATION_LARGE_BLOCK_SIZE
+ * @brief Size of the blocks used for large records (BME688 scan is the largest record)
+ */
+#define NOTIFICATION_LARGE_BLOCK_SIZE	(BME688_DATA_SIZE + 4)
+
+#define NOTIFICATION_SLAB_SMALL	0
+#define NOTIFICATION_SLAB_LARGE	1
+#define NOTIFICATION_SLAB_COUNT	2
+
+/**
+ * Pool of preallocated notifications of the same block size
+ * Free notifications are stored inside a stack (reserve and free are O(1))
+ */
+typedef struct
+{
+	uint16_t free_count;
+	notification_t** free_list;
+} notification_slab_t;
+
+static notification_t small_notifications[NOTIFICATION_SMALL_BLOCK_COUNT];
+static notification_t* small_free_list[NOTIFICATION_SMALL_BLOCK_COUNT];
+static uint8_t small_blocks[NOTIFICATION_SMALL_BLOCK_COUNT][NOTIFICATION_SMALL_BLOCK_SIZE];
+
+static notification_t large_notifications[NOTIFICATION_LARGE_BLOCK_COUNT];
+static notification_t* large_free_list[NOTIFICATION_LARGE_BLOCK_COUNT];
+static uint8_t large_blocks[NOTIFICATION_LARGE_BLOCK_COUNT][NOTIFICATION_LARGE_BLOCK_SIZE];
+
+static notification_slab_t slabs[NOTIFICATION_SLAB_COUNT];
+static uint8_t slabs_initialized = 0;
+
 static uint8_t compute_crc(uint8_t* data, uint8_t length)
 {
 	// TODO
 	return 0x3;
 }
 
+static void init_slabs()
+{
+	for(uint16_t i = 0; i < NOTIFICATION_SMALL_BLOCK_COUNT; ++i)
+	{
+		small_notifications[i].data = small_blocks[i];
+		small_notifications[i].slab = NOTIFICATION_SLAB_SMALL;
+		small_free_list[i] = &small_notifications[i];
+	}
+	slabs[NOTIFICATION_SLAB_SMALL].free_list = small_free_list;
+	slabs[NOTIFICATION_SLAB_SMALL].free_count = NOTIFICATION_SMALL_BLOCK_COUNT;
+
+	for(uint16_t i = 0; i < NOTIFICATION_LARGE_BLOCK_COUNT; ++i)
+	{
+		large_notifications[i].data = large_blocks[i];
+		large_notifications[i].slab = NOTIFICATION_SLAB_LARGE;
+		large_free_list[i] = &large_notifications[i];
+	}
+	slabs[NOTIFICATION_SLAB_LARGE].free_list = large_free_list;
+	slabs[NOTIFICATION_SLAB_LARGE].free_count = NOTIFICATION_LARGE_BLOCK_COUNT;
+
+	slabs_initialized = 1;
+}
+
+notification_t* notification_fabric_reserve(uint16_t sensor_id, uint8_t data_size)
+{
+	const uint16_t notification_size = (uint16_t) data_size + notification_overhead;
+
+	if (slabs_initialized == 0) init_slabs();
+
+	notification_slab_t* slab = NULL;
+	if (notification_size <= NOTIFICATION_SMALL_BLOCK_SIZE)
+	{
+		slab = &slabs[NOTIFICATION_SLAB_SMALL];
+		// Small slab exhausted, use a large block
+		if (slab->free_count == 0) slab = &slabs[NOTIFICATION_SLAB_LARGE];
+	}
+	else if (notification_size <= NOTIFICATION_LARGE_BLOCK_SIZE)
+	{
+		slab = &slabs[NOTIFICATION_SLAB_LARGE];
+	}
+	else
+	{
+		return NULL;
+	}
+
+	if (slab->free_count == 0) return NULL;
+
+	slab->free_count--;
+	notification_t* notification = slab->free_list[slab->free_count];
+
+	notification->length = (uint8_t) notification_size;
+	notification->data[0] = (uint8_t) (sensor_id & 0xFF);
+	notification->data[1] = (uint8_t) (sensor_id >> 8);
+	notification->data[2] = data_size;
+
+	return notification;
+}
+
+void notification_fabric_commit(notification_t* notification)
+{
+	notification->data[notification->length - 1] = compute_crc(notification->data, notification->length - 1);
+}
+
 void notification_fabric_free_notification(notification_t* notification)
 {
-	free(notification->data);
-	free(notification);
+	if (notification == NULL) return;
+
+	notification_slab_t* slab = &slabs[notification->slab];
+	slab->free_list[slab->free_count] = notification;
+	slab->free_count++;
+}
+
+uint16_t notification_fabric_get_free_count()
+{
+	if (slabs_initialized == 0) init_slabs();
+
+	return slabs[NOTIFICATION_SLAB_SMALL].free_count + slabs[NOTIFICATION_SLAB_LARGE].free_count;
+}
+
+uint16_t notification_fabric_encode_ack(uint8_t* buffer, uint16_t buffer_size, uint8_t request_id, uint8_t command, uint8_t* payload, uint8_t len)
+{
+	const uint16_t data_size = (uint16_t) len + 2;
+	const uint16_t record_size = data_size + notification_overhead;
+
+	if ((record_size > buffer_size) || (data_size > 0xFF)) return 0;
+
+	uint16_t index = 0;
+	buffer[index++] = (uint8_t) (ACK_NOTIFICATION_ID & 0xFF);
+	buffer[index++] = (uint8_t) (ACK_NOTIFICATION_ID >> 8);
+	buffer[index++] = (uint8_t) data_size;
+	buffer[index++] = request_id;
+	buffer[index++] = command;
+	memcpy(&buffer[index], payload, len);
+	index += len;
+	buffer[index] = compute_crc(buffer, index);
+
+	return record_size;
+}
+
+uint16_t notification_fabric_encode_available_sensors(uint8_t* buffer, uint16_t buffer_size, uint32_t mask, uint8_t boot_done)
+{
+	const uint16_t record_size = AVAILABLE_SENSORS_DATA_SIZE + notification_overhead;
+
+	if (record_size > buffer_size) return 0;
+
+	uint16_t index = 0;
+	buffer[index++] = (uint8_t) (AVAILABLE_SENSORS_NOTIFICATION_ID & 0xFF);
+	buffer[index++] = (uint8_t) (AVAILABLE_SENSORS_NOTIFICATION_ID >> 8);
+	buffer[index++] = AVAILABLE_SENSORS_DATA_SIZE;
+	memcpy(&buffer[index], &mask, sizeof(mask));
+	index += sizeof(mask);
+	buffer[index++] = boot_done;
+	buffer[index] = compute_crc(buffer, index);
+
+	return record_size;
 }
 
 notification_t* notification_fabric_create_for_sht4x(float temperature, float humidity)
 {
 	const uint8_t data_size = SHT4X_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = SHT4X_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
-
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((float*) &data[3]) = temperature;
 	*((float*) &data[7]) = humidity;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -52,24 +194,17 @@ notification_t* notification_fabric_create_for_sht4x(float temperature, float hu
 notification_t* notification_fabric_create_for_bmp581(float pressure, float temperature)
 {
 	const uint8_t data_size = BMP581_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BMP581_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((float*) &data[3]) = pressure;
 	*((float*) &data[7]) = temperature;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -77,25 +212,18 @@ notification_t* notification_fabric_create_for_bmp581(float pressure, float temp
 notification_t* notification_fabric_create_for_sgp40(uint16_t value_raw, uint16_t value_compensated, uint16_t gas_index)
 {
 	const uint8_t data_size = SGP40_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = SGP40_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = value_raw;
 	*((uint16_t*) &data[5]) = value_compensated;
 	*((uint16_t*) &data[7]) = gas_index;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -103,26 +231,19 @@ notification_t* notification_fabric_create_for_sgp40(uint16_t value_raw, uint16_
 notification_t* notification_fabric_create_for_scd41(uint16_t co2_ppm, float temperature, float humidity)
 {
 	const uint8_t data_size = SCD41_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = SCD41_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
-
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = co2_ppm;
 
 	*((float*) &data[5]) = temperature;
 	*((float*) &data[9]) = humidity;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -130,17 +251,14 @@ notification_t* notification_fabric_create_for_scd41(uint16_t co2_ppm, float tem
 notification_t* notification_fabric_create_for_tmf8828(tmf8828_results_t* results)
 {
 	const uint8_t data_size = TMF8828_DATA_SIZE; // 9*uint32_t (distance) - uint32_t (ambient light)
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = TMF8828_NOTIFICATION_ID;
 	const uint16_t values_count = 9;
 	uint16_t index = 0;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	index = 3;
 	*((uint32_t*) &data[index]) = results->ambient_light;
@@ -152,11 +270,7 @@ notification_t* notification_fabric_create_for_tmf8828(tmf8828_results_t* result
 		index += sizeof(uint32_t);
 	}
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -164,15 +278,12 @@ notification_t* notification_fabric_create_for_tmf8828(tmf8828_results_t* result
 notification_t* notification_fabric_create_for_battery_monitor(uint16_t voltage, uint8_t charge_status, uint8_t charge_fault, uint8_t dio_status)
 {
 	const uint8_t data_size = BATT_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BATT_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = voltage;
 
@@ -180,11 +291,7 @@ notification_t* notification_fabric_create_for_battery_monitor(uint16_t voltage,
 	data[6] = charge_fault;
 	data[7] = dio_status;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -192,17 +299,14 @@ notification_t* notification_fabric_create_for_battery_monitor(uint16_t voltage,
 notification_t* notification_fabric_create_for_tmf8828_8x8_mode(uint16_t* distances)
 {
 	const uint8_t data_size = TMF8828_8X8_DATA_SIZE; // 64*uint16_t (distance)
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = TMF8828_8X8_NOTIFICATION_ID;
 	const uint16_t values_count = 64;
 	uint16_t index = 0;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
-
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	index = 3;
 
@@ -212,11 +316,7 @@ notification_t* notification_fabric_create_for_tmf8828_8x8_mode(uint16_t* distan
 		index += sizeof(uint16_t);
 	}
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -224,23 +324,16 @@ notification_t* notification_fabric_create_for_tmf8828_8x8_mode(uint16_t* distan
 notification_t* notification_fabric_create_for_pasco2(uint16_t co2_ppm)
 {
 	const uint8_t data_size = PASCO2_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = PASCO2_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = co2_ppm;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -248,24 +341,17 @@ notification_t* notification_fabric_create_for_pasco2(uint16_t co2_ppm)
 notification_t* notification_fabric_create_for_dps310(float pressure, float temperature)
 {
 	const uint8_t data_size = DPS310_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = DPS310_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((float*) &data[3]) = pressure;
 	*((float*) &data[7]) = temperature;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -273,15 +359,12 @@ notification_t* notification_fabric_create_for_dps310(float pressure, float temp
 notification_t* notification_fabric_create_for_bmi270(int16_t accx, int16_t accy, int16_t accz, int16_t girx, int16_t giry, int16_t girz)
 {
 	const uint8_t data_size = BMI270_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BMI270_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
-
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((int16_t*) &data[3]) = accx;
 	*((int16_t*) &data[5]) = accy;
@@ -290,11 +373,7 @@ notification_t* notification_fabric_create_for_bmi270(int16_t accx, int16_t accy
 	*((int16_t*) &data[11]) = giry;
 	*((int16_t*) &data[13]) = girz;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -302,15 +381,12 @@ notification_t* notification_fabric_create_for_bmi270(int16_t accx, int16_t accy
 notification_t* notification_fabric_create_for_bme688(bme688_scan_data_t * values)
 {
 	const uint8_t data_size = BME688_DATA_SIZE; // 10 steps. Per step: temperature, pressure, humidity, gas resistance (all floats) => 4 * 4 * 10 => 160 bytes
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BME688_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	uint8_t index = 3;
 	for (uint8_t i = 0; i < BME688_MAX_STEPS_NB; ++i)
@@ -325,11 +401,7 @@ notification_t* notification_fabric_create_for_bme688(bme688_scan_data_t * value
 		index += sizeof(float);
 	}
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -338,15 +410,12 @@ notification_t* notification_fabric_create_for_bme688(bme688_scan_data_t * value
 notification_t* notification_fabric_create_for_um980(um980_gga_packet_t* packet)
 {
 	const uint8_t data_size =  UM980_DATA_SIZE; // 8*uint8_t + 1*uint16_t + 7*double
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = UM980_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	uint8_t index = 3;
 	data[index] = packet->hours;
@@ -382,11 +451,7 @@ notification_t* notification_fabric_create_for_um980(um980_gga_packet_t* packet)
 	*((uint16*) &data[index]) = packet->correction_age;
 	index += sizeof(uint16_t);
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -395,22 +460,16 @@ notification_t* notification_fabric_create_for_um980(um980_gga_packet_t* packet)
 notification_t* notification_fabric_create_for_vcnl4030x01(uint16_t proximity_value, uint16_t als_value, uint16_t white_value)
 {
 	const uint8_t data_size = VCNL4030X01_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = VCNL4030X01_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t)(sensor_id & 0xFF);
-	data[1] = (uint8_t)(sensor_id >> 8);
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = proximity_value;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -418,22 +477,16 @@ notification_t* notification_fabric_create_for_vcnl4030x01(uint16_t proximity_va
 notification_t* notification_fabric_create_for_vcnl3682xx(uint16_t proximity_value)
 {
 	const uint8_t data_size = VCNL3682XX_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = VCNL3682XX_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t)(sensor_id & 0xFF);
-	data[1] = (uint8_t)(sensor_id >> 8);
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = proximity_value;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -462,16 +515,13 @@ notification_t* notification_fabric_create_for_vcnl403x(
         return 0;
     }
 
-    const uint8_t notification_size = data_size + notification_overhead;
-    uint8_t* data = (uint8_t*) malloc(notification_size);
-    if (data == 0)
+    notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+    if (retval == NULL)
     {
         return 0;
     }
 
-    data[0] = (uint8_t)(sensor_id & 0xFF);
-    data[1] = (uint8_t)(sensor_id >> 8);
-    data[2] = data_size;
+    uint8_t* data = retval->data;
 
     *((uint16_t*) &data[3]) = ps1;
 
@@ -482,17 +532,7 @@ notification_t* notification_fabric_create_for_vcnl403x(
         data[9] = gesture;
     }
 
-    data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-    notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-    if (retval == 0)
-    {
-        free(data);
-        return 0;
-    }
-
-    retval->length = notification_size;
-    retval->data = data;
+    notification_fabric_commit(retval);
 
     return retval;
 }
@@ -501,22 +541,16 @@ notification_t* notification_fabric_create_for_vcnl403x(
 notification_t* notification_fabric_create_for_veml6030(uint16_t als_value)
 {
 	const uint8_t data_size = VEML6030_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = VEML6030_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t)(sensor_id & 0xFF);
-	data[1] = (uint8_t)(sensor_id >> 8);
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = als_value;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -524,23 +558,17 @@ notification_t* notification_fabric_create_for_veml6030(uint16_t als_value)
 notification_t* notification_fabric_create_for_veml6031x00(uint16_t als_value, uint16_t ir_value)
 {
     const uint8_t data_size = VEML6031X00_DATA_SIZE;
-    const uint8_t notification_size = data_size + notification_overhead;
     const uint16_t sensor_id = VEML6031X00_NOTIFICATION_ID;
 
-    uint8_t* data = (uint8_t*) malloc(notification_size);
+    notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+    if (retval == NULL) return NULL;
 
-    data[0] = (uint8_t)(sensor_id & 0xFF);
-    data[1] = (uint8_t)(sensor_id >> 8);
-    data[2] = data_size;
+    uint8_t* data = retval->data;
 
     *((uint16_t*) &data[3]) = als_value;
     *((uint16_t*) &data[5]) = ir_value;
 
-    data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-    notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-    retval->length = notification_size;
-    retval->data = data;
+    notification_fabric_commit(retval);
 
     return retval;
 }
@@ -548,25 +576,19 @@ notification_t* notification_fabric_create_for_veml6031x00(uint16_t als_value, u
 notification_t* notification_fabric_create_for_veml6046x00(uint16_t r, uint16_t g, uint16_t b, uint16_t ir)
 {
 	const uint8_t data_size = VEML6046X00_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = VEML6046X00_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t)(sensor_id & 0xFF);
-	data[1] = (uint8_t)(sensor_id >> 8);
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = r;
 	*((uint16_t*) &data[5]) = g;
 	*((uint16_t*) &data[7]) = b;
 	*((uint16_t*) &data[9]) = ir;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -574,26 +596,19 @@ notification_t* notification_fabric_create_for_veml6046x00(uint16_t r, uint16_t
 notification_t* notification_fabric_create_for_bmm350(float temp, float mag_x, float mag_y, float mag_z)
 {
 	const uint8_t data_size = BMM350_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BMM350_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
-
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((float*) &data[3]) = temp;
 	*((float*) &data[7]) = mag_x;
 	*((float*) &data[11]) = mag_y;
 	*((float*) &data[15]) = mag_z;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -601,26 +616,19 @@ notification_t* notification_fabric_create_for_bmm350(float temp, float mag_x, f
 notification_t* notification_fabric_create_for_sgp41(uint16_t voc_raw, uint16_t nox_raw, int32_t voc_index, int32_t nox_index)
 {
 	const uint8_t data_size = SGP41_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = SGP41_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((uint16_t*) &data[3]) = voc_raw;
 	*((uint16_t*) &data[5]) = nox_raw;
 	*((int32_t*) &data[7]) = voc_index;
 	*((int32_t*) &data[11]) = nox_index;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -628,15 +636,12 @@ notification_t* notification_fabric_create_for_sgp41(uint16_t voc_raw, uint16_t
 notification_t* notification_fabric_create_for_bme690(bme69x_data_t* bme_data)
 {
 	const uint8_t data_size = BME690_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BME690_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	data[3] = bme_data->status;
 	data[4] = bme_data->gas_index;
@@ -650,11 +655,7 @@ notification_t* notification_fabric_create_for_bme690(bme69x_data_t* bme_data)
 	*((float*) &data[17]) = bme_data->humidity;
 	*((float*) &data[21]) = bme_data->gas_resistance;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -662,24 +663,17 @@ notification_t* notification_fabric_create_for_bme690(bme69x_data_t* bme_data)
 notification_t* notification_fabric_create_for_bmp585(float press, float temp)
 {
 	const uint8_t data_size = BMP585_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BMP585_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
-
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((float*) &data[3]) = press;
 	*((float*) &data[7]) = temp;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -687,24 +681,17 @@ notification_t* notification_fabric_create_for_bmp585(float press, float temp)
 notification_t* notification_fabric_create_for_dps368(float press, float temp)
 {
 	const uint8_t data_size = DPS368_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = DPS368_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((float*) &data[3]) = press;
 	*((float*) &data[7]) = temp;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -712,15 +699,12 @@ notification_t* notification_fabric_create_for_dps368(float press, float temp)
 notification_t* notification_fabric_create_for_bmi323(int16_t acc_x, int16_t acc_y, int16_t acc_z, int16_t gyr_x, int16_t gyr_y, int16_t gyr_z)
 {
 	const uint8_t data_size = BMI323_DATA_SIZE;
-	const uint8_t notification_size = data_size + notification_overhead;
 	const uint16_t sensor_id = BMI323_NOTIFICATION_ID;
 
-	uint8_t* data = (uint8_t*) malloc(notification_size);
-
-	data[0] = (uint8_t) (sensor_id & 0xFF);
-	data[1] = (uint8_t) (sensor_id >> 8);
+	notification_t* retval = notification_fabric_reserve(sensor_id, data_size);
+	if (retval == NULL) return NULL;
 
-	data[2] = data_size;
+	uint8_t* data = retval->data;
 
 	*((int16_t*) &data[3]) = acc_x;
 	*((int16_t*) &data[5]) = acc_y;
@@ -729,11 +713,7 @@ notification_t* notification_fabric_create_for_bmi323(int16_t acc_x, int16_t acc
 	*((int16_t*) &data[11]) = gyr_y;
 	*((int16_t*) &data[13]) = gyr_z;
 
-	data[notification_size - 1] = compute_crc(data, notification_size - 1);
-
-	notification_t* retval = (notification_t*) malloc(sizeof(notification_t));
-	retval->length = notification_size;
-	retval->data = data;
+	notification_fabric_commit(retval);
 
 	return retval;
 }
@@ -19,14 +19,72 @@
 
 #include "bme690/bme690_app.h"
 
+/**
+ * @def NOTIFICATION_SMALL_BLOCK_COUNT
+ * @brief Number of preallocated notifications for records up to 32 bytes
+ */
+#ifndef NOTIFICATION_SMALL_BLOCK_COUNT
+#define NOTIFICATION_SMALL_BLOCK_COUNT	64
+#endif
+
+/**
+ * @def NOTIFICATION_LARGE_BLOCK_COUNT
+ * @brief Number of preallocated notifications for larger records (TMF8828, BME688, UM980)
+ * At least the depth of both rings of notification_queue: low priority records filling their ring
+ * must not leave the high priority ones without a block
+ */
+#ifndef NOTIFICATION_LARGE_BLOCK_COUNT
+#define NOTIFICATION_LARGE_BLOCK_COUNT	96
+#endif
+
 typedef struct
 {
 	uint8_t length;
 	uint8_t* data;
+	uint8_t slab;		/**< Slab the notification has been reserved from */
+	uint32_t timestamp_us;	/**< Time when the notification has been handed to the host (used for the latency statistics) */
 } notification_t;
 
+/**
+ * @brief Reserve a notification inside the preallocated slabs and write its header (sensor id, size)
+ * The caller writes the data starting at data[3] and then calls notification_fabric_commit
+ *
+ * @retval NULL No free notification available (or data_size too large)
+ */
+notification_t* notification_fabric_reserve(uint16_t sensor_id, uint8_t data_size);
+
+/**
+ * @brief Finalize a reserved notification (computes the crc)
+ */
+void notification_fabric_commit(notification_t* notification);
+
+/**
+ * @brief Give back a notification to its slab
+ */
 void notification_fabric_free_notification(notification_t* notification);
 
+/**
+ * @brief Get the number of notifications that can still be reserved
+ */
+uint16_t notification_fabric_get_free_count();
+
+/**
+ * @brief Encode the ACK record of a command received with a request id (written directly inside buffer)
+ * Data: request id, command, answer
+ *
+ * @retval 0 Buffer is too small
+ * @retval > 0 Length of the record
+ */
+uint16_t notification_fabric_encode_ack(uint8_t* buffer, uint16_t buffer_size, uint8_t request_id, uint8_t command, uint8_t* payload, uint8_t len);
+
+/**
+ * @brief Encode the record announcing the available sensors (written directly inside buffer)
+ *
+ * @retval 0 Buffer is too small
+ * @retval > 0 Length of the record
+ */
+uint16_t notification_fabric_encode_available_sensors(uint8_t* buffer, uint16_t buffer_size, uint32_t mask, uint8_t boot_done);
+
 notification_t* notification_fabric_create_for_sht4x(float temperature, float humidity);
 
 notification_t* notification_fabric_create_for_bmp581(float pressure, float temperature);
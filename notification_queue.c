@@ -0,0 +1,183 @@
+/*
+ * notification_queue.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "notification_queue.h"
+#include "notification_defs.h"
+
+#include <stddef.h>
+
+typedef struct
+{
+	uint16_t sensor_id;
+	uint8_t policy;
+} notification_policy_t;
+
+static const notification_policy_t policies[] =
+{
+	{SHT4X_NOTIFICATION_ID, SHT4X_NOTIFICATION_POLICY},
+	{BMP581_NOTIFICATION_ID, BMP581_NOTIFICATION_POLICY},
+	{SGP40_NOTIFICATION_ID, SGP40_NOTIFICATION_POLICY},
+	{SCD41_NOTIFICATION_ID, SCD41_NOTIFICATION_POLICY},
+	{TMF8828_NOTIFICATION_ID, TMF8828_NOTIFICATION_POLICY},
+	{BATT_NOTIFICATION_ID, BATT_NOTIFICATION_POLICY},
+	{TMF8828_8X8_NOTIFICATION_ID, TMF8828_8X8_NOTIFICATION_POLICY},
+	{PASCO2_NOTIFICATION_ID, PASCO2_NOTIFICATION_POLICY},
+	{DPS310_NOTIFICATION_ID, DPS310_NOTIFICATION_POLICY},
+	{BMI270_NOTIFICATION_ID, BMI270_NOTIFICATION_POLICY},
+	{BME688_NOTIFICATION_ID, BME688_NOTIFICATION_POLICY},
+	{UM980_NOTIFICATION_ID, UM980_NOTIFICATION_POLICY},
+	{VCNL4030X01_NOTIFICATION_ID, VCNL4030X01_NOTIFICATION_POLICY},
+	{SGP41_NOTIFICATION_ID, SGP41_NOTIFICATION_POLICY},
+	{BMM350_NOTIFICATION_ID, BMM350_NOTIFICATION_POLICY},
+	{BME690_NOTIFICATION_ID, BME690_NOTIFICATION_POLICY},
+	{BMP585_NOTIFICATION_ID, BMP585_NOTIFICATION_POLICY},
+	{DPS368_NOTIFICATION_ID, DPS368_NOTIFICATION_POLICY},
+	{BMI323_NOTIFICATION_ID, BMI323_NOTIFICATION_POLICY},
+	{VCNL3682XX_NOTIFICATION_ID, VCNL3682XX_NOTIFICATION_POLICY},
+	{VCNL4035X01_NOTIFICATION_ID, VCNL4035X01_NOTIFICATION_POLICY},
+	{VCNL403X_NOTIFICATION_ID, VCNL403X_NOTIFICATION_POLICY},
+	{VCNL4035X01_GES_NOTIFICATION_ID, VCNL4035X01_GES_NOTIFICATION_POLICY},
+	{VEML6030_NOTIFICATION_ID, VEML6030_NOTIFICATION_POLICY},
+	{VEML6031X00_NOTIFICATION_ID, VEML6031X00_NOTIFICATION_POLICY},
+	{VEML6046X00_NOTIFICATION_ID, VEML6046X00_NOTIFICATION_POLICY},
+};
+
+static uint16_t get_sensor_id(notification_t* notification)
+{
+	return ((uint16_t) notification->data[0]) | (((uint16_t) notification->data[1]) << 8);
+}
+
+uint8_t notification_queue_get_policy(uint16_t sensor_id)
+{
+	for(uint16_t i = 0; i < (sizeof(policies) / sizeof(policies[0])); ++i)
+	{
+		if (policies[i].sensor_id == sensor_id) return policies[i].policy;
+	}
+	return DEFAULT_NOTIFICATION_POLICY;
+}
+
+static void ring_init(notification_ring_t* ring, notification_t** slots, uint16_t depth)
+{
+	ring->slots = slots;
+	ring->mask = depth - 1;
+	ring->head = 0;
+	ring->tail = 0;
+}
+
+static uint16_t ring_get_count(notification_ring_t* ring)
+{
+	return (uint16_t)(ring->head - ring->tail);
+}
+
+/**
+ * @brief Replace the waiting value of the same stream (if any)
+ *
+ * @retval 0 No waiting value of the stream
+ * @retval 1 Waiting value has been replaced
+ */
+static int ring_replace(notification_ring_t* ring, uint16_t sensor_id, notification_t* notification)
+{
+	for(uint16_t index = ring->tail; index != ring->head; ++index)
+	{
+		notification_t** slot = &ring->slots[index & ring->mask];
+		if (get_sensor_id(*slot) == sensor_id)
+		{
+			notification_fabric_free_notification(*slot);
+			*slot = notification;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int ring_push(notification_ring_t* ring, notification_t* notification)
+{
+	uint16_t head = ring->head;
+	if (ring_get_count(ring) > ring->mask)
+	{
+		notification_fabric_free_notification(notification);
+		return NOTIFICATION_QUEUE_DROPPED;
+	}
+
+	ring->slots[head & ring->mask] = notification;
+	ring->head = head + 1;
+	return NOTIFICATION_QUEUE_QUEUED;
+}
+
+/**
+ * @brief Get the ring that has to be served first
+ *
+ * @retval NULL all rings are empty
+ */
+static notification_ring_t* get_first_ring(notification_queue_t* queue)
+{
+	for(uint16_t i = 0; i < NOTIFICATION_QUEUE_PRIO_COUNT; ++i)
+	{
+		if (ring_get_count(&queue->rings[i]) > 0) return &queue->rings[i];
+	}
+	return NULL;
+}
+
+void notification_queue_init(notification_queue_t* queue)
+{
+	ring_init(&queue->rings[NOTIFICATION_QUEUE_PRIO_HIGH], queue->high_slots, NOTIFICATION_QUEUE_HIGH_DEPTH);
+	ring_init(&queue->rings[NOTIFICATION_QUEUE_PRIO_LOW], queue->low_slots, NOTIFICATION_QUEUE_DEPTH);
+}
+
+int notification_queue_push(notification_queue_t* queue, notification_t* notification)
+{
+	if (notification == NULL) return NOTIFICATION_QUEUE_DROPPED;
+
+	uint16_t sensor_id = get_sensor_id(notification);
+	uint8_t policy = notification_queue_get_policy(sensor_id);
+
+	notification_ring_t* ring = ((policy & NOTIFICATION_PRIO_LOW) != 0) ?
+			&queue->rings[NOTIFICATION_QUEUE_PRIO_LOW] : &queue->rings[NOTIFICATION_QUEUE_PRIO_HIGH];
+
+	if ((policy & NOTIFICATION_LATEST_ONLY) != 0)
+	{
+		if (ring_replace(ring, sensor_id, notification) != 0) return NOTIFICATION_QUEUE_REPLACED;
+	}
+
+	return ring_push(ring, notification);
+}
+
+notification_t* notification_queue_peek(notification_queue_t* queue)
+{
+	notification_ring_t* ring = get_first_ring(queue);
+	if (ring == NULL) return NULL;
+
+	return ring->slots[ring->tail & ring->mask];
+}
+
+void notification_queue_pop(notification_queue_t* queue)
+{
+	notification_ring_t* ring = get_first_ring(queue);
+	if (ring == NULL) return;
+
+	uint16_t tail = ring->tail;
+	notification_fabric_free_notification(ring->slots[tail & ring->mask]);
+	ring->tail = tail + 1;
+}
+
+uint16_t notification_queue_get_count(notification_queue_t* queue)
+{
+	uint16_t count = 0;
+	for(uint16_t i = 0; i < NOTIFICATION_QUEUE_PRIO_COUNT; ++i)
+	{
+		count += ring_get_count(&queue->rings[i]);
+	}
+	return count;
+}
+
+void notification_queue_clear(notification_queue_t* queue)
+{
+	while(notification_queue_get_count(queue) > 0)
+	{
+		notification_queue_pop(queue);
+	}
+}
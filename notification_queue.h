@@ -0,0 +1,119 @@
+/*
+ * notification_queue.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef NOTIFICATION_QUEUE_H_
+#define NOTIFICATION_QUEUE_H_
+
+#include <stdint.h>
+
+#include "notification_fabric.h"
+
+/**
+ * @def NOTIFICATION_QUEUE_DEPTH
+ * @brief Maximum number of low priority notifications (high rate streams) waiting to be sent over BLE
+ * Must be a power of two (index wrapping is done using a mask)
+ */
+#ifndef NOTIFICATION_QUEUE_DEPTH
+#define NOTIFICATION_QUEUE_DEPTH	64
+#endif
+
+/**
+ * @def NOTIFICATION_QUEUE_HIGH_DEPTH
+ * @brief Maximum number of high priority notifications (low rate streams) waiting to be sent over BLE
+ * Must be a power of two (index wrapping is done using a mask)
+ */
+#ifndef NOTIFICATION_QUEUE_HIGH_DEPTH
+#define NOTIFICATION_QUEUE_HIGH_DEPTH	32
+#endif
+
+#if ((NOTIFICATION_QUEUE_DEPTH & (NOTIFICATION_QUEUE_DEPTH - 1)) != 0)
+#error "NOTIFICATION_QUEUE_DEPTH must be a power of two"
+#endif
+
+#if ((NOTIFICATION_QUEUE_HIGH_DEPTH & (NOTIFICATION_QUEUE_HIGH_DEPTH - 1)) != 0)
+#error "NOTIFICATION_QUEUE_HIGH_DEPTH must be a power of two"
+#endif
+
+#if (NOTIFICATION_LARGE_BLOCK_COUNT < (NOTIFICATION_QUEUE_DEPTH + NOTIFICATION_QUEUE_HIGH_DEPTH))
+#error "NOTIFICATION_LARGE_BLOCK_COUNT must cover both rings (NOTIFICATION_QUEUE_DEPTH + NOTIFICATION_QUEUE_HIGH_DEPTH)"
+#endif
+
+#define NOTIFICATION_QUEUE_PRIO_HIGH	0
+#define NOTIFICATION_QUEUE_PRIO_LOW		1
+#define NOTIFICATION_QUEUE_PRIO_COUNT	2
+
+#define NOTIFICATION_QUEUE_QUEUED		0
+#define NOTIFICATION_QUEUE_REPLACED		1
+#define NOTIFICATION_QUEUE_DROPPED		-1
+
+/**
+ * Single producer (rutronik application) / single consumer (BLE host) FIFO
+ * Only the producer writes head, only the consumer writes tail
+ */
+typedef struct
+{
+	notification_t** slots;
+	uint16_t mask;				/**< Depth of the ring - 1 */
+	volatile uint16_t head;		/**< Index of the next free slot (written by the producer) */
+	volatile uint16_t tail;		/**< Index of the oldest element (written by the consumer) */
+} notification_ring_t;
+
+/**
+ * One ring per priority class
+ * The policy of each stream (priority, latest value only) is defined inside notification_defs.h
+ */
+typedef struct
+{
+	notification_ring_t rings[NOTIFICATION_QUEUE_PRIO_COUNT];
+	notification_t* high_slots[NOTIFICATION_QUEUE_HIGH_DEPTH];
+	notification_t* low_slots[NOTIFICATION_QUEUE_DEPTH];
+} notification_queue_t;
+
+void notification_queue_init(notification_queue_t* queue);
+
+/**
+ * @brief Add a notification to the queue according to the policy of its stream
+ * If the stream only keeps its latest value and a value of the same stream is still waiting,
+ * the waiting value is replaced (and freed).
+ * If the ring of the stream is full, the notification is freed.
+ *
+ * Remark: replacing a waiting value is only safe because producer and consumer run inside the same loop
+ *
+ * @retval NOTIFICATION_QUEUE_QUEUED Notification added at the end of the queue
+ * @retval NOTIFICATION_QUEUE_REPLACED Notification replaced a waiting value of the same stream
+ * @retval NOTIFICATION_QUEUE_DROPPED Queue is full, notification has been dropped
+ */
+int notification_queue_push(notification_queue_t* queue, notification_t* notification);
+
+/**
+ * @brief Get the oldest notification of the highest non empty priority without removing it
+ *
+ * @retval NULL if the queue is empty
+ */
+notification_t* notification_queue_peek(notification_queue_t* queue);
+
+/**
+ * @brief Remove (and free) the notification returned by notification_queue_peek
+ */
+void notification_queue_pop(notification_queue_t* queue);
+
+/**
+ * @brief Get the number of notifications stored inside the queue (all priorities)
+ */
+uint16_t notification_queue_get_count(notification_queue_t* queue);
+
+/**
+ * @brief Remove (and free) all the notifications of the queue
+ */
+void notification_queue_clear(notification_queue_t* queue);
+
+/**
+ * @brief Get the policy (NOTIFICATION_LATEST_ONLY, NOTIFICATION_PRIO_LOW flags) of a stream
+ */
+uint8_t notification_queue_get_policy(uint16_t sensor_id);
+
+#endif /* NOTIFICATION_QUEUE_H_ */
@@ -190,7 +190,6 @@ int pasco2_read_co2_ppm(uint16_t* co2_ppm)
 
 int pasco2_soft_reset(uint8_t wait_for_startup)
 {
-	static const uint32_t start_delay = 2000;
 	int8_t result = 0;
 	uint8_t cmd[2] = {0};
 
@@ -204,7 +203,7 @@ int pasco2_soft_reset(uint8_t wait_for_startup)
 
 	if (wait_for_startup != 0)
 	{
-		sys_sleep(start_delay);
+		sys_sleep(PASCO2_STARTUP_DURATION_MS);
 	}
 
 	return 0;
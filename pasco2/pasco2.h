@@ -17,6 +17,12 @@
 
 #define PASCO2_DATA_RDY	(1 << 4)
 
+/**
+ * @def PASCO2_STARTUP_DURATION_MS
+ * @brief Time needed by the sensor to start after a soft reset
+ */
+#define PASCO2_STARTUP_DURATION_MS	2000
+
 #define PASCO2_MEAS_RATE_MIN	5
 #define PASCO2_MEAS_RATE_MAX	4095
 
@@ -15,7 +15,6 @@ void pasco2_app_init(pasco2_read_func_t read, pasco2_write_func_t write, pasco2_
 
 int pasco2_app_start_measurement(pasco2_app_t* app)
 {
-	static const uint16_t refresh_rate_seconds = 5;
 	int retval = pasco2_check_i2c_interface();
 	if (retval != 0) return -1;
 
@@ -23,9 +22,27 @@ int pasco2_app_start_measurement(pasco2_app_t* app)
 	retval = pasco2_soft_reset(1);
 	if (retval != 0) return -2;
 
+	return pasco2_app_start_measurement_after_reset(app);
+}
+
+int pasco2_app_reset()
+{
+	int retval = pasco2_check_i2c_interface();
+	if (retval != 0) return -1;
+
+	retval = pasco2_soft_reset(0);
+	if (retval != 0) return -2;
+
+	return 0;
+}
+
+int pasco2_app_start_measurement_after_reset(pasco2_app_t* app)
+{
+	static const uint16_t refresh_rate_seconds = 5;
+
 	// Get the sensor status and check for error
 	uint8_t sens_sts = 0;
-	retval = pasco2_get_sensor_status(&sens_sts);
+	int retval = pasco2_get_sensor_status(&sens_sts);
 	if (retval != 0) return -3;
 
 	// Check the status
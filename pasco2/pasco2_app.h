@@ -32,6 +32,22 @@ void pasco2_app_init(pasco2_read_func_t read, pasco2_write_func_t write, pasco2_
  */
 int pasco2_app_start_measurement(pasco2_app_t* app);
 
+/**
+ * @brief First step of the non blocking start: check the sensor and send a soft reset (no wait)
+ *
+ * @retval 0 Success, pasco2_app_start_measurement_after_reset can be called PASCO2_STARTUP_DURATION_MS later
+ * @retval != 0 Sensor not responding
+ */
+int pasco2_app_reset();
+
+/**
+ * @brief Second step of the non blocking start: check the status and start the continuous measurement
+ *
+ * @retval 0 Success
+ * @retval != 0 An error occurred
+ */
+int pasco2_app_start_measurement_after_reset(pasco2_app_t* app);
+
 /**
  * @brief Cyclic call to the sensor
  *
@@ -0,0 +1,132 @@
+/*
+ * profiler.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "profiler.h"
+
+#ifdef PROFILER_SUPPORT
+
+#include "hal/hal_timer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static profiler_section_t sections[PROFILER_MAX_SECTIONS];
+static uint32_t missed_ticks = 0;
+static uint32_t tick_overruns = 0;
+static uint32_t tick_period_us = 0;
+
+static const char* const fixed_names[PROFILER_SECTION_SENSORS] =
+{
+	"Tick", "Data ready", "Host main", "BLE events"
+};
+
+static uint16_t get_bucket(uint32_t duration_us)
+{
+	uint16_t bucket = 0;
+	while((duration_us != 0) && (bucket < (PROFILER_HISTOGRAM_BUCKETS - 1)))
+	{
+		duration_us >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+void profiler_init(uint32_t tick_us)
+{
+	hal_timer_init();
+	tick_period_us = tick_us;
+
+	for(uint16_t i = 0; i < PROFILER_MAX_SECTIONS; ++i)
+	{
+		sections[i].name = (i < PROFILER_SECTION_SENSORS) ? fixed_names[i] : NULL;
+	}
+	profiler_reset();
+}
+
+void profiler_set_name(uint16_t section, const char* name)
+{
+	if (section >= PROFILER_MAX_SECTIONS) return;
+	sections[section].name = name;
+}
+
+uint32_t profiler_begin()
+{
+	return hal_timer_get_uticks();
+}
+
+void profiler_end(uint16_t section, uint32_t start)
+{
+	if (section >= PROFILER_MAX_SECTIONS) return;
+
+	uint32_t duration = hal_timer_get_uticks() - start;
+	profiler_section_t* stats = &sections[section];
+
+	if ((stats->count == 0) || (duration < stats->min_us)) stats->min_us = duration;
+	if (duration > stats->max_us) stats->max_us = duration;
+	stats->count++;
+	stats->total_us += duration;
+	stats->histogram[get_bucket(duration)]++;
+
+	if ((section == PROFILER_SECTION_TICK) && (tick_period_us != 0) && (duration > tick_period_us)) tick_overruns++;
+}
+
+void profiler_add_missed_ticks(uint32_t ticks)
+{
+	missed_ticks += ticks;
+}
+
+const profiler_section_t* profiler_get_section(uint16_t section)
+{
+	if (section >= PROFILER_MAX_SECTIONS) return NULL;
+	if (sections[section].name == NULL) return NULL;
+	return &sections[section];
+}
+
+uint32_t profiler_get_missed_ticks()
+{
+	return missed_ticks;
+}
+
+uint32_t profiler_get_tick_overruns()
+{
+	return tick_overruns;
+}
+
+void profiler_reset()
+{
+	for(uint16_t i = 0; i < PROFILER_MAX_SECTIONS; ++i)
+	{
+		const char* name = sections[i].name;
+		memset(&sections[i], 0, sizeof(sections[i]));
+		sections[i].name = name;
+	}
+	missed_ticks = 0;
+	tick_overruns = 0;
+}
+
+void profiler_print()
+{
+	printf("Profiler: missed ticks %lu, tick overruns %lu \r\n",
+			(unsigned long) missed_ticks, (unsigned long) tick_overruns);
+
+	for(uint16_t i = 0; i < PROFILER_MAX_SECTIONS; ++i)
+	{
+		profiler_section_t* stats = &sections[i];
+		if ((stats->name == NULL) || (stats->count == 0)) continue;
+
+		printf("%-12s n %lu, min %lu us, avg %lu us, max %lu us, log2 buckets:", stats->name,
+				(unsigned long) stats->count, (unsigned long) stats->min_us,
+				(unsigned long) (stats->total_us / stats->count), (unsigned long) stats->max_us);
+		for(uint16_t bucket = 0; bucket < PROFILER_HISTOGRAM_BUCKETS; ++bucket)
+		{
+			printf(" %lu", (unsigned long) stats->histogram[bucket]);
+		}
+		printf(" \r\n");
+	}
+}
+
+#endif
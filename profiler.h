@@ -0,0 +1,111 @@
+/*
+ * profiler.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <stdint.h>
+
+/**
+ * Execution time statistics of the main loop
+ *
+ * Only compiled if PROFILER_SUPPORT is defined (see DEFINES inside the Makefile).
+ * Otherwise the PROFILER_xxx macros are empty and the functions are not available.
+ * Times are measured with hal_timer_get_uticks (1us resolution).
+ */
+
+/**
+ * @def PROFILER_MAX_SECTIONS
+ * @brief Number of measured sections (fixed sections + one per sensor of the scheduler)
+ */
+#ifndef PROFILER_MAX_SECTIONS
+#define PROFILER_MAX_SECTIONS		32
+#endif
+
+/**
+ * @def PROFILER_HISTOGRAM_BUCKETS
+ * @brief Bucket 0 counts 0us, bucket n counts [2^(n-1), 2^n[ us, the last bucket has no upper bound
+ */
+#define PROFILER_HISTOGRAM_BUCKETS	16
+
+/**
+ * Sections measured outside of the sensors
+ */
+typedef enum
+{
+	PROFILER_SECTION_TICK,				/**< rutronik_application_do (all the sensors of one tick) */
+	PROFILER_SECTION_DATA_READY,		/**< rutronik_application_process_events */
+	PROFILER_SECTION_HOST_MAIN,			/**< host_main_do */
+	PROFILER_SECTION_BLE_EVENTS,		/**< Processing of the BLE stack events (inside host_main_do) */
+	PROFILER_SECTION_SENSORS			/**< First section of the sensors (index of the sensor inside the scheduler) */
+} profiler_section_e;
+
+typedef struct
+{
+	const char* name;
+	uint32_t count;
+	uint32_t min_us;
+	uint32_t max_us;
+	uint64_t total_us;
+	uint32_t histogram[PROFILER_HISTOGRAM_BUCKETS];
+} profiler_section_t;
+
+#ifdef PROFILER_SUPPORT
+
+void profiler_init(uint32_t tick_us);
+
+/**
+ * @brief Give a name to a section (only the pointer is kept)
+ */
+void profiler_set_name(uint16_t section, const char* name);
+
+uint32_t profiler_begin();
+
+/**
+ * @brief Account the time elapsed since profiler_begin
+ */
+void profiler_end(uint16_t section, uint32_t start);
+
+/**
+ * @brief Account ticks that have not been executed (main loop late by more than one period)
+ */
+void profiler_add_missed_ticks(uint32_t ticks);
+
+/**
+ * @retval NULL Unknown or unused section
+ */
+const profiler_section_t* profiler_get_section(uint16_t section);
+
+uint32_t profiler_get_missed_ticks();
+
+/**
+ * @brief Get the number of ticks whose execution took longer than the tick period
+ */
+uint32_t profiler_get_tick_overruns();
+
+void profiler_reset();
+
+/**
+ * @brief Print the statistics of all the used sections over the debug UART
+ */
+void profiler_print();
+
+#define PROFILER_BEGIN(var)				uint32_t var = profiler_begin()
+#define PROFILER_END(section, var)		profiler_end((section), (var))
+#define PROFILER_SET_NAME(section, name)	profiler_set_name((section), (name))
+#define PROFILER_ADD_MISSED_TICKS(ticks)	profiler_add_missed_ticks(ticks)
+
+#else
+
+#define PROFILER_BEGIN(var)
+#define PROFILER_END(section, var)
+#define PROFILER_SET_NAME(section, name)
+#define PROFILER_ADD_MISSED_TICKS(ticks)
+
+#endif
+
+#endif /* PROFILER_H_ */
@@ -9,6 +9,8 @@
 
 #include "hal_i2c.h"
 #include "hal_sleep.h"
+#include "hal_data_ready.h"
+#include "sensor_scheduler.h"
 
 #include "sht4x/sht4x.h"
 #include "bmp581/bmp581.h"
@@ -47,10 +49,15 @@
 #include "gesture_control.h"
 
 #include "host_main.h"
+#include "notification_defs.h"
 
 // TODO remove me
 #include <stdio.h>
 
+static void init_scheduler(rutronik_application_t* app);
+static void init_data_ready_lines(rutronik_application_t* app);
+static void init_charger_reads(rutronik_application_t* app);
+
 
 static void init_sensors_hal(rutronik_application_t* app)
 {
@@ -73,7 +80,7 @@ static void init_sensors_hal(rutronik_application_t* app)
 #ifdef UM980_SUPPORT
 	hal_uart_init();
 	hal_timer_init();
-	um980_app_init_hal(hal_uart_readable, hal_uart_read, hal_uart_write, hal_timer_get_uticks);
+	um980_app_init_hal(hal_uart_readable, hal_uart_read_available, hal_uart_consume, hal_uart_write, hal_timer_get_time_us);
 #endif
 
 	vcnl403x_init_hal(hal_i2c_read_register, hal_i2c_write);
@@ -99,17 +106,6 @@ static int is_co2_board_available()
 	return 1; // By default always here
 }
 
-#ifdef UM980_SUPPORT
-static int is_um980_board_available()
-{
-	if (um980_app_init() != 0)
-	{
-		return 0;
-	}
-	return 1;
-}
-#endif
-
 static optical_sensor_type_t detect_optical_sensor(void)
 {
     uint16_t id = 0;
@@ -262,7 +258,7 @@ static void init_sensor_fusion(rutronik_application_t* app)
 		return;
 	}
 
-	if (bmi270_app_init(hal_i2c_read, hal_i2c_write, hal_sleep_us) != 0)
+	if (bmi270_app_init(hal_i2c_read_register, hal_i2c_write_register, hal_sleep_us) != 0)
 	{
 		app->sensor_fusion_available = 0;
 		return;
@@ -279,34 +275,6 @@ static void init_sensor_fusion(rutronik_application_t* app)
 	dps310_app_init();
 }
 
-static void init_co2_board(rutronik_application_t* app)
-{
-	int retval = scd41_app_initialise_and_start_measurement(&app->scd41_app);
-	if (retval != 0)
-	{
-		app->co2_available = 0;
-		return;
-	}
-
-	retval = pasco2_app_start_measurement(&app->pasco2_app);
-	if (retval != 0)
-	{
-		app->co2_available = 0;
-		return;
-	}
-}
-
-#ifdef AMS_TMF_SUPPORT
-static void init_ams_osram_board(rutronik_application_t* app)
-{
-	if(tmf8828_app_init_measurement() != 0)
-	{
-		app->ams_tof_available = 0;
-		return;
-	}
-}
-#endif
-
 #ifdef UM980_SUPPORT
 
 static uint8_t um980_packet_available = 0;
@@ -322,25 +290,6 @@ static void um980_nmea_listener(uint8_t* buffer, uint16_t len)
 		}
 	}
 }
-
-static void init_um980_board(rutronik_application_t* app)
-{
-	if (um980_app_set_mode_rover() != 0)
-	{
-		app->um980_available = 0;
-		return;
-	}
-
-	// Request position every second
-	if (um980_app_start_gga_generation(FREQUENCY_1HZ) != 0)
-	{
-		app->um980_available = 0;
-		return;
-	}
-
-	// Install listener
-	um980_app_set_nmea_listener(um980_nmea_listener);
-}
 #endif
 
 static void init_sgp41(rutronik_application_t* app)
@@ -400,403 +349,979 @@ void rutronik_application_init(rutronik_application_t* app)
 	app->rab7_available = 0;
 
 	app->sgp41_state = SGP41_CONDITIONING;
-	app->sgp41_prescaler = 0;
-	app->bme690_prescaler = 0;
-	app->bmp585_prescaler = 0;
-	app->dps368_prescaler = 0;
+	app->sgp41_conditioning_count = 0;
+	app->sgp41_measurement_pending = 0;
+	app->sht4x_measurement_pending = 0;
+	app->sgp40_step = SGP40_IDLE;
+	app->sgp40_voc_value_raw = 0;
 
 	app->optical_sensor_type = OPTICAL_SENSOR_NONE;
 
-	// Init prescalers
-	// 1 Hz prescalers -> shifted by 10ms (to avoid to many I2C read inside one loop)
-	app->sht4x_prescaler = 0;
-	app->sgp40_prescaler = 10;
-	app->bmp581_prescaler = 20;
-	app->scd41_prescaler = 30;
-	app->battery_prescaler = 40;
-	app->pasco2_prescaler = 50;
-	app->dps310_prescaler = 60;
-	app->optical_sensor_prescaler = 70;
-	app->bmm350_prescaler =  0;
-	app->bmi323_prescaler = 0;
-
-	// 10 Hz
-	app->bmi270_prescaler = 0;
-
-	// 5 Hz
-	app->bme688_prescaler = 0;
+	app->ticks = 0;
+	app->booted = 0;
+	app->probe_mask = (1u << RUTRONIK_APP_BOARDS) - 1;
+	app->boards_changed = 0;
+	for(uint16_t i = 0; i < RUTRONIK_APP_BOARDS; ++i)
+	{
+		app->boards[i].failures = 0;
+		app->boards[i].demotions = 0;
+		app->boards[i].probe_interval_ms = RUTRONIK_APP_PROBE_BACKOFF_MIN_MS;
+		app->boards[i].next_probe_tick = 0;
+	}
+
+	app->boot_step = RUTRONIK_APP_BOOT_POWER_UP;
+	app->boot_ticks = 0;
+	app->boot_not_before = 0;
+	app->co2_booting = 0;
+	app->ams_tof_booting = 0;
+	app->um980_attempts = 0;
+	app->data_ready_mask = 0;
 
 	lowpassfilter_init(&app->filtered_voltage, 0.01);
+	init_charger_reads(app);
 
 	init_sensors_hal(app);
 
 	battery_monitor_init();
 
-	if (is_sensor_fusion_board_available() != 0)
-	{
-		app->sensor_fusion_available = 1;
-		init_sensor_fusion(app);
-	}
+	// Sensors of the base board only, the boards are added by the boot steps
+	init_scheduler(app);
+}
+
+/**
+ * @brief Go to the next boot step
+ *
+ * @param [in] not_before_ms Time since RUTRONIK_APP_BOOT_POWER_UP before which the step cannot be performed
+ */
+static void set_boot_step(rutronik_application_t* app, rutronik_app_boot_step_e step, uint32_t not_before_ms)
+{
+	app->boot_step = step;
+	app->boot_not_before = (not_before_ms == 0) ? 0 : RUTRONIK_APP_TICKS_FOR_MS(not_before_ms);
+}
 
-	if (is_co2_board_available() != 0)
+/**
+ * @brief Place the sensors of the available boards and inform the client
+ */
+static void update_plan(rutronik_application_t* app)
+{
+	// Period of the BME690 depends on its configuration
+	if (app->rab7_available)
 	{
-		app->co2_available = 1;
-		init_co2_board(app);
+		uint32_t bme690_period = bme690_app_get_measurement_period();
+		if (bme690_period < RUTRONIK_APP_PERIOD_MS) bme690_period = RUTRONIK_APP_PERIOD_MS;
+		sensor_scheduler_set_period(&app->scheduler, BME690_NOTIFICATION_ID, bme690_period);
 	}
 
-#ifdef AMS_TMF_SUPPORT
-	if (tmf8828_app_is_board_available() != 0)
+	uint16_t overrun_ticks = sensor_scheduler_plan(&app->scheduler);
+	printf("Sensor scheduler: worst tick %lu us, %u ticks over budget\r\n",
+			(unsigned long) sensor_scheduler_get_stats(&app->scheduler)->planned_worst_load_us, overrun_ticks);
+
+	host_main_notify_available_sensors(rutronik_application_get_available_sensors_mask(app), app->booted);
+}
+
+/**
+ * @brief A board has been initialised: enable its data ready lines and place its sensors
+ */
+static void on_board_online(rutronik_application_t* app, rutronik_app_board_e board)
+{
+	app->boards[board].failures = 0;
+	app->boards[board].probe_interval_ms = RUTRONIK_APP_PROBE_BACKOFF_MIN_MS;
+
+	init_data_ready_lines(app);
+	update_plan(app);
+}
+
+static uint8_t is_board_available(rutronik_application_t* app, rutronik_app_board_e board)
+{
+	switch(board)
 	{
-		app->ams_tof_available = 1;
-		init_ams_osram_board(app);
+		case RUTRONIK_APP_BOARD_SENSOR_FUSION: return app->sensor_fusion_available;
+		case RUTRONIK_APP_BOARD_CO2: return app->co2_available;
+		case RUTRONIK_APP_BOARD_AMS_TOF: return app->ams_tof_available;
+		case RUTRONIK_APP_BOARD_OPTICAL: return app->optical_sensor_available;
+		case RUTRONIK_APP_BOARD_RAB7: return app->rab7_available;
+		case RUTRONIK_APP_BOARD_UM980: return app->um980_available;
+		default: return 0;
 	}
-#endif
+}
 
-#ifdef UM980_SUPPORT
-	if (is_um980_board_available() != 0)
+static uint8_t is_board_probed(rutronik_application_t* app, rutronik_app_board_e board)
+{
+	return ((app->probe_mask & (1u << board)) != 0) ? 1 : 0;
+}
+
+/**
+ * @brief Account the result of a read of a board at runtime
+ * After RUTRONIK_APP_BOARD_MAX_FAILURES failures in a row the board is set as absent: its timeouts do not stall the loop anymore.
+ * The scheduler is planned again after the call of the sensors (see apply_board_changes).
+ *
+ * @param [in] result Return value of the driver (negative: error)
+ */
+static void report_board_result(rutronik_application_t* app, rutronik_app_board_e board, int result)
+{
+	rutronik_app_board_health_t* health = &app->boards[board];
+
+	if (result >= 0)
 	{
-		app->um980_available = 1;
-		init_um980_board(app);
+		health->failures = 0;
+		return;
 	}
-#endif
 
+	health->failures++;
+	if (health->failures < RUTRONIK_APP_BOARD_MAX_FAILURES) return;
 
-	app->optical_sensor_type = detect_optical_sensor();
-	if (app->optical_sensor_type != OPTICAL_SENSOR_NONE)
+	switch(board)
 	{
-	    int ret = init_optical_sensor(app);
-	    printf("optical init ret=%d type=%d\r\n", ret, app->optical_sensor_type);
-	
-	    if (ret == 0)
-	    {
-	        app->optical_sensor_available = 1;
-	        printf("optical sensor available = 1\r\n");
-	    }
-	    else
-	    {
-	        app->optical_sensor_type = OPTICAL_SENSOR_NONE;
-	        app->optical_sensor_available = 0;
-	        printf("optical sensor init failed\r\n");
-	    }
-	}
-	
-		if (is_rab7_available() != 0)
-		{
-			printf("RAB7 available!\r\n");
-			app->rab7_available = 1;
-			init_rab7(app);
-		}
+		case RUTRONIK_APP_BOARD_SENSOR_FUSION: app->sensor_fusion_available = 0; break;
+		case RUTRONIK_APP_BOARD_CO2: app->co2_available = 0; break;
+		case RUTRONIK_APP_BOARD_AMS_TOF: app->ams_tof_available = 0; break;
+		case RUTRONIK_APP_BOARD_OPTICAL:
+			app->optical_sensor_available = 0;
+			app->optical_sensor_type = OPTICAL_SENSOR_NONE;
+			break;
+		case RUTRONIK_APP_BOARD_RAB7: app->rab7_available = 0; break;
+		case RUTRONIK_APP_BOARD_UM980: app->um980_available = 0; break;
+		default: break;
 	}
 
+	printf("Board %u demoted after %u failures\r\n", board, health->failures);
 
+	health->failures = 0;
+	health->demotions++;
+	health->probe_interval_ms = RUTRONIK_APP_PROBE_BACKOFF_MIN_MS;
+	health->next_probe_tick = app->ticks + RUTRONIK_APP_TICKS_FOR_MS(RUTRONIK_APP_PROBE_BACKOFF_MIN_MS);
+	app->boards_changed = 1;
 
-uint32_t rutronik_application_get_available_sensors_mask(rutronik_application_t* app)
+	// Failures might come from a blocked bus
+	(void) hal_i2c_recover();
+}
+
+/**
+ * @brief Plan the scheduler again if a board has been demoted (not done inside the call of a sensor)
+ */
+static void apply_board_changes(rutronik_application_t* app)
 {
-		uint32_t mask = 0;	
+	if (app->boards_changed == 0) return;
 
-		mask	|=	(uint32_t) app->sensor_fusion_available;
-		mask	|= ((uint32_t) app->co2_available) << 1;
-		mask	|= ((uint32_t) app->ams_tof_available) << 2;
-			// << 3 is for radar board
-		mask	|= ((uint32_t) app->um980_available) << 4;
-		mask	|= ((uint32_t) app->optical_sensor_available) << 5;
-		mask	|= ((uint32_t) app->rab7_available) << 6;
+	app->boards_changed = 0;
+	update_plan(app);
+}
 
-    switch (app->optical_sensor_type)
-    {
-        case OPTICAL_SENSOR_VCNL3682XX:
-            mask |= (1u << 7);
-            break;
+/**
+ * @brief End of a boot sequence: the boards that are still absent are probed again later (exponential backoff)
+ */
+static void end_boot(rutronik_application_t* app)
+{
+	for(uint16_t i = 0; i < RUTRONIK_APP_BOARDS; ++i)
+	{
+		rutronik_app_board_e board = (rutronik_app_board_e) i;
+		if ((is_board_probed(app, board) == 0) || (is_board_available(app, board) != 0)) continue;
 
-        case OPTICAL_SENSOR_VEML6031X00:
-            mask |= (1u << 10);
-            break;
+		rutronik_app_board_health_t* health = &app->boards[board];
+		health->next_probe_tick = app->ticks + RUTRONIK_APP_TICKS_FOR_MS(health->probe_interval_ms);
+		health->probe_interval_ms *= 2;
+		if (health->probe_interval_ms > RUTRONIK_APP_PROBE_BACKOFF_MAX_MS) health->probe_interval_ms = RUTRONIK_APP_PROBE_BACKOFF_MAX_MS;
+	}
 
-        case OPTICAL_SENSOR_VEML6046X00:
-            mask |= (1u << 11);
-            break;
+	app->probe_mask = 0;
+	set_boot_step(app, RUTRONIK_APP_BOOT_DONE, 0);
 
-        case OPTICAL_SENSOR_VEML6030:
-            mask |= (1u << 12);
-            break;
+	if (app->booted == 0)
+	{
+		app->booted = 1;
+		printf("Boot done, sensor mask: %lx\r\n", (unsigned long) rutronik_application_get_available_sensors_mask(app));
+		host_main_notify_available_sensors(rutronik_application_get_available_sensors_mask(app), 1);
+	}
+}
 
-        case OPTICAL_SENSOR_VCNL403X:
-            mask |= (1u << 13);
-            break;
+/**
+ * @def HOTPLUG_BOARDS_MASK
+ * @brief Boards probed again at runtime
+ */
+#define HOTPLUG_BOARDS_MASK		(((1u << RUTRONIK_APP_BOARDS) - 1) & ~(1u << RUTRONIK_APP_BOARD_UM980))
 
-        default:
-            break;
-    }
+/**
+ * @brief Start a boot sequence for the absent boards whose backoff elapsed
+ */
+static void check_hotplug(rutronik_application_t* app)
+{
+	uint8_t mask = 0;
 
-    return mask;
-}
+	for(uint16_t i = 0; i < RUTRONIK_APP_BOARDS; ++i)
+	{
+		rutronik_app_board_e board = (rutronik_app_board_e) i;
+		if (((HOTPLUG_BOARDS_MASK & (1u << board)) == 0) || (is_board_available(app, board) != 0)) continue;
+		if ((int32_t)(app->ticks - app->boards[board].next_probe_tick) < 0) continue;
 
+		mask |= (uint8_t)(1u << board);
+	}
 
-#ifdef AMS_TMF_SUPPORT
-void rutronik_application_set_tmf8828_mode(rutronik_application_t* app, uint8_t mode)
-{
-	if (app->ams_tof_available == 0) return;
+	if (mask == 0) return;
 
-	tmf8828_app_request_new_mode(mode);
+	app->probe_mask = mask;
+	set_boot_step(app, RUTRONIK_APP_BOOT_POWER_UP, 0);
 }
-#endif
 
-static int measure_sgp40_values(rutronik_application_t* app, float temperature, float humidity, uint16_t * voc_value_raw, uint16_t * voc_value_compensated, int32_t * gas_index)
+/**
+ * @brief Get the number of calls before the next probe of an absent board
+ */
+static uint32_t get_ticks_before_probe(rutronik_application_t* app)
 {
-	if (sgp40_measure_raw_signal_without_compensation(voc_value_raw) != 0) return -1;
-	if (sgp40_measure_with_compensation(temperature, humidity, voc_value_compensated) != 0) return -2;
+	uint32_t ticks = UINT32_MAX;
 
-	GasIndexAlgorithm_process(&app->gas_index_voc_params, *voc_value_compensated, gas_index);
+	for(uint16_t i = 0; i < RUTRONIK_APP_BOARDS; ++i)
+	{
+		rutronik_app_board_e board = (rutronik_app_board_e) i;
+		if (((HOTPLUG_BOARDS_MASK & (1u << board)) == 0) || (is_board_available(app, board) != 0)) continue;
 
-	return 0;
+		int32_t remaining = (int32_t)(app->boards[board].next_probe_tick - app->ticks);
+		if (remaining <= 0) return 0;
+		if ((uint32_t) remaining < ticks) ticks = (uint32_t) remaining;
+	}
+	return ticks;
 }
 
 /**
- * Remark: this function is called every 10ms (100Hz)
+ * @brief End of the UM980 steps (the board is available or not)
  */
-void rutronik_application_do(rutronik_application_t* app)
+static void end_um980_boot(rutronik_application_t* app)
 {
-	/**
-	 * SHT41
-	 */
-	if (app->sht4x_prescaler == 0)
-	{
-		if ((app->sensor_fusion_available != 0)
-				|| (app->rab7_available != 0))
-		{
-			if (sht4x_get_temperature_and_humidity(&(app->sht4x_temperature), &(app->sht4x_humidity)) == 0)
-				host_main_add_notification(notification_fabric_create_for_sht4x(app->sht4x_temperature, app->sht4x_humidity));
-		}
-	}
-	// 1 Hz prescaler (100 Hz / 100 = 1 Hz)
-	app->sht4x_prescaler++;
-	if (app->sht4x_prescaler >= 100) app->sht4x_prescaler = 0;
+	app->um980_attempts = 0;
+	set_boot_step(app, RUTRONIK_APP_BOOT_AMS_TOF, (app->ams_tof_booting != 0) ? TMF8828_COLD_START_DURATION_MS : 0);
+}
 
+/**
+ * @brief Perform the next step of the initialisation of the boards
+ * Waits are counted in calls: a late main loop only makes them longer
+ */
+static void do_boot_step(rutronik_application_t* app)
+{
+	app->boot_ticks++;
+	if (app->boot_ticks < app->boot_not_before) return;
 
-	/**
-	 * SGP40
-	 */
-	if (app->sgp40_prescaler == 0)
+	switch(app->boot_step)
 	{
-		if (app->sensor_fusion_available != 0)
+		case RUTRONIK_APP_BOOT_POWER_UP:
 		{
-			float temperature = 0;
-			float humidity = 0;
-			uint16_t voc_value_raw = 0;
-			uint16_t voc_value_compensated = 0;
-			int32_t gas_index = 0;
+			app->boot_ticks = 0;
+
+			// The start-up of the CO2 board (PASCO2 soft reset) and the cold start of the TMF8828 run during the next steps
+			if (is_board_probed(app, RUTRONIK_APP_BOARD_CO2) && (is_co2_board_available() != 0) && (pasco2_app_reset() == 0))
+			{
+				app->co2_booting = 1;
+			}
 
-			if (measure_sgp40_values(app, temperature, humidity, &voc_value_raw, &voc_value_compensated, &gas_index) == 0)
-				host_main_add_notification(notification_fabric_create_for_sgp40(voc_value_raw, voc_value_compensated, (uint16_t) gas_index));
+#ifdef AMS_TMF_SUPPORT
+			if (is_board_probed(app, RUTRONIK_APP_BOARD_AMS_TOF) && (tmf8828_app_is_board_available() != 0))
+			{
+				app->ams_tof_booting = 1;
+				tmf8828_app_power_off();
+			}
+#endif
+			set_boot_step(app, RUTRONIK_APP_BOOT_SENSOR_FUSION, 0);
+			break;
 		}
-	}
-	// 1 Hz prescaler (100 Hz / 100 = 1 Hz)
-	app->sgp40_prescaler++;
-	if (app->sgp40_prescaler >= 100) app->sgp40_prescaler = 0;
-
-	/**
-	 * BMP581
-	 */
-	if (app->bmp581_prescaler == 0)
-	{
-		float temperature = 0;
-		float pressure = 0;
 
-		if (bmp581_read_pressure_and_temperature(&pressure, &temperature) == 0)
-			host_main_add_notification(notification_fabric_create_for_bmp581(pressure, temperature));
-	}
-	// 1 Hz prescaler (100 Hz / 100 = 1 Hz)
-	app->bmp581_prescaler++;
-	if (app->bmp581_prescaler >= 100) app->bmp581_prescaler = 0;
-
-	/**
-	 * SCD41
-	 */
-	if (app->scd41_prescaler == 0)
-	{
-		if(app->co2_available != 0)
+		case RUTRONIK_APP_BOOT_SENSOR_FUSION:
 		{
-			if (scd41_app_do(&app->scd41_app) == 0)
-				host_main_add_notification(
-						notification_fabric_create_for_scd41(app->scd41_app.value.co2_ppm, app->scd41_app.value.temperature, app->scd41_app.value.humidity));
+			if (is_board_probed(app, RUTRONIK_APP_BOARD_SENSOR_FUSION) && (is_sensor_fusion_board_available() != 0))
+			{
+				app->sensor_fusion_available = 1;
+				init_sensor_fusion(app);
+				if (app->sensor_fusion_available) on_board_online(app, RUTRONIK_APP_BOARD_SENSOR_FUSION);
+			}
+			set_boot_step(app, RUTRONIK_APP_BOOT_OPTICAL, 0);
+			break;
 		}
-	}
-	// 1 Hz prescaler (100 Hz / 100 = 1 Hz)
-	app->scd41_prescaler++;
-	if (app->scd41_prescaler >= 100) app->scd41_prescaler = 0;
-
-	/**
-	 * Battery monitor
-	 */
-	if (app->battery_prescaler == 0)
-	{
-		// Get the battery voltage
-		uint16_t battery_voltage = battery_monitor_get_voltage_mv();
-
-		charge_stat_t charge_stat;
-		dio_get_status(&charge_stat);
-
-		chrg_fault_t chrg_fault;
-		dio_get_fault(&chrg_fault);
-
-		uint8_t dio_status;
-		dio_monitor_read_raw(&dio_status);
-
-		lowpassfilter_feed(&app->filtered_voltage, battery_voltage);
-		battery_voltage = lowpassfilter_get_value(&app->filtered_voltage);
 
-		host_main_add_notification(
-				notification_fabric_create_for_battery_monitor(battery_voltage, (uint8_t) charge_stat, (uint8_t) chrg_fault, dio_status));
-	}
-	// 1 Hz prescaler (100 Hz / 100 = 1 Hz)
-	app->battery_prescaler++;
-	if (app->battery_prescaler >= 100) app->battery_prescaler = 0;
-
-	/**
-	 * PAS CO2
-	 */
-	if (app->pasco2_prescaler == 0)
-	{
-		if(app->co2_available != 0)
+		case RUTRONIK_APP_BOOT_OPTICAL:
 		{
-			if (pasco2_app_do(&app->pasco2_app) == 0)
-				host_main_add_notification(
-						notification_fabric_create_for_pasco2(app->pasco2_app.co2_ppm));
+			if (is_board_probed(app, RUTRONIK_APP_BOARD_OPTICAL))
+			{
+				app->optical_sensor_type = detect_optical_sensor();
+				if (app->optical_sensor_type != OPTICAL_SENSOR_NONE)
+				{
+				    int ret = init_optical_sensor(app);
+				    printf("optical init ret=%d type=%d\r\n", ret, app->optical_sensor_type);
+
+				    if (ret == 0)
+				    {
+				        app->optical_sensor_available = 1;
+				        printf("optical sensor available = 1\r\n");
+				        on_board_online(app, RUTRONIK_APP_BOARD_OPTICAL);
+				    }
+				    else
+				    {
+				        app->optical_sensor_type = OPTICAL_SENSOR_NONE;
+				        app->optical_sensor_available = 0;
+				        printf("optical sensor init failed\r\n");
+				    }
+				}
+			}
+			set_boot_step(app, RUTRONIK_APP_BOOT_RAB7, 0);
+			break;
 		}
-	}
-	// 1 Hz prescaler (100 Hz / 100 = 1 Hz)
-	app->pasco2_prescaler++;
-	if (app->pasco2_prescaler >= 100) app->pasco2_prescaler = 0;
-
 
-	/**
-	 * DPS310
-	 */
-	if (app->dps310_prescaler == 0)
-	{
-		if (app->sensor_fusion_available)
+		case RUTRONIK_APP_BOOT_RAB7:
 		{
-			if (dps310_app_do() == 0)
+			if (is_board_probed(app, RUTRONIK_APP_BOARD_RAB7) && (is_rab7_available() != 0))
 			{
-				float pressure = 0;
-				float temperature = 0;
-				dps310_app_get_last_values(&temperature, &pressure);
-				host_main_add_notification(notification_fabric_create_for_dps310(pressure, temperature));
+				printf("RAB7 available!\r\n");
+				app->rab7_available = 1;
+				init_rab7(app);
+				if (app->rab7_available) on_board_online(app, RUTRONIK_APP_BOARD_RAB7);
 			}
+			set_boot_step(app, RUTRONIK_APP_BOOT_UM980, 0);
+			break;
 		}
-	}
-	// 1 Hz prescaler (100 Hz / 100 = 1 Hz)
-	app->dps310_prescaler++;
-	if (app->dps310_prescaler >= 100) app->dps310_prescaler = 0;
 
+		case RUTRONIK_APP_BOOT_UM980:
+		{
+#ifdef UM980_SUPPORT
+			if (is_board_probed(app, RUTRONIK_APP_BOARD_UM980))
+			{
+				// Stop the messages (correction and position) first
+				app->um980_attempts++;
+				if (um980_app_send_command(UM980_APP_CMD_UNLOG) == 0)
+				{
+					set_boot_step(app, RUTRONIK_APP_BOOT_UM980_UNLOG, 0);
+					break;
+				}
+			}
+#endif
+			end_um980_boot(app);
+			break;
+		}
 
-	/**
-	 * BMI270
-	 */
-	if (app->bmi270_prescaler == 0)
-	{
-		if (app->sensor_fusion_available)
+		case RUTRONIK_APP_BOOT_UM980_UNLOG:
 		{
-			struct bmi2_sensor_data data[2] = { { 0 } };
-			data[ACCEL].type = BMI2_ACCEL;
-			data[GYRO].type = BMI2_GYRO;
+#ifdef UM980_SUPPORT
+			int retval = um980_app_poll_command();
+			if (retval == 0) break;
 
-			if (bmi270_app_get_sensor_data(data, 2) == 0)
+			if (retval < 0)
 			{
-				host_main_add_notification(
-						notification_fabric_create_for_bmi270(
-								data[ACCEL].sens_data.acc.x, data[ACCEL].sens_data.acc.y, data[ACCEL].sens_data.acc.z,
-								data[GYRO].sens_data.gyr.x, data[GYRO].sens_data.gyr.y, data[GYRO].sens_data.gyr.z));
+				// The first command can fail because of the start-up of the module
+				um980_app_reset();
+				if (app->um980_attempts < UM980_APP_UNLOG_ATTEMPTS)
+				{
+					// Relative to this step
+					uint32_t elapsed_ms = app->boot_ticks * RUTRONIK_APP_PERIOD_MS;
+					set_boot_step(app, RUTRONIK_APP_BOOT_UM980, elapsed_ms + UM980_APP_UNLOG_RETRY_MS);
+					break;
+				}
+			}
+			else if (um980_app_send_command(UM980_APP_CMD_MODE_ROVER) == 0)
+			{
+				set_boot_step(app, RUTRONIK_APP_BOOT_UM980_ROVER, 0);
+				break;
 			}
+#endif
+			end_um980_boot(app);
+			break;
 		}
-	}
-	// 10 Hz prescaler (100 Hz / 10 = 10 Hz)
-	app->bmi270_prescaler++;
-	if (app->bmi270_prescaler >= 10) app->bmi270_prescaler = 0;
-
 
-	/**
-	 * BME688
-	 */
-	if (app->bme688_prescaler == 0)
-	{
-#ifdef BME688_SUPPORT
-		if (app->sensor_fusion_available)
+		case RUTRONIK_APP_BOOT_UM980_ROVER:
 		{
-			if(bme688_app_do(&(app->bme688_app)) == 0)
+#ifdef UM980_SUPPORT
+			int retval = um980_app_poll_command();
+			if (retval == 0) break;
+
+			// Request position every second
+			if ((retval > 0) && (um980_app_send_command(um980_app_get_gga_command(FREQUENCY_1HZ)) == 0))
 			{
-				bme688_scan_data_t last_data;
-				bme688_copy_scan_data(&(app->bme688_app.last_data), &last_data);
-				host_main_add_notification(
-						notification_fabric_create_for_bme688(&last_data));
+				set_boot_step(app, RUTRONIK_APP_BOOT_UM980_GGA, 0);
+				break;
 			}
-		}
 #endif
-	}
-	// 5 Hz prescaler (100 Hz / 20 = 5 Hz)
-	app->bme688_prescaler++;
-	if (app->bme688_prescaler >= 20) app->bme688_prescaler = 0;
+			end_um980_boot(app);
+			break;
+		}
 
-#ifdef AMS_TMF_SUPPORT
-	/**
-	 * In order to achieve high number of values per seconds
-	 * the values of the TMF8828 are continuously pushed
-	 */
-	if(app->ams_tof_available != 0)
-	{
-		if (tmf8828_app_do() == 0)
+		case RUTRONIK_APP_BOOT_UM980_GGA:
 		{
-			if (tmf8828_app_is_mode_8x8())
+#ifdef UM980_SUPPORT
+			int retval = um980_app_poll_command();
+			if (retval == 0) break;
+
+			if (retval > 0)
 			{
-				host_main_add_notification(
-						notification_fabric_create_for_tmf8828_8x8_mode(tmpf8828_get_last_8x8_results()));
+				um980_app_set_nmea_listener(um980_nmea_listener);
+				app->um980_available = 1;
+				on_board_online(app, RUTRONIK_APP_BOARD_UM980);
 			}
-			else
+#endif
+			end_um980_boot(app);
+			break;
+		}
+
+		case RUTRONIK_APP_BOOT_AMS_TOF:
+		{
+#ifdef AMS_TMF_SUPPORT
+			if (app->ams_tof_booting != 0)
 			{
-				host_main_add_notification(
-						notification_fabric_create_for_tmf8828(tmpf8828_get_last_results()));
+				app->ams_tof_booting = 0;
+				if (tmf8828_app_start_measurement() == 0)
+				{
+					app->ams_tof_available = 1;
+					on_board_online(app, RUTRONIK_APP_BOARD_AMS_TOF);
+				}
 			}
-		}
-	}
 #endif
+			set_boot_step(app, RUTRONIK_APP_BOOT_SCD41_STOP, (app->co2_booting != 0) ? SCD41_BOOT_DURATION_MS : 0);
+			break;
+		}
 
-#ifdef UM980_SUPPORT
-	if (app->um980_available != 0)
-	{
-		if (um980_app_do() != 0)
+		case RUTRONIK_APP_BOOT_SCD41_STOP:
 		{
-			um980_app_reset();
+			if ((app->co2_booting != 0) && (scd41_app_stop_measurement(&app->scd41_app) != 0))
+			{
+				app->co2_booting = 0;
+			}
+
+			// Relative to this step
+			uint32_t elapsed_ms = app->boot_ticks * RUTRONIK_APP_PERIOD_MS;
+			set_boot_step(app, RUTRONIK_APP_BOOT_SCD41_START, (app->co2_booting != 0) ? (elapsed_ms + SCD41_STOP_DURATION_MS) : 0);
+			break;
 		}
 
-		if (um980_packet_available != 0)
+		case RUTRONIK_APP_BOOT_SCD41_START:
 		{
-			um980_packet_available = 0;
-			host_main_add_notification(
-					notification_fabric_create_for_um980(&um980_last_packet));
+			if ((app->co2_booting != 0) && (scd41_app_start_measurement(&app->scd41_app) != 0))
+			{
+				app->co2_booting = 0;
+			}
+			set_boot_step(app, RUTRONIK_APP_BOOT_PASCO2, (app->co2_booting != 0) ? PASCO2_STARTUP_DURATION_MS : 0);
+			break;
 		}
-	}
-#endif
 
-	/**
-	 * Optical sensor
-	 */
-	if (app->optical_sensor_prescaler == 0)
-	{
-		if (app->optical_sensor_available)
+		case RUTRONIK_APP_BOOT_PASCO2:
 		{
-			uint16_t v1 = 0;
-			uint16_t v2 = 0;
-			uint16_t v3 = 0;
-			uint16_t v4 = 0;
-
-			switch (app->optical_sensor_type)
-{
+			if (app->co2_booting != 0)
+			{
+				app->co2_booting = 0;
+				if (pasco2_app_start_measurement_after_reset(&app->pasco2_app) == 0)
+				{
+					app->co2_available = 1;
+					on_board_online(app, RUTRONIK_APP_BOARD_CO2);
+				}
+			}
+			end_boot(app);
+			break;
+		}
+
+		case RUTRONIK_APP_BOOT_DONE:
+		default:
+			break;
+	}
+}
+
+uint8_t rutronik_application_is_boot_done(rutronik_application_t* app)
+{
+	return app->booted;
+}
+
+uint32_t rutronik_application_get_available_sensors_mask(rutronik_application_t* app)
+{
+		uint32_t mask = 0;	
+
+		mask	|=	(uint32_t) app->sensor_fusion_available;
+		mask	|= ((uint32_t) app->co2_available) << 1;
+		mask	|= ((uint32_t) app->ams_tof_available) << 2;
+			// << 3 is for radar board
+		mask	|= ((uint32_t) app->um980_available) << 4;
+		mask	|= ((uint32_t) app->optical_sensor_available) << 5;
+		mask	|= ((uint32_t) app->rab7_available) << 6;
+
+    switch (app->optical_sensor_type)
+    {
+        case OPTICAL_SENSOR_VCNL3682XX:
+            mask |= (1u << 7);
+            break;
+
+        case OPTICAL_SENSOR_VEML6031X00:
+            mask |= (1u << 10);
+            break;
+
+        case OPTICAL_SENSOR_VEML6046X00:
+            mask |= (1u << 11);
+            break;
+
+        case OPTICAL_SENSOR_VEML6030:
+            mask |= (1u << 12);
+            break;
+
+        case OPTICAL_SENSOR_VCNL403X:
+            mask |= (1u << 13);
+            break;
+
+        default:
+            break;
+    }
+
+    return mask;
+}
+
+
+#ifdef AMS_TMF_SUPPORT
+void rutronik_application_set_tmf8828_mode(rutronik_application_t* app, uint8_t mode)
+{
+	if (app->ams_tof_available == 0) return;
+
+	tmf8828_app_request_new_mode(mode);
+}
+#endif
+
+/**
+ * @brief Check if the client subscribed to the values of the detected optical sensor
+ */
+static uint8_t is_optical_sensor_subscribed(rutronik_application_t* app)
+{
+	switch (app->optical_sensor_type)
+	{
+		case OPTICAL_SENSOR_VCNL3682XX:
+			return host_main_is_subscribed(VCNL3682XX_NOTIFICATION_ID);
+		case OPTICAL_SENSOR_VCNL403X:
+			return host_main_is_subscribed(VCNL403X_NOTIFICATION_ID);
+		case OPTICAL_SENSOR_VEML6031X00:
+			return host_main_is_subscribed(VEML6031X00_NOTIFICATION_ID);
+		case OPTICAL_SENSOR_VEML6046X00:
+			return host_main_is_subscribed(VEML6046X00_NOTIFICATION_ID);
+		case OPTICAL_SENSOR_VEML6030:
+			return host_main_is_subscribed(VEML6030_NOTIFICATION_ID);
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Sensor tasks called by the scheduler
+ * The context is the rutronik_application_t structure.
+ * Sensors are only read if a client subscribed to their values (see host_main_is_subscribed)
+ */
+
+static uint8_t is_sensor_fusion_used(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return app->sensor_fusion_available;
+}
+
+static uint8_t is_co2_board_used(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return app->co2_available;
+}
+
+static uint8_t is_rab7_used(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return app->rab7_available;
+}
+
+static uint8_t is_sht4x_used(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return ((app->sensor_fusion_available != 0) || (app->rab7_available != 0)) ? 1 : 0;
+}
+
+static uint8_t is_always_used(void* context)
+{
+	return 1;
+}
+
+#ifdef AMS_TMF_SUPPORT
+static uint8_t is_ams_tof_used(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return app->ams_tof_available;
+}
+#endif
+
+/**
+ * @brief Check if a sensor is read on the edges of its data ready line (see rutronik_application_process_events)
+ */
+static uint8_t is_data_ready_used(rutronik_application_t* app, hal_data_ready_line_e line)
+{
+	return ((app->data_ready_mask & (1u << line)) != 0) ? 1 : 0;
+}
+
+/**
+ * Sensors with a data ready line are polled by the scheduler until their line proved to be connected
+ */
+static uint8_t is_bmi270_polled(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return ((app->sensor_fusion_available != 0) && (is_data_ready_used(app, HAL_DATA_READY_BMI270) == 0)) ? 1 : 0;
+}
+
+static uint8_t is_bmi323_polled(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return ((app->rab7_available != 0) && (is_data_ready_used(app, HAL_DATA_READY_BMI323) == 0)) ? 1 : 0;
+}
+
+#ifdef AMS_TMF_SUPPORT
+static uint8_t is_tmf8828_polled(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return ((app->ams_tof_available != 0) && (is_data_ready_used(app, HAL_DATA_READY_TMF8828) == 0)) ? 1 : 0;
+}
+#endif
+
+#ifdef UM980_SUPPORT
+static uint8_t is_um980_used(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return app->um980_available;
+}
+#endif
+
+static uint8_t is_optical_sensor_used(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	return app->optical_sensor_available;
+}
+
+/**
+ * SHT41
+ * The result is fetched some ticks after the start of the measurement (no wait inside the loop)
+ */
+static uint16_t run_sht4x(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (app->sht4x_measurement_pending != 0)
+	{
+		app->sht4x_measurement_pending = 0;
+		if (sht4x_fetch_temperature_and_humidity(&(app->sht4x_temperature), &(app->sht4x_humidity)) == 0)
+			host_main_add_notification(notification_fabric_create_for_sht4x(app->sht4x_temperature, app->sht4x_humidity));
+		return 0;
+	}
+
+	// SHT4x values are also used for the SGP41 compensation
+	if (host_main_is_subscribed(SHT4X_NOTIFICATION_ID) || host_main_is_subscribed(SGP41_NOTIFICATION_ID))
+	{
+		if (sht4x_start_measurement() == 0)
+		{
+			app->sht4x_measurement_pending = 1;
+			return RUTRONIK_APP_TICKS_FOR_MS(SHT4X_MEASUREMENT_DURATION_MS);
+		}
+	}
+	return 0;
+}
+
+/**
+ * SGP40
+ * Both measurements last SGP40_MEASUREMENT_DURATION_MS: the second one is started when the first one is fetched,
+ * the notification is generated when the second one is fetched
+ */
+static uint16_t run_sgp40(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+	static const uint16_t sgp40_ticks = RUTRONIK_APP_TICKS_FOR_MS(SGP40_MEASUREMENT_DURATION_MS);
+
+	// Compensation is done with default values (0 degC, 0 %RH)
+	const float temperature = 0.f;
+	const float humidity = 0.f;
+
+	switch(app->sgp40_step)
+	{
+		case SGP40_WAIT_RAW:
+			app->sgp40_step = SGP40_IDLE;
+			if (sgp40_fetch_measurement(&app->sgp40_voc_value_raw) != 0) return 0;
+			if (sgp40_start_measurement_with_compensation(temperature, humidity) != 0) return 0;
+			app->sgp40_step = SGP40_WAIT_COMPENSATED;
+			return sgp40_ticks;
+
+		case SGP40_WAIT_COMPENSATED:
+		{
+			uint16_t voc_value_compensated = 0;
+			int32_t gas_index = 0;
+
+			app->sgp40_step = SGP40_IDLE;
+			if (sgp40_fetch_measurement(&voc_value_compensated) != 0) return 0;
+
+			GasIndexAlgorithm_process(&app->gas_index_voc_params, voc_value_compensated, &gas_index);
+			host_main_add_notification(notification_fabric_create_for_sgp40(app->sgp40_voc_value_raw, voc_value_compensated, (uint16_t) gas_index));
+			return 0;
+		}
+
+		default:
+			if (host_main_is_subscribed(SGP40_NOTIFICATION_ID) && (sgp40_start_measurement_without_compensation() == 0))
+			{
+				app->sgp40_step = SGP40_WAIT_RAW;
+				return sgp40_ticks;
+			}
+			return 0;
+	}
+}
+
+/**
+ * BMP581
+ */
+static uint16_t run_bmp581(void* context)
+{
+	if (host_main_is_subscribed(BMP581_NOTIFICATION_ID))
+	{
+		float temperature = 0;
+		float pressure = 0;
+
+		if (bmp581_read_pressure_and_temperature(&pressure, &temperature) == 0)
+			host_main_add_notification(notification_fabric_create_for_bmp581(pressure, temperature));
+	}
+	return 0;
+}
+
+/**
+ * SCD41
+ * A started read sequence is continued at the next ticks (one I2C command per tick)
+ */
+static uint16_t run_scd41(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(SCD41_NOTIFICATION_ID) || scd41_app_is_busy(&app->scd41_app))
+	{
+		int retval = scd41_app_do(&app->scd41_app);
+		report_board_result(app, RUTRONIK_APP_BOARD_CO2, retval);
+		if (retval == 0)
+			host_main_add_notification(
+					notification_fabric_create_for_scd41(app->scd41_app.value.co2_ppm, app->scd41_app.value.temperature, app->scd41_app.value.humidity));
+	}
+
+	return scd41_app_is_busy(&app->scd41_app) ? RUTRONIK_APP_TICKS_FOR_MS(SCD41_COMMAND_DURATION_MS) : 0;
+}
+
+/**
+ * Battery monitor
+ */
+/**
+ * @brief Called once both charger registers have been read (transactions executed back-to-back)
+ */
+static void on_charger_registers_read(hal_i2c_transaction_t* transaction)
+{
+	rutronik_application_t* app = (rutronik_application_t*) transaction->context;
+
+	if ((app->charger_control_read.result != 0) || (app->charger_monitor_read.result != 0)) return;
+
+	charge_stat_t charge_stat = (charge_stat_t)((app->charger_control & CTRL0_STAT) >> 4);
+	chrg_fault_t chrg_fault = (chrg_fault_t)(app->charger_control & CTRL0_CHG_FAULT);
+
+	host_main_add_notification(
+			notification_fabric_create_for_battery_monitor(app->battery_voltage, (uint8_t) charge_stat, (uint8_t) chrg_fault, app->charger_monitor));
+}
+
+static void init_charger_reads(rutronik_application_t* app)
+{
+	app->charger_registers[0] = CONTROL0;
+	app->charger_registers[1] = MONITOR_REG;
+
+	hal_i2c_transaction_t* control = &app->charger_control_read;
+	control->address = DIO_SLAVE_ADDR;
+	control->tx_data = &app->charger_registers[0];
+	control->tx_len = 1;
+	control->rx_data = &app->charger_control;
+	control->rx_len = 1;
+	control->callback = NULL;
+	control->context = app;
+	control->result = 0;
+
+	hal_i2c_transaction_t* monitor = &app->charger_monitor_read;
+	monitor->address = DIO_SLAVE_ADDR;
+	monitor->tx_data = &app->charger_registers[1];
+	monitor->tx_len = 1;
+	monitor->rx_data = &app->charger_monitor;
+	monitor->rx_len = 1;
+	monitor->callback = on_charger_registers_read;
+	monitor->context = app;
+	monitor->result = 0;
+}
+
+/**
+ * Battery monitor
+ * The charger registers are read asynchronously: the notification is added by on_charger_registers_read
+ */
+static uint16_t run_battery_monitor(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(BATT_NOTIFICATION_ID))
+	{
+		// Get the battery voltage
+		uint16_t battery_voltage = battery_monitor_get_voltage_mv();
+
+		lowpassfilter_feed(&app->filtered_voltage, battery_voltage);
+		app->battery_voltage = lowpassfilter_get_value(&app->filtered_voltage);
+
+		// Previous reads still in progress (bus stuck): skipped this time
+		if (app->charger_monitor_read.result == HAL_I2C_PENDING) return 0;
+
+		if (hal_i2c_submit(&app->charger_control_read) == 0)
+		{
+			(void) hal_i2c_submit(&app->charger_monitor_read);
+		}
+	}
+	return 0;
+}
+
+/**
+ * PAS CO2
+ */
+static uint16_t run_pasco2(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(PASCO2_NOTIFICATION_ID))
+	{
+		int retval = pasco2_app_do(&app->pasco2_app);
+		report_board_result(app, RUTRONIK_APP_BOARD_CO2, retval);
+		if (retval == 0)
+			host_main_add_notification(
+					notification_fabric_create_for_pasco2(app->pasco2_app.co2_ppm));
+	}
+	return 0;
+}
+
+/**
+ * DPS310
+ */
+static uint16_t run_dps310(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(DPS310_NOTIFICATION_ID))
+	{
+		int retval = dps310_app_do();
+		report_board_result(app, RUTRONIK_APP_BOARD_SENSOR_FUSION, retval);
+		if (retval == 0)
+		{
+			float pressure = 0;
+			float temperature = 0;
+			dps310_app_get_last_values(&temperature, &pressure);
+			host_main_add_notification(notification_fabric_create_for_dps310(pressure, temperature));
+		}
+	}
+	return 0;
+}
+
+/**
+ * BMI270
+ */
+static uint16_t run_bmi270(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(BMI270_NOTIFICATION_ID))
+	{
+		struct bmi2_sensor_data data[2] = { { 0 } };
+		data[ACCEL].type = BMI2_ACCEL;
+		data[GYRO].type = BMI2_GYRO;
+
+		int8_t retval = bmi270_app_get_sensor_data(data, 2);
+		report_board_result(app, RUTRONIK_APP_BOARD_SENSOR_FUSION, retval);
+		if (retval == 0)
+		{
+			host_main_add_notification(
+					notification_fabric_create_for_bmi270(
+							data[ACCEL].sens_data.acc.x, data[ACCEL].sens_data.acc.y, data[ACCEL].sens_data.acc.z,
+							data[GYRO].sens_data.gyr.x, data[GYRO].sens_data.gyr.y, data[GYRO].sens_data.gyr.z));
+		}
+	}
+	return 0;
+}
+
+#ifdef BME688_SUPPORT
+/**
+ * BME688
+ */
+static uint16_t run_bme688(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(BME688_NOTIFICATION_ID))
+	{
+		if(bme688_app_do(&(app->bme688_app)) == 0)
+		{
+			bme688_scan_data_t last_data;
+			bme688_copy_scan_data(&(app->bme688_app.last_data), &last_data);
+			host_main_add_notification(
+					notification_fabric_create_for_bme688(&last_data));
+		}
+	}
+	return 0;
+}
+#endif
+
+#ifdef AMS_TMF_SUPPORT
+/**
+ * In order to achieve high number of values per seconds
+ * the values of the TMF8828 are continuously pushed
+ */
+static uint16_t run_tmf8828(void* context)
+{
+	if (host_main_is_subscribed(TMF8828_NOTIFICATION_ID) || host_main_is_subscribed(TMF8828_8X8_NOTIFICATION_ID))
+	{
+		if (tmf8828_app_do() == 0)
+		{
+			if (tmf8828_app_is_mode_8x8())
+			{
+				host_main_add_notification(
+						notification_fabric_create_for_tmf8828_8x8_mode(tmpf8828_get_last_8x8_results()));
+			}
+			else
+			{
+				host_main_add_notification(
+						notification_fabric_create_for_tmf8828(tmpf8828_get_last_results()));
+			}
+		}
+	}
+	return 0;
+}
+#endif
+
+#ifdef UM980_SUPPORT
+static uint16_t run_um980(void* context)
+{
+	// UART stream is always processed (avoid overflow), only the notification is skipped
+	if (um980_app_do() != 0)
+	{
+		um980_app_reset();
+	}
+
+	if ((um980_packet_available != 0) && host_main_is_subscribed(UM980_NOTIFICATION_ID))
+	{
+		um980_packet_available = 0;
+		host_main_add_notification(
+				notification_fabric_create_for_um980(&um980_last_packet));
+	}
+	return 0;
+}
+#endif
+
+/**
+ * Optical sensor
+ */
+static uint16_t run_optical_sensor(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (is_optical_sensor_subscribed(app))
+	{
+		uint16_t v1 = 0;
+		uint16_t v2 = 0;
+		uint16_t v3 = 0;
+		uint16_t v4 = 0;
+		int result = -1;	// Set once a value has been read
+
+		switch (app->optical_sensor_type)
+{
     case OPTICAL_SENSOR_VCNL3682XX:
         if (vcnl3682xx_get_proximity_data(&v1) == 0)
         {
 	        printf("VCNL3682XX: Prox1=%u\r\n", v1);
 
 
+            result = 0;
             host_main_add_notification(
                     notification_fabric_create_for_vcnl3682xx(v1));
         }
@@ -832,6 +1357,7 @@ case OPTICAL_SENSOR_VCNL403X:
 
             printf("VCNL4035 (Gesture): P1=%u P2=%u P3=%u G=%u\r\n", v1, v2, v3, gesture);
             
+            result = 0;
             host_main_add_notification(
                     notification_fabric_create_for_vcnl403x(3, v1, v2, v3, gesture));
         }
@@ -842,6 +1368,7 @@ case OPTICAL_SENSOR_VCNL403X:
             
             printf("VCNL4030 (Single): P1=%u\r\n", v1);
 
+            result = 0;
             host_main_add_notification(
                     notification_fabric_create_for_vcnl403x(1, v1, 0, 0, 0));
         }
@@ -855,6 +1382,7 @@ break;
         {
 			printf("VEML6031X00: ALS=%u IR=%u\r\n", v1, v2);
 
+            result = 0;
             host_main_add_notification(
                     notification_fabric_create_for_veml6031x00(v1, v2));
         }
@@ -868,6 +1396,7 @@ break;
         {
 			printf("VEML6046X00: R=%u G=%u B=%u IR=%u\r\n", v1, v2, v3, v3);
 			
+            result = 0;
             host_main_add_notification(
                     notification_fabric_create_for_veml6046x00(v1, v2, v3, v4));
         }
@@ -880,6 +1409,7 @@ break;
 		
 		    if (ret == 0)
 		    {
+		        result = 0;
 		        host_main_add_notification(
 		                notification_fabric_create_for_veml6030(v1));
 		    }
@@ -889,209 +1419,429 @@ break;
     default:
         break;
 }
-		}
+
+		report_board_result(app, RUTRONIK_APP_BOARD_OPTICAL, result);
 	}
-	app->optical_sensor_prescaler++;
-	if (app->optical_sensor_prescaler >= 15) app->optical_sensor_prescaler = 0;
+	return 0;
+}
 
-	/**
-	 * BMM350
-	 */
-	if (app->rab7_available)
+/**
+ * BMM350
+ */
+static uint16_t run_bmm350(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(BMM350_NOTIFICATION_ID))
 	{
-		if (app->bmm350_prescaler == 0)
+		float mag_temp = 0;
+		float mag_x = 0;
+		float mag_y = 0;
+		float mag_z = 0;
+		int8_t bmm350_ret = 0;
+
+		// Try to read the BMM350 sensor
+		bmm350_ret = bmm350_app_read_data(&mag_temp, &mag_x, &mag_y, &mag_z);
+		report_board_result(app, RUTRONIK_APP_BOARD_RAB7, bmm350_ret);
+		if (bmm350_ret == 0)
 		{
-			float mag_temp = 0;
-			float mag_x = 0;
-			float mag_y = 0;
-			float mag_z = 0;
-			int8_t bmm350_ret = 0;
-
-			// Try to read the BMM350 sensor
-			bmm350_ret = bmm350_app_read_data(&mag_temp, &mag_x, &mag_y, &mag_z);
-			if (bmm350_ret == 0)
-			{
-				host_main_add_notification(
-						notification_fabric_create_for_bmm350(mag_temp, mag_x, mag_y, mag_z));
-			}
+			host_main_add_notification(
+					notification_fabric_create_for_bmm350(mag_temp, mag_x, mag_y, mag_z));
 		}
-		// 100 Hz / 10 -> 10Hz
-		app->bmm350_prescaler++;
-		if (app->bmm350_prescaler >= 10) app->bmm350_prescaler = 0;
 	}
+	return 0;
+}
 
-	/**
-	 * SGP41
-	 */
-	if (app->rab7_available)
+/**
+ * SGP41
+ * Called every SGP41_CONDITIONING_PERIOD_MS during the conditioning, then every SGP41_MEASUREMENT_PERIOD_MS
+ */
+static uint16_t run_sgp41(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (app->sgp41_state == SGP41_CONDITIONING)
 	{
-		if (app->sgp41_state == SGP41_CONDITIONING)
+		if (app->sgp41_conditioning_count >= (SGP41_CONDITIONING_DURATION_MS / SGP41_CONDITIONING_PERIOD_MS))
 		{
-			if (app->sgp41_prescaler >= (SGP41_CONDITIONING_DURATION_MS / RUTRONIK_APP_PERIOD_MS))
-			{
-				app->sgp41_prescaler = 0;
-				app->sgp41_state = SGP41_MEASUREMENT;
-			}
-			else if ((app->sgp41_prescaler % (SGP41_CONDITIONING_PERIOD_MS / RUTRONIK_APP_PERIOD_MS)) == 0)
-			{
-				// Call to conditioning
-				sgp41_conditioning_cmd(SGP41_DEFAULT_RH, SGP41_DEFAULT_T);
-				app->sgp41_prescaler++;
-			}
-			else
-			{
-				app->sgp41_prescaler++;
-			}
+			app->sgp41_state = SGP41_MEASUREMENT;
+			sensor_scheduler_set_period(&app->scheduler, SGP41_NOTIFICATION_ID, SGP41_MEASUREMENT_PERIOD_MS);
 		}
-		else if (app->sgp41_state == SGP41_MEASUREMENT)
+		else
 		{
-			if (app->sgp41_prescaler == 0)
+			// Call to conditioning
+			sgp41_conditioning_cmd(SGP41_DEFAULT_RH, SGP41_DEFAULT_T);
+			app->sgp41_conditioning_count++;
+		}
+	}
+	else if (app->sgp41_state == SGP41_MEASUREMENT)
+	{
+		if (host_main_is_subscribed(SGP41_NOTIFICATION_ID))
+		{
+			uint16_t sgp_sraw_voc = 0;
+			uint16_t sgp_sraw_nox = 0;
+			int32_t sgp_voc_index = 0;
+			int32_t sgp_nox_index = 0;
+
+			/*Read the data of the measurement started one period ago and send a new command to start measurement*/
+			uint8_t measurement_available = 0;
+			if (app->sgp41_measurement_pending != 0)
+				measurement_available = (sgp41_read_raw_cmd(&sgp_sraw_voc, &sgp_sraw_nox) == 0) ? 1 : 0;
+
+			uint16 comp_rh = (uint16_t)app->sht4x_humidity * 65535 / 100;
+			uint16_t comp_t = (uint16_t)(app->sht4x_temperature + 45) * 65535 / 175;
+			/*Do the measurements with a temperature and humidity acquired from SHT4x*/
+			app->sgp41_measurement_pending = (sgp41_measure_raw_cmd(comp_rh, comp_t) == 0) ? 1 : 0;
+
+			if (measurement_available)
 			{
-				uint16_t sgp_sraw_voc = 0;
-				uint16_t sgp_sraw_nox = 0;
-				int32_t sgp_voc_index = 0;
-				int32_t sgp_nox_index = 0;
-
-				/*Read the data and send a new command to start measurement*/
-				sgp41_read_raw_cmd(&sgp_sraw_voc, &sgp_sraw_nox);
-				uint16 comp_rh = (uint16_t)app->sht4x_humidity * 65535 / 100;
-				uint16_t comp_t = (uint16_t)(app->sht4x_temperature + 45) * 65535 / 175;
-				sgp41_measure_raw_cmd(comp_rh, comp_t); /*Do the measurements with a temperature and humidity acquired from SHT4x*/
 				GasIndexAlgorithm_process(&app->gas_index_voc_params, sgp_sraw_voc, &sgp_voc_index);
 				GasIndexAlgorithm_process(&app->gas_index_nox_params, sgp_sraw_nox, &sgp_nox_index);
 
 				host_main_add_notification(
 						notification_fabric_create_for_sgp41(sgp_sraw_voc, sgp_sraw_nox, sgp_voc_index, sgp_nox_index));
 			}
-
-			app->sgp41_prescaler++;
-			if (app->sgp41_prescaler >= (SGP41_MEASUREMENT_PERIOD_MS / RUTRONIK_APP_PERIOD_MS))
-				app->sgp41_prescaler = 0;
 		}
 	}
+	return 0;
+}
 
-	/**
-	 * BME690
-	 */
-	if (app->rab7_available)
+/**
+ * BME690
+ */
+static uint16_t run_bme690(void* context)
+{
+	if (host_main_is_subscribed(BME690_NOTIFICATION_ID))
 	{
-		if (app->bme690_prescaler == 0)
-		{
-			int8_t bme690_result = 0;
-			uint8_t fields_cnt = 0;
-			bme69x_data_t data = {0};
+		int8_t bme690_result = 0;
+		uint8_t fields_cnt = 0;
+		bme69x_data_t data = {0};
 
-			bme690_result = bme690_data_available(&fields_cnt);
-			if(bme690_result == 0)
+		bme690_result = bme690_data_available(&fields_cnt);
+		if(bme690_result == 0)
+		{
+			for (uint8_t i = 0; i < fields_cnt; i++)
 			{
-		        for (uint8_t i = 0; i < fields_cnt; i++)
-		        {
-		        	if(bme690_data_read(&data, i))
-		        	{
-		        		host_main_add_notification(notification_fabric_create_for_bme690(&data));
-		        	}
-		        }
+				if(bme690_data_read(&data, i))
+				{
+					host_main_add_notification(notification_fabric_create_for_bme690(&data));
+				}
 			}
-
 		}
-		app->bme690_prescaler++;
-		if (app->bme690_prescaler >= (bme690_app_get_measurement_period() / RUTRONIK_APP_PERIOD_MS))
-			app->bme690_prescaler = 0;
 	}
+	return 0;
+}
 
-	/**
-	 * BMP585
-	 */
-	if (app->rab7_available)
+/**
+ * BMP585
+ */
+static uint16_t run_bmp585(void* context)
+{
+	rutronik_application_t* app = (rutronik_application_t*) context;
+
+	if (host_main_is_subscribed(BMP585_NOTIFICATION_ID))
 	{
-		if (app->bmp585_prescaler == 0)
+		float pressure = 0;
+		float temperature = 0;
+		int8_t bmp585_retval = 0;
+
+		bmp585_retval = bmp585_read_data(&temperature, &pressure);
+		report_board_result(app, RUTRONIK_APP_BOARD_RAB7, bmp585_retval);
+		if(bmp585_retval == 0)
 		{
-			float pressure = 0;
-			float temperature = 0;
-			int8_t bmp585_retval = 0;
+			host_main_add_notification(notification_fabric_create_for_bmp585(pressure, temperature));
+		}
+	}
+	return 0;
+}
 
-			bmp585_retval = bmp585_read_data(&temperature, &pressure);
-			if(bmp585_retval == 0)
-			{
-				host_main_add_notification(notification_fabric_create_for_bmp585(pressure, temperature));
-			}
+/**
+ * DPS368
+ */
+static uint16_t run_dps368(void* context)
+{
+	if (host_main_is_subscribed(DPS368_NOTIFICATION_ID))
+	{
+		float pressure = 0;
+		float temperature = 0;
+		int8_t dps368_retval = 0;
 
+		dps368_retval = dps368_read_data(&temperature, &pressure);
+		if(dps368_retval == 0)
+		{
+			// convert to Pa (currently in hPa)
+			pressure = pressure * 100.f;
+			host_main_add_notification(notification_fabric_create_for_dps368(pressure, temperature));
 		}
-		app->bmp585_prescaler++;
-		if (app->bmp585_prescaler >= (BMP585_MEASUREMENT_PERIOD_MS / RUTRONIK_APP_PERIOD_MS))
-			app->bmp585_prescaler = 0;
 	}
+	return 0;
+}
 
-	/**
-	 * DPS368
-	 */
-	if (app->rab7_available)
+/**
+ * BMI323
+ */
+static void publish_bmi323()
+{
+	int16_t acc_x = 0;
+	int16_t acc_y = 0;
+	int16_t acc_z = 0;
+	int16_t gyr_x = 0;
+	int16_t gyr_y = 0;
+	int16_t gyr_z = 0;
+
+	if (bmi323_read_acc_data(&acc_x, &acc_y, &acc_z) != 0)
 	{
-		if (app->dps368_prescaler == 0)
-		{
-			float pressure = 0;
-			float temperature = 0;
-			int8_t dps368_retval = 0;
+		acc_x = 1;
+		acc_y = 2;
+		acc_z = 3;
+	}
+	if (bmi323_read_gyr_data(&gyr_x, &gyr_y, &gyr_z) != 0)
+	{
+		gyr_x = 4;
+		gyr_y = 5;
+		gyr_z = 6;
+	}
+
+	host_main_add_notification(
+			notification_fabric_create_for_bmi323(acc_x, acc_y, acc_z, gyr_x, gyr_y, gyr_z));
+}
+
+static uint16_t run_bmi323(void* context)
+{
+	if (host_main_is_subscribed(BMI323_NOTIFICATION_ID))
+	{
+		_Bool acc_ready = 0;
+		_Bool gyr_ready = 0;
 
-			dps368_retval = dps368_read_data(&temperature, &pressure);
-			if(dps368_retval == 0)
+		int8_t bmi323_retval = 0;
+
+		// Check if sensors are ready
+		bmi323_retval = bmi323_int_status(&acc_ready, &gyr_ready);
+		if(bmi323_retval == 0)
+		{
+			if( (acc_ready) && (gyr_ready))
 			{
-				// convert to Pa (currently in hPa)
-				pressure = pressure * 100.f;
-				host_main_add_notification(notification_fabric_create_for_dps368(pressure, temperature));
+				publish_bmi323();
 			}
 		}
-		app->dps368_prescaler++;
-		if (app->dps368_prescaler >= (DPS368_MEASUREMENT_PERIOD_MS / RUTRONIK_APP_PERIOD_MS))
-			app->dps368_prescaler = 0;
+	}
+	return 0;
+}
 
+/**
+ * Called on the data ready edge: the status register does not need to be read
+ */
+static uint16_t read_bmi323(void* context)
+{
+	if (host_main_is_subscribed(BMI323_NOTIFICATION_ID))
+	{
+		publish_bmi323();
 	}
+	return 0;
+}
 
-	/**
-	 * BMI323
-	 */
-	if (app->rab7_available)
+/**
+ * @var sensor_entries Period and worst case bus time of each sensor
+ * Bus times are estimated from the size of the I2C transfers done by one call (see HAL_I2C_TRANSFER_TIME_US)
+ * The phases are computed by the scheduler, no need to shift the sensors by hand
+ */
+static const sensor_scheduler_entry_t sensor_entries[] =
+{
+	{SHT4X_NOTIFICATION_ID, "SHT4x", SHT4X_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(6), is_sht4x_used, run_sht4x},
+	{SGP40_NOTIFICATION_ID, "SGP40", SGP40_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(3) + HAL_I2C_TRANSFER_TIME_US(8), is_sensor_fusion_used, run_sgp40},
+	{BMP581_NOTIFICATION_ID, "BMP581", BMP581_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(6), is_always_used, run_bmp581},
+	{SCD41_NOTIFICATION_ID, "SCD41", SCD41_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(9), is_co2_board_used, run_scd41},
+	{BATT_NOTIFICATION_ID, "Battery", BATT_MEASUREMENT_PERIOD_MS,
+			2 * (HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(1)), is_always_used, run_battery_monitor},
+	{PASCO2_NOTIFICATION_ID, "PASCO2", PASCO2_MEASUREMENT_PERIOD_MS,
+			2 * HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(2), is_co2_board_used, run_pasco2},
+	{DPS310_NOTIFICATION_ID, "DPS310", DPS310_MEASUREMENT_PERIOD_MS,
+			2 * (HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(6)), is_sensor_fusion_used, run_dps310},
+	{BMI270_NOTIFICATION_ID, "BMI270", BMI270_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(12), is_bmi270_polled, run_bmi270},
+#ifdef BME688_SUPPORT
+	{BME688_NOTIFICATION_ID, "BME688", BME688_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(17), is_sensor_fusion_used, run_bme688},
+#endif
+#ifdef AMS_TMF_SUPPORT
+	{TMF8828_NOTIFICATION_ID, "TMF8828", RUTRONIK_APP_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(132), is_tmf8828_polled, run_tmf8828},
+#endif
+#ifdef UM980_SUPPORT
+	{UM980_NOTIFICATION_ID, "UM980", RUTRONIK_APP_PERIOD_MS,
+			0, is_um980_used, run_um980},
+#endif
+	{OPTICAL_SENSOR_SCHEDULER_ID, "Optical", OPTICAL_SENSOR_MEASUREMENT_PERIOD_MS,
+			3 * (HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(2)), is_optical_sensor_used, run_optical_sensor},
+	{BMM350_NOTIFICATION_ID, "BMM350", BMM350_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(14), is_rab7_used, run_bmm350},
+	{SGP41_NOTIFICATION_ID, "SGP41", SGP41_CONDITIONING_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(6) + HAL_I2C_TRANSFER_TIME_US(8), is_rab7_used, run_sgp41},
+	{BME690_NOTIFICATION_ID, "BME690", BME690_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(51), is_rab7_used, run_bme690},
+	{BMP585_NOTIFICATION_ID, "BMP585", BMP585_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(6), is_rab7_used, run_bmp585},
+	{DPS368_NOTIFICATION_ID, "DPS368", DPS368_MEASUREMENT_PERIOD_MS,
+			2 * (HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(6)), is_rab7_used, run_dps368},
+	{BMI323_NOTIFICATION_ID, "BMI323", BMI323_MEASUREMENT_PERIOD_MS,
+			HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(4) + 2 * (HAL_I2C_TRANSFER_TIME_US(1) + HAL_I2C_TRANSFER_TIME_US(8)),
+			is_bmi323_polled, run_bmi323},
+};
+
+/**
+ * Sensors read on the edges of their data ready line
+ */
+typedef struct
+{
+	hal_data_ready_line_e line;
+	sensor_scheduler_available_func_t is_available;
+	sensor_scheduler_run_func_t read;
+} data_ready_entry_t;
+
+static const data_ready_entry_t data_ready_entries[] =
+{
+	{HAL_DATA_READY_BMI270, is_sensor_fusion_used, run_bmi270},
+	{HAL_DATA_READY_BMI323, is_rab7_used, read_bmi323},
+#ifdef AMS_TMF_SUPPORT
+	{HAL_DATA_READY_TMF8828, is_ams_tof_used, run_tmf8828},
+#endif
+};
+
+#define DATA_READY_ENTRIES	(sizeof(data_ready_entries) / sizeof(data_ready_entries[0]))
+
+/**
+ * @def DATA_READY_MIN_EDGES
+ * @brief Number of edges after which a line is considered as connected (polling stops)
+ */
+#define DATA_READY_MIN_EDGES	2
+
+static void init_data_ready_lines(rutronik_application_t* app)
+{
+	for(uint16_t i = 0; i < DATA_READY_ENTRIES; ++i)
 	{
-		if (app->bmi323_prescaler == 0)
+		const data_ready_entry_t* entry = &data_ready_entries[i];
+		if (entry->is_available(app) == 0) continue;
+
+		// Already initialised lines are left as they are (called again when a board comes online)
+		if (hal_data_ready_init(entry->line) != 0)
 		{
-			int16_t acc_x = 0;
-			int16_t acc_y = 0;
-			int16_t acc_z = 0;
-			int16_t gyr_x = 0;
-			int16_t gyr_y = 0;
-			int16_t gyr_z = 0;
-			_Bool acc_ready = 0;
-			_Bool gyr_ready = 0;
-
-			int8_t bmi323_retval = 0;
-
-			// Check if sensors are ready
-			bmi323_retval = bmi323_int_status(&acc_ready, &gyr_ready);
-			if(bmi323_retval == 0)
-			{
-				if( (acc_ready) && (gyr_ready))
-				{
-					if (bmi323_read_acc_data(&acc_x, &acc_y, &acc_z) != 0)
-					{
-						acc_x = 1;
-						acc_y = 2;
-						acc_z = 3;
-					}
-					if (bmi323_read_gyr_data(&gyr_x, &gyr_y, &gyr_z) != 0)
-					{
-						gyr_x = 4;
-						gyr_y = 5;
-						gyr_z = 6;
-					}
-
-					host_main_add_notification(
-							notification_fabric_create_for_bmi323(acc_x, acc_y, acc_z, gyr_x, gyr_y, gyr_z));
+			printf("Data ready line %u not available, sensor polled\r\n", entry->line);
+		}
+	}
+}
 
-				}
-			}
+static void init_scheduler(rutronik_application_t* app)
+{
+	sensor_scheduler_init(&app->scheduler, sensor_entries, sizeof(sensor_entries) / sizeof(sensor_entries[0]),
+			app, RUTRONIK_APP_PERIOD_MS, RUTRONIK_APP_BUS_BUDGET_US);
+
+	uint16_t overrun_ticks = sensor_scheduler_plan(&app->scheduler);
+	printf("Sensor scheduler: worst tick %lu us, %u ticks over budget\r\n",
+			(unsigned long) sensor_scheduler_get_stats(&app->scheduler)->planned_worst_load_us, overrun_ticks);
+}
+
+/**
+ * Remark: this function is called every 10ms (100Hz)
+ */
+void rutronik_application_do(rutronik_application_t* app)
+{
+	app->ticks++;
+
+	sensor_scheduler_do(&app->scheduler);
+	apply_board_changes(app);
+
+	if (app->boot_step == RUTRONIK_APP_BOOT_DONE)
+	{
+		check_hotplug(app);
+	}
+
+	if (app->boot_step != RUTRONIK_APP_BOOT_DONE)
+	{
+		do_boot_step(app);
+	}
+}
+
+void rutronik_application_process_events(rutronik_application_t* app)
+{
+	uint8_t replan = 0;
+
+	for(uint16_t i = 0; i < DATA_READY_ENTRIES; ++i)
+	{
+		const data_ready_entry_t* entry = &data_ready_entries[i];
+		if (entry->is_available(app) == 0) continue;
+
+		if (is_data_ready_used(app, entry->line) == 0)
+		{
+			if (hal_data_ready_get_edge_count(entry->line) < DATA_READY_MIN_EDGES) continue;
+
+			// Line is connected: the sensor is not polled anymore
+			app->data_ready_mask |= (1u << entry->line);
+			replan = 1;
 		}
-		app->bmi323_prescaler++;
-		if (app->bmi323_prescaler >= (BMI323_MEASUREMENT_PERIOD_MS / RUTRONIK_APP_PERIOD_MS))
-			app->bmi323_prescaler = 0;
+
+		if (hal_data_ready_is_pending(entry->line) == 0) continue;
+
+		hal_data_ready_clear(entry->line);
+		entry->read(app);
+	}
+
+	if (app->boards_changed != 0)
+	{
+		// A read demoted its board (the plan includes the lines switched above)
+		apply_board_changes(app);
+	}
+	else if (replan != 0)
+	{
+		sensor_scheduler_plan(&app->scheduler);
+	}
+}
+
+uint8_t rutronik_application_has_pending_events(rutronik_application_t* app)
+{
+	for(uint16_t i = 0; i < DATA_READY_ENTRIES; ++i)
+	{
+		hal_data_ready_line_e line = data_ready_entries[i].line;
+		if ((is_data_ready_used(app, line) != 0) && (hal_data_ready_has_edge(line) != 0)) return 1;
+	}
+	return 0;
+}
+
+uint16_t rutronik_application_get_idle_ticks(rutronik_application_t* app)
+{
+	uint32_t idle = sensor_scheduler_get_idle_ticks(&app->scheduler);
+
+	// Boot steps and probes count the calls: only the waits between the steps are skipped
+	uint32_t before_step = 0;
+	if (app->boot_step != RUTRONIK_APP_BOOT_DONE)
+	{
+		if (app->boot_not_before > (app->boot_ticks + 1)) before_step = app->boot_not_before - app->boot_ticks - 1;
 	}
+	else
+	{
+		before_step = get_ticks_before_probe(app);
+		if (before_step > 0) before_step--;
+	}
+
+	if (before_step < idle) idle = before_step;
+	return (uint16_t) idle;
+}
+
+void rutronik_application_skip_ticks(rutronik_application_t* app, uint16_t ticks)
+{
+	sensor_scheduler_skip(&app->scheduler, ticks);
+
+	app->ticks += ticks;
+	if (app->boot_step != RUTRONIK_APP_BOOT_DONE) app->boot_ticks += ticks;
+}
+
+uint8_t rutronik_application_is_deep_sleep_allowed(rutronik_application_t* app)
+{
+	// The UM980 is not probed yet
+	if (app->booted == 0) return 0;
+
+	return (app->um980_available != 0) ? 0 : 1;
 }
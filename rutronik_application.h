@@ -14,6 +14,8 @@
 #include "scd41/scd41_app.h"
 #include "filter/lowpassfilter.h"
 #include "pasco2/pasco2_app.h"
+#include "sensor_scheduler.h"
+#include "hal/hal_i2c.h"
 
 #ifdef BME688_SUPPORT
 #include "bme688/bme688_app.h"
@@ -25,6 +27,36 @@
  */
 #define RUTRONIK_APP_PERIOD_MS	10
 
+/**
+ * @def RUTRONIK_APP_TICKS_FOR_MS
+ * @brief Number of calls to wait between a measurement start and the fetch of its result
+ * Rounded up with one more call, since two consecutive calls can be less than RUTRONIK_APP_PERIOD_MS apart
+ */
+#define RUTRONIK_APP_TICKS_FOR_MS(ms)	((((ms) + RUTRONIK_APP_PERIOD_MS - 1) / RUTRONIK_APP_PERIOD_MS) + 1)
+
+/**
+ * @def RUTRONIK_APP_BUS_BUDGET_US
+ * @brief I2C bus time available inside one call (the rest is kept for the BLE host)
+ */
+#define RUTRONIK_APP_BUS_BUDGET_US	(RUTRONIK_APP_PERIOD_MS * 1000 / 2)
+
+/**
+ * Measurement periods (see sensor_entries inside rutronik_application.c)
+ * Phases are computed by the scheduler to spread the I2C load
+ */
+#define SHT4X_MEASUREMENT_PERIOD_MS				1000
+#define SGP40_MEASUREMENT_PERIOD_MS				1000
+#define BMP581_MEASUREMENT_PERIOD_MS			1000
+#define SCD41_MEASUREMENT_PERIOD_MS				1000
+#define BATT_MEASUREMENT_PERIOD_MS				1000
+#define PASCO2_MEASUREMENT_PERIOD_MS			1000
+#define DPS310_MEASUREMENT_PERIOD_MS			1000
+#define BMI270_MEASUREMENT_PERIOD_MS			100
+#define BME688_MEASUREMENT_PERIOD_MS			200
+#define OPTICAL_SENSOR_MEASUREMENT_PERIOD_MS	150
+#define BMM350_MEASUREMENT_PERIOD_MS			100
+#define BME690_MEASUREMENT_PERIOD_MS			5000	/**< Replaced by the period of the BME690 configuration */
+
 #define SGP41_CONDITIONING_DURATION_MS	10000
 #define SGP41_CONDITIONING_PERIOD_MS	500
 #define SGP41_MEASUREMENT_PERIOD_MS		1000
@@ -32,12 +64,35 @@
 #define DPS368_MEASUREMENT_PERIOD_MS	250
 #define BMI323_MEASUREMENT_PERIOD_MS	100
 
+/**
+ * Hot-plug of the boards
+ * An absent board is probed again after RUTRONIK_APP_PROBE_BACKOFF_MIN_MS, the delay doubles after each failed probe
+ * up to RUTRONIK_APP_PROBE_BACKOFF_MAX_MS (a probe of an absent board costs a few NACKed transfers).
+ * A board whose reads fail RUTRONIK_APP_BOARD_MAX_FAILURES times in a row is set as absent (demoted) and probed again later.
+ */
+#define RUTRONIK_APP_PROBE_BACKOFF_MIN_MS	1000
+#define RUTRONIK_APP_PROBE_BACKOFF_MAX_MS	64000
+#define RUTRONIK_APP_BOARD_MAX_FAILURES		3
+
+/**
+ * @def OPTICAL_SENSOR_SCHEDULER_ID
+ * @brief Identifier of the optical sensor inside the scheduler (the stream depends on the detected sensor)
+ */
+#define OPTICAL_SENSOR_SCHEDULER_ID		0x100
+
 typedef enum
 {
 	SGP41_CONDITIONING,
 	SGP41_MEASUREMENT
 } sgp41_state_e;
 
+typedef enum
+{
+	SGP40_IDLE,
+	SGP40_WAIT_RAW,				/**< Measurement without compensation started */
+	SGP40_WAIT_COMPENSATED		/**< Measurement with compensation started */
+} sgp40_step_e;
+
 typedef enum
 {
     OPTICAL_SENSOR_NONE = 0,
@@ -48,6 +103,51 @@ typedef enum
     OPTICAL_SENSOR_VEML6030 = 5
 } optical_sensor_type_t;
 
+/**
+ * Boards detected at runtime (bit n of the probe mask)
+ */
+typedef enum
+{
+	RUTRONIK_APP_BOARD_SENSOR_FUSION,
+	RUTRONIK_APP_BOARD_CO2,
+	RUTRONIK_APP_BOARD_AMS_TOF,
+	RUTRONIK_APP_BOARD_OPTICAL,
+	RUTRONIK_APP_BOARD_RAB7,
+	RUTRONIK_APP_BOARD_UM980,			/**< Probed at boot only (UART handshake of ~1s) */
+	RUTRONIK_APP_BOARDS
+} rutronik_app_board_e;
+
+typedef struct
+{
+	uint8_t failures;					/**< Consecutive failed reads while available */
+	uint32_t demotions;					/**< Number of times the board has been set as absent because of failures */
+	uint32_t probe_interval_ms;			/**< Delay before the next probe, doubled after each failed probe */
+	uint32_t next_probe_tick;			/**< Value of ticks at which the board is probed again (if absent) */
+} rutronik_app_board_health_t;
+
+/**
+ * Steps of the initialisation of the boards, one step per call to rutronik_application_do
+ * BLE is already advertising: the slow start-ups (CO2 board, AMS OSRAM TOF board) run while the other boards are initialised
+ * The UM980 steps send one command each, its answer is polled by the next calls (the step is performed again until it arrives)
+ * The same steps probe the absent boards again at runtime (only the boards of the probe mask are handled)
+ */
+typedef enum
+{
+	RUTRONIK_APP_BOOT_POWER_UP,			/**< Soft reset of the PASCO2, power off of the TMF8828 (start of their start-up time) */
+	RUTRONIK_APP_BOOT_SENSOR_FUSION,
+	RUTRONIK_APP_BOOT_OPTICAL,
+	RUTRONIK_APP_BOOT_RAB7,
+	RUTRONIK_APP_BOOT_UM980,			/**< Stop the messages of the UM980 (unlog) */
+	RUTRONIK_APP_BOOT_UM980_UNLOG,		/**< Answer of unlog received: set the rover mode (unlog sent again if it failed) */
+	RUTRONIK_APP_BOOT_UM980_ROVER,		/**< Answer of the rover mode received: start the GGA messages */
+	RUTRONIK_APP_BOOT_UM980_GGA,		/**< Answer of the GGA messages received: UM980 available */
+	RUTRONIK_APP_BOOT_AMS_TOF,			/**< Cold start of the TMF8828 elapsed: firmware download */
+	RUTRONIK_APP_BOOT_SCD41_STOP,		/**< Boot of the SCD41 elapsed: stop a measurement running since a software restart */
+	RUTRONIK_APP_BOOT_SCD41_START,
+	RUTRONIK_APP_BOOT_PASCO2,			/**< Start-up of the PASCO2 elapsed: start its measurement */
+	RUTRONIK_APP_BOOT_DONE
+} rutronik_app_boot_step_e;
+
 typedef struct
 {
 	uint8_t sensor_fusion_available;	/**< Store if the sensor fusion board is available (1) or not (0) */
@@ -65,41 +165,61 @@ typedef struct
 	scd41_app_t scd41_app;
 	pasco2_app_t pasco2_app;
 
-	uint16_t sht4x_prescaler;
-	uint16_t sgp40_prescaler;
-	uint16_t bmp581_prescaler;
-	uint16_t scd41_prescaler;
-	uint16_t battery_prescaler;
-	uint16_t pasco2_prescaler;
-	uint16_t dps310_prescaler;
-	uint16_t bmi270_prescaler;
-	uint16_t bme688_prescaler;
-
-	uint16_t optical_sensor_prescaler;
-
-	uint16_t bmm350_prescaler;
-
 #ifdef BME688_SUPPORT
 	bme688_app_t bme688_app;
 #endif
 
 	lowpassfilter_t filtered_voltage;
+	uint16_t battery_voltage;			/**< Filtered voltage, sent once the charger registers have been read */
+	hal_i2c_transaction_t charger_control_read;	/**< Asynchronous read of the charger control register */
+	hal_i2c_transaction_t charger_monitor_read;	/**< Asynchronous read of the charger monitor register */
+	uint8_t charger_registers[2];		/**< Addresses of the control and monitor registers */
+	uint8_t charger_control;
+	uint8_t charger_monitor;
 
 	sgp41_state_e sgp41_state;
-	uint16_t sgp41_prescaler;
+	uint16_t sgp41_conditioning_count;	/**< Number of conditioning commands sent */
+	uint8_t sgp41_measurement_pending;	/**< A measurement has been started and its result can be read */
+
+	uint8_t sht4x_measurement_pending;	/**< A measurement has been started and its result has to be fetched */
+	sgp40_step_e sgp40_step;
+	uint16_t sgp40_voc_value_raw;		/**< Result of the first SGP40 measurement, kept until the second one is done */
 
-	uint16_t bme690_prescaler;
-	uint16_t bmp585_prescaler;
-	uint16_t dps368_prescaler;
-	uint16_t bmi323_prescaler;
+	sensor_scheduler_t scheduler;		/**< Calls each sensor at its period */
+	uint8_t data_ready_mask;			/**< Bit n set if the sensor of the data ready line n (hal_data_ready_line_e) is read on its edges */
+
+	uint32_t ticks;						/**< Calls to rutronik_application_do, skipped ticks included */
+	uint8_t booted;						/**< Every board has been probed once */
+	uint8_t probe_mask;					/**< Boards handled by the actual boot sequence (bit n: rutronik_app_board_e n) */
+	uint8_t boards_changed;				/**< A board has been demoted, the scheduler has to be planned again */
+	rutronik_app_board_health_t boards[RUTRONIK_APP_BOARDS];
+
+	rutronik_app_boot_step_e boot_step;	/**< Next step of the initialisation of the boards */
+	uint32_t boot_ticks;				/**< Calls to rutronik_application_do since RUTRONIK_APP_BOOT_POWER_UP */
+	uint32_t boot_not_before;			/**< Value of boot_ticks from which the next step can be performed */
+	uint8_t co2_booting;				/**< CO2 board answered, its start-up is in progress */
+	uint8_t ams_tof_booting;			/**< AMS OSRAM TOF board answered, its cold start is in progress */
+	uint8_t um980_attempts;				/**< Number of times unlog has been sent during the actual boot sequence */
 
 	float sht4x_temperature;	/**< Store last temperature (used for SGP41 compensation) */
 	float sht4x_humidity;		/**< Store last humidity (used for SGP41 compensation) */
 
 } rutronik_application_t;
 
+/**
+ * @brief Initialise the application without the boards (fast, BLE can be started right after)
+ * The boards are initialised by the next calls to rutronik_application_do, they are available once initialised
+ */
 void rutronik_application_init(rutronik_application_t* app);
 
+/**
+ * @brief Check if every board has been probed and initialised once
+ *
+ * @retval 1 The mask of the available sensors only changes on hot-plug
+ * @retval 0 Boards are still being initialised
+ */
+uint8_t rutronik_application_is_boot_done(rutronik_application_t* app);
+
 /**
  * @brief Generate a mask of the available sensor
  *
@@ -119,7 +239,43 @@ void rutronik_application_set_tmf8828_mode(rutronik_application_t* app, uint8_t
 
 /**
  * @brief Perform cyclic operation
+ * During the boot, performs one step of the initialisation of the boards after the sensors
  */
 void rutronik_application_do(rutronik_application_t* app);
 
+/**
+ * @brief Read the sensors whose data ready line signalled new data
+ * Called at every iteration of the main loop (not bound to the ticks)
+ */
+void rutronik_application_process_events(rutronik_application_t* app);
+
+/**
+ * @brief Check if a data ready edge has not been processed yet (checked before sleeping)
+ *
+ * @retval 1 rutronik_application_process_events has work to do
+ * @retval 0 Nothing pending
+ */
+uint8_t rutronik_application_has_pending_events(rutronik_application_t* app);
+
+/**
+ * @brief Get the number of next calls to rutronik_application_do that would have nothing to do
+ * The main loop sleeps over these calls (see rutronik_application_skip_ticks)
+ */
+uint16_t rutronik_application_get_idle_ticks(rutronik_application_t* app);
+
+/**
+ * @brief Account ticks during which rutronik_application_do has not been called
+ *
+ * @param [in] ticks At most the value returned by rutronik_application_get_idle_ticks
+ */
+void rutronik_application_skip_ticks(rutronik_application_t* app, uint16_t ticks);
+
+/**
+ * @brief Check if the sensors can be left in deep sleep between their periods
+ *
+ * @retval 0 A board needs the high frequency clocks while idle (UM980: UART reception)
+ * @retval 1 Deep sleep can be used
+ */
+uint8_t rutronik_application_is_deep_sleep_allowed(rutronik_application_t* app);
+
 #endif /* RUTRONIK_APPLICATION_H_ */
\ No newline at end of file
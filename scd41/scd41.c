@@ -18,16 +18,13 @@ static const uint16_t SCD41_CMD_START_PERIODIC_MEASUREMENT = 0x21B1;
 static const uint16_t SCD41_START_PERIODIC_MEASUREMENT_DURATION_MS = 1;
 
 static const uint16_t SCD41_CMD_STOP_PERIODIC_MEASUREMENT = 0x3F86;
-static const uint32_t SCD41_STOP_PERIOD_MEASUREMENT_DURATION_MS = 500;
 
 static const uint16_t SCD41_CMD_REINIT = 0x3646;
 static const uint32_t SCD41_REINIT_DURATION_MS = 20;
 
 static const uint16_t SCD41_CMD_GET_DATA_READY_STATUS = 0xE4B8;
-static const uint32_t SCD41_GET_DATA_READY_STATUS_DURATION_MS = 1;
 
 static const uint16_t SCD41_CMD_READ_MEASUREMENT = 0xEC05;
-static const uint32_t SCD41_READ_MEASUREMENT_DURATION_MS = 1;
 
 static const uint16_t SCD41_CMD_PERFORM_SELF_TEST = 0x3639;
 static const uint32_t SCD41_PERFORM_SELF_TEST_DURATION_MS = 10000;
@@ -73,8 +70,7 @@ void scd41_init(scd41_read_func_t read, scd41_write_func_t write, scd41_sleep_fu
 	i2c_write_bytes = write;
 	sys_sleep = sleep;
 
-	// Sensor needs 1sec to boot
-	sys_sleep(1000);
+	// Sensor needs SCD41_BOOT_DURATION_MS to boot: waited by the caller before the first command
 }
 
 int scd41_get_serial_number(scd41_serial_id_t* id)
@@ -157,26 +153,39 @@ int scd41_stop_periodic_measurement()
 	result = i2c_write_bytes(SCD41_I2C_ADDR, cmd, sizeof(cmd));
 	if (result != 0) return -1;
 
-	sys_sleep(SCD41_STOP_PERIOD_MEASUREMENT_DURATION_MS);
+	sys_sleep(SCD41_STOP_DURATION_MS);
 
 	return 0;
 }
 
-int scd41_get_data_ready_status(uint8_t* flag)
+static int send_command(uint16_t command)
 {
-	int8_t result = 0;
 	uint8_t cmd[2] = {0};
-	uint8_t data[3] = {0};
 
 	// Construct the command
-	cmd[0] = (uint8_t)((SCD41_CMD_GET_DATA_READY_STATUS & 0xFF00) >> 8);
-	cmd[1] = (uint8_t)(SCD41_CMD_GET_DATA_READY_STATUS & 0x00FF);
+	cmd[0] = (uint8_t)((command & 0xFF00) >> 8);
+	cmd[1] = (uint8_t)(command & 0x00FF);
 
 	// Send it
-	result = i2c_write_bytes(SCD41_I2C_ADDR, cmd, sizeof(cmd));
-	if (result != 0) return -1;
+	if (i2c_write_bytes(SCD41_I2C_ADDR, cmd, sizeof(cmd)) != 0) return -1;
+
+	return 0;
+}
+
+int scd41_start_stop_periodic_measurement()
+{
+	return send_command(SCD41_CMD_STOP_PERIODIC_MEASUREMENT);
+}
 
-	sys_sleep(SCD41_GET_DATA_READY_STATUS_DURATION_MS);
+int scd41_start_get_data_ready_status()
+{
+	return send_command(SCD41_CMD_GET_DATA_READY_STATUS);
+}
+
+int scd41_fetch_data_ready_status(uint8_t* flag)
+{
+	int8_t result = 0;
+	uint8_t data[3] = {0};
 
 	// Read answer
 	result = i2c_read_bytes(SCD41_I2C_ADDR, data, sizeof(data));
@@ -198,21 +207,24 @@ int scd41_get_data_ready_status(uint8_t* flag)
 	return 0;
 }
 
-int scd41_read_measurement(uint16_t* co2_ppm, float* temperature, float* humidity)
+int scd41_get_data_ready_status(uint8_t* flag)
 {
-	int8_t result = 0;
-	uint8_t cmd[2] = {0};
-	uint8_t data[9] = {0};
+	if (scd41_start_get_data_ready_status() != 0) return -1;
 
-	// Construct the command
-	cmd[0] = (uint8_t)((SCD41_CMD_READ_MEASUREMENT & 0xFF00) >> 8);
-	cmd[1] = (uint8_t)(SCD41_CMD_READ_MEASUREMENT & 0x00FF);
+	sys_sleep(SCD41_COMMAND_DURATION_MS);
 
-	// Send it
-	result = i2c_write_bytes(SCD41_I2C_ADDR, cmd, sizeof(cmd));
-	if (result != 0) return -1;
+	return scd41_fetch_data_ready_status(flag);
+}
 
-	sys_sleep(SCD41_READ_MEASUREMENT_DURATION_MS);
+int scd41_start_read_measurement()
+{
+	return send_command(SCD41_CMD_READ_MEASUREMENT);
+}
+
+int scd41_fetch_measurement(uint16_t* co2_ppm, float* temperature, float* humidity)
+{
+	int8_t result = 0;
+	uint8_t data[9] = {0};
 
 	// Read answer
 	result = i2c_read_bytes(SCD41_I2C_ADDR, data, sizeof(data));
@@ -236,6 +248,15 @@ int scd41_read_measurement(uint16_t* co2_ppm, float* temperature, float* humidit
 	return 0;
 }
 
+int scd41_read_measurement(uint16_t* co2_ppm, float* temperature, float* humidity)
+{
+	if (scd41_start_read_measurement() != 0) return -1;
+
+	sys_sleep(SCD41_COMMAND_DURATION_MS);
+
+	return scd41_fetch_measurement(co2_ppm, temperature, humidity);
+}
+
 int scd41_perform_self_test()
 {
 	int8_t result = 0;
@@ -10,6 +10,24 @@
 
 #include <stdint.h>
 
+/**
+ * @def SCD41_COMMAND_DURATION_MS
+ * @brief Time needed by the sensor to prepare the answer of a read command (data ready status, measurement)
+ */
+#define SCD41_COMMAND_DURATION_MS	1
+
+/**
+ * @def SCD41_BOOT_DURATION_MS
+ * @brief Time needed by the sensor after power up before accepting commands (not waited by scd41_init)
+ */
+#define SCD41_BOOT_DURATION_MS	1000
+
+/**
+ * @def SCD41_STOP_DURATION_MS
+ * @brief Time needed by the sensor to stop its periodic measurement before accepting the next command
+ */
+#define SCD41_STOP_DURATION_MS	500
+
 typedef struct
 {
 	uint16_t word0;
@@ -45,6 +63,12 @@ int scd41_reinit();
  */
 int scd41_stop_periodic_measurement();
 
+/**
+ * @brief Split-phase version of scd41_stop_periodic_measurement
+ * Send the command only, the next command can be sent SCD41_STOP_DURATION_MS later
+ */
+int scd41_start_stop_periodic_measurement();
+
 /**
  * @brief Check if a measurement is available or not
  */
@@ -57,6 +81,22 @@ int scd41_get_data_ready_status(uint8_t* flag);
  */
 int scd41_read_measurement(uint16_t* co2_ppm, float* temperature, float* humidity);
 
+/**
+ * @brief Split-phase version of scd41_get_data_ready_status
+ * Send the command, the answer can be read SCD41_COMMAND_DURATION_MS later using scd41_fetch_data_ready_status
+ */
+int scd41_start_get_data_ready_status();
+
+int scd41_fetch_data_ready_status(uint8_t* flag);
+
+/**
+ * @brief Split-phase version of scd41_read_measurement
+ * Send the command, the answer can be read SCD41_COMMAND_DURATION_MS later using scd41_fetch_measurement
+ */
+int scd41_start_read_measurement();
+
+int scd41_fetch_measurement(uint16_t* co2_ppm, float* temperature, float* humidity);
+
 int scd41_perform_self_test();
 
 int scd41_wake_up();
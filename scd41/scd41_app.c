@@ -13,6 +13,7 @@ void scd41_app_init(scd41_app_t* app, scd41_read_func_t read, scd41_write_func_t
 {
 	scd41_init(read, write, sleep);
 	app->i2c_initialised = I2C_INITIALISED;
+	app->step = SCD41_APP_IDLE;
 }
 
 int scd41_app_initialise_and_start_measurement(scd41_app_t* app)
@@ -25,7 +26,26 @@ int scd41_app_initialise_and_start_measurement(scd41_app_t* app)
 	int retval = scd41_stop_periodic_measurement();
 	if (retval != 0) return -3;
 
-	retval = scd41_reinit();
+	return scd41_app_start_measurement(app);
+}
+
+int scd41_app_stop_measurement(scd41_app_t* app)
+{
+	if (app->i2c_initialised != I2C_INITIALISED) return -1;
+
+	// Wake-up might fail in case of software restart
+	scd41_wake_up();
+
+	if (scd41_start_stop_periodic_measurement() != 0) return -3;
+
+	return 0;
+}
+
+int scd41_app_start_measurement(scd41_app_t* app)
+{
+	if (app->i2c_initialised != I2C_INITIALISED) return -1;
+
+	int retval = scd41_reinit();
 	if (retval != 0) return -4;
 
 	scd41_serial_id_t scd41_id;
@@ -36,6 +56,7 @@ int scd41_app_initialise_and_start_measurement(scd41_app_t* app)
 	if (retval != 0) return -6;
 
 	// Initializes internal values
+	app->step = SCD41_APP_IDLE;
 	app->counter = 0;
 	app->value.co2_ppm = 0;
 	app->value.humidity = 0;
@@ -46,29 +67,65 @@ int scd41_app_initialise_and_start_measurement(scd41_app_t* app)
 
 int scd41_app_do(scd41_app_t* app)
 {
-	uint8_t ready_flag = 0;
-	int retval = scd41_get_data_ready_status(&ready_flag);
-	if (retval != 0) return -1;
+	int retval = 0;
 
-	if (ready_flag)
+	switch(app->step)
 	{
-		float humidity = 0;
-		float temperature = 0;
-		uint16_t co2_ppm = 0;
-		retval = scd41_read_measurement(&co2_ppm, &temperature, &humidity);
-		if (retval != 0) return -2;
-
-		// Copy and increment
-		app->value.co2_ppm = co2_ppm;
-		app->value.temperature = temperature;
-		app->value.humidity = humidity;
-		app->counter = app->counter + 1;
-
-		return 0;
+		case SCD41_APP_IDLE:
+		{
+			retval = scd41_start_get_data_ready_status();
+			if (retval != 0) return -1;
+
+			app->step = SCD41_APP_WAIT_READY_STATUS;
+			return 1;
+		}
+
+		case SCD41_APP_WAIT_READY_STATUS:
+		{
+			uint8_t ready_flag = 0;
+			app->step = SCD41_APP_IDLE;
+
+			retval = scd41_fetch_data_ready_status(&ready_flag);
+			if (retval != 0) return -1;
+
+			// Was not ready...
+			if (ready_flag == 0) return 1;
+
+			retval = scd41_start_read_measurement();
+			if (retval != 0) return -2;
+
+			app->step = SCD41_APP_WAIT_MEASUREMENT;
+			return 1;
+		}
+
+		case SCD41_APP_WAIT_MEASUREMENT:
+		{
+			float humidity = 0;
+			float temperature = 0;
+			uint16_t co2_ppm = 0;
+			app->step = SCD41_APP_IDLE;
+
+			retval = scd41_fetch_measurement(&co2_ppm, &temperature, &humidity);
+			if (retval != 0) return -2;
+
+			// Copy and increment
+			app->value.co2_ppm = co2_ppm;
+			app->value.temperature = temperature;
+			app->value.humidity = humidity;
+			app->counter = app->counter + 1;
+
+			return 0;
+		}
+
+		default:
+			app->step = SCD41_APP_IDLE;
+			return -1;
 	}
+}
 
-	// Was not ready...
-	return 1;
+uint8_t scd41_app_is_busy(scd41_app_t* app)
+{
+	return (app->step != SCD41_APP_IDLE) ? 1 : 0;
 }
 
 void scd41_app_copy_measurement_value(scd41_measurement_value_t* src, scd41_measurement_value_t* dst)
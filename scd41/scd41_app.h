@@ -18,19 +18,51 @@ typedef struct
 	float humidity;
 } scd41_measurement_value_t;
 
+typedef enum
+{
+	SCD41_APP_IDLE,
+	SCD41_APP_WAIT_READY_STATUS,	/**< Data ready status command sent, answer to be read */
+	SCD41_APP_WAIT_MEASUREMENT		/**< Read measurement command sent, answer to be read */
+} scd41_app_step_e;
+
 typedef struct
 {
 	uint8_t i2c_initialised;
+	scd41_app_step_e step;
 	scd41_measurement_value_t value;
 	uint32_t counter;
 } scd41_app_t;
 
 void scd41_app_init(scd41_app_t* app, scd41_read_func_t read, scd41_write_func_t write, scd41_sleep_func_t sleep);
 
+/**
+ * @brief Stop and restart the measurement of the sensor (to be called SCD41_BOOT_DURATION_MS after power up)
+ * Blocking (~0.5s), see scd41_app_stop_measurement and scd41_app_start_measurement for the non blocking sequence
+ */
 int scd41_app_initialise_and_start_measurement(scd41_app_t* app);
 
+/**
+ * @brief First step of the non blocking initialisation: stop a measurement running since a software restart
+ * To be called SCD41_BOOT_DURATION_MS after power up
+ *
+ * @retval 0 Success, scd41_app_start_measurement can be called SCD41_STOP_DURATION_MS later
+ * @retval != 0 Sensor not responding
+ */
+int scd41_app_stop_measurement(scd41_app_t* app);
+
+/**
+ * @brief Second step of the non blocking initialisation: reinit the sensor and start the periodic measurement (~25ms)
+ *
+ * @retval 0 Success
+ * @retval != 0 An error occurred
+ */
+int scd41_app_start_measurement(scd41_app_t* app);
+
 /**
  * @brief Cyclic call to the sensor
+ * Each call performs one step of the read sequence (send a command or read its answer) and never waits.
+ * Once started, the sequence has to be continued at the next calls (see scd41_app_is_busy).
+ * The calls must be at least SCD41_COMMAND_DURATION_MS apart.
  *
  * @retval 0 New value is available (stored inside the app structure)
  * @retval 1 No new value was available - Need to wait
@@ -38,6 +70,14 @@ int scd41_app_initialise_and_start_measurement(scd41_app_t* app);
  */
 int scd41_app_do(scd41_app_t* app);
 
+/**
+ * @brief Check if a read sequence has been started and is not finished yet
+ *
+ * @retval 1 scd41_app_do needs to be called again
+ * @retval 0 Idle
+ */
+uint8_t scd41_app_is_busy(scd41_app_t* app);
+
 void scd41_app_copy_measurement_value(scd41_measurement_value_t* src, scd41_measurement_value_t* dst);
 
 #endif /* SCD41_SCD41_APP_H_ */
@@ -0,0 +1,325 @@
+/*
+ * sensor_scheduler.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "sensor_scheduler.h"
+#include "profiler.h"
+
+#include <stddef.h>
+
+/**
+ * @var load_map Bus time planned for each tick of the horizon
+ * Only used while a plan is computed (main loop context)
+ */
+static uint32_t load_map[SENSOR_SCHEDULER_MAX_HORIZON_TICKS];
+
+static uint16_t ms_to_ticks(sensor_scheduler_t* scheduler, uint32_t period_ms)
+{
+	uint32_t ticks = period_ms / scheduler->tick_ms;
+	if (ticks == 0) ticks = 1;
+	if (ticks > UINT16_MAX) ticks = UINT16_MAX;
+	return (uint16_t) ticks;
+}
+
+static uint32_t gcd(uint32_t a, uint32_t b)
+{
+	while(b != 0)
+	{
+		uint32_t tmp = a % b;
+		a = b;
+		b = tmp;
+	}
+	return a;
+}
+
+/**
+ * @brief The horizon is the least common multiple of the periods of the enabled sensors
+ * (bus load pattern repeats itself after that number of ticks)
+ */
+static void compute_horizon(sensor_scheduler_t* scheduler)
+{
+	uint32_t horizon = 1;
+	for(uint16_t i = 0; i < scheduler->count; ++i)
+	{
+		sensor_scheduler_slot_t* slot = &scheduler->slots[i];
+		if (slot->enabled == 0) continue;
+
+		horizon = (horizon / gcd(horizon, slot->period_ticks)) * slot->period_ticks;
+		if (horizon > SENSOR_SCHEDULER_MAX_HORIZON_TICKS)
+		{
+			horizon = SENSOR_SCHEDULER_MAX_HORIZON_TICKS;
+			break;
+		}
+	}
+	scheduler->horizon_ticks = (uint16_t) horizon;
+}
+
+static void add_load(sensor_scheduler_t* scheduler, sensor_scheduler_slot_t* slot)
+{
+	for(uint32_t t = slot->phase; t < scheduler->horizon_ticks; t += slot->period_ticks)
+	{
+		load_map[t] += slot->entry->bus_time_us;
+	}
+}
+
+static void clear_load_map(sensor_scheduler_t* scheduler)
+{
+	for(uint16_t t = 0; t < scheduler->horizon_ticks; ++t)
+	{
+		load_map[t] = 0;
+	}
+}
+
+/**
+ * @brief Fill the load map with all the enabled sensors except one
+ *
+ * @param [in] excluded Slot not taken into account
+ */
+static void build_load_map(sensor_scheduler_t* scheduler, sensor_scheduler_slot_t* excluded)
+{
+	clear_load_map(scheduler);
+
+	for(uint16_t i = 0; i < scheduler->count; ++i)
+	{
+		sensor_scheduler_slot_t* slot = &scheduler->slots[i];
+		if ((slot->enabled == 0) || (slot == excluded)) continue;
+		add_load(scheduler, slot);
+	}
+}
+
+/**
+ * @brief Choose the phase of a slot according to the load map and add its load to the map
+ * The selected phase is the one with the lowest maximum load, then with the lowest total load
+ */
+static void place_slot(sensor_scheduler_t* scheduler, sensor_scheduler_slot_t* slot)
+{
+	uint16_t best_phase = 0;
+	uint32_t best_max = UINT32_MAX;
+	uint32_t best_sum = UINT32_MAX;
+
+	uint16_t phase_count = slot->period_ticks;
+	if (phase_count > scheduler->horizon_ticks) phase_count = scheduler->horizon_ticks;
+
+	for(uint16_t phase = 0; phase < phase_count; ++phase)
+	{
+		uint32_t max = 0;
+		uint32_t sum = 0;
+		for(uint32_t t = phase; t < scheduler->horizon_ticks; t += slot->period_ticks)
+		{
+			if (load_map[t] > max) max = load_map[t];
+			sum += load_map[t];
+		}
+
+		if ((max < best_max) || ((max == best_max) && (sum < best_sum)))
+		{
+			best_phase = phase;
+			best_max = max;
+			best_sum = sum;
+		}
+	}
+
+	slot->phase = best_phase;
+	add_load(scheduler, slot);
+}
+
+static void evaluate_plan(sensor_scheduler_t* scheduler)
+{
+	scheduler->stats.planned_worst_load_us = 0;
+	scheduler->stats.planned_overrun_ticks = 0;
+
+	for(uint16_t t = 0; t < scheduler->horizon_ticks; ++t)
+	{
+		if (load_map[t] > scheduler->stats.planned_worst_load_us) scheduler->stats.planned_worst_load_us = load_map[t];
+		if (load_map[t] > scheduler->budget_us) scheduler->stats.planned_overrun_ticks++;
+	}
+}
+
+static sensor_scheduler_slot_t* find_slot(sensor_scheduler_t* scheduler, uint16_t id)
+{
+	for(uint16_t i = 0; i < scheduler->count; ++i)
+	{
+		if (scheduler->slots[i].entry->id == id) return &scheduler->slots[i];
+	}
+	return NULL;
+}
+
+void sensor_scheduler_init(sensor_scheduler_t* scheduler, const sensor_scheduler_entry_t* entries, uint16_t count,
+		void* context, uint32_t tick_ms, uint32_t budget_us)
+{
+	if (count > SENSOR_SCHEDULER_MAX_ENTRIES) count = SENSOR_SCHEDULER_MAX_ENTRIES;
+	if (tick_ms == 0) tick_ms = 1;
+
+	scheduler->count = count;
+	scheduler->context = context;
+	scheduler->tick_ms = tick_ms;
+	scheduler->budget_us = budget_us;
+	scheduler->tick = 0;
+	scheduler->horizon_ticks = 1;
+
+	for(uint16_t i = 0; i < count; ++i)
+	{
+		sensor_scheduler_slot_t* slot = &scheduler->slots[i];
+		slot->entry = &entries[i];
+		slot->period_ticks = ms_to_ticks(scheduler, entries[i].period_ms);
+		slot->phase = 0;
+		slot->follow_up_ticks = 0;
+		slot->enabled = 0;
+
+		PROFILER_SET_NAME(PROFILER_SECTION_SENSORS + i, entries[i].name);
+	}
+
+	scheduler->stats.planned_worst_load_us = 0;
+	scheduler->stats.planned_overrun_ticks = 0;
+	scheduler->stats.overruns = 0;
+	scheduler->stats.worst_load_us = 0;
+}
+
+uint16_t sensor_scheduler_plan(sensor_scheduler_t* scheduler)
+{
+	uint8_t placed[SENSOR_SCHEDULER_MAX_ENTRIES] = {0};
+
+	for(uint16_t i = 0; i < scheduler->count; ++i)
+	{
+		sensor_scheduler_slot_t* slot = &scheduler->slots[i];
+		slot->enabled = (slot->entry->is_available(scheduler->context) != 0) ? 1 : 0;
+		slot->phase = 0;
+		placed[i] = (slot->enabled == 0) ? 1 : 0;
+	}
+
+	compute_horizon(scheduler);
+	clear_load_map(scheduler);
+
+	// Greedy placement, most expensive sensors first
+	for(;;)
+	{
+		sensor_scheduler_slot_t* next = NULL;
+		uint16_t next_index = 0;
+		for(uint16_t i = 0; i < scheduler->count; ++i)
+		{
+			if (placed[i] != 0) continue;
+			if ((next == NULL) || (scheduler->slots[i].entry->bus_time_us > next->entry->bus_time_us))
+			{
+				next = &scheduler->slots[i];
+				next_index = i;
+			}
+		}
+
+		if (next == NULL) break;
+
+		place_slot(scheduler, next);
+		placed[next_index] = 1;
+	}
+
+	evaluate_plan(scheduler);
+	return scheduler->stats.planned_overrun_ticks;
+}
+
+int sensor_scheduler_set_period(sensor_scheduler_t* scheduler, uint16_t id, uint32_t period_ms)
+{
+	sensor_scheduler_slot_t* slot = find_slot(scheduler, id);
+	if (slot == NULL) return -1;
+	if (period_ms < scheduler->tick_ms) return -2;
+
+	slot->period_ticks = ms_to_ticks(scheduler, period_ms);
+	if (slot->enabled == 0) return 0;
+
+	compute_horizon(scheduler);
+	build_load_map(scheduler, slot);
+	place_slot(scheduler, slot);
+	evaluate_plan(scheduler);
+
+	return 0;
+}
+
+uint32_t sensor_scheduler_get_period(sensor_scheduler_t* scheduler, uint16_t id)
+{
+	sensor_scheduler_slot_t* slot = find_slot(scheduler, id);
+	if (slot == NULL) return 0;
+
+	return (uint32_t) slot->period_ticks * scheduler->tick_ms;
+}
+
+void sensor_scheduler_do(sensor_scheduler_t* scheduler)
+{
+	uint32_t load_us = 0;
+
+	for(uint16_t i = 0; i < scheduler->count; ++i)
+	{
+		sensor_scheduler_slot_t* slot = &scheduler->slots[i];
+		if (slot->enabled == 0) continue;
+
+		uint8_t call = 0;
+		if (slot->follow_up_ticks > 0)
+		{
+			// A split-phase read is ongoing, it has priority over the periodic slot
+			slot->follow_up_ticks--;
+			if (slot->follow_up_ticks == 0) call = 1;
+		}
+		else if ((scheduler->tick % slot->period_ticks) == slot->phase)
+		{
+			call = slot->entry->is_available(scheduler->context);
+		}
+
+		if (call != 0)
+		{
+			load_us += slot->entry->bus_time_us;
+
+			PROFILER_BEGIN(start);
+			slot->follow_up_ticks = slot->entry->run(scheduler->context);
+			PROFILER_END(PROFILER_SECTION_SENSORS + i, start);
+		}
+	}
+
+	scheduler->tick++;
+
+	if (load_us > scheduler->stats.worst_load_us) scheduler->stats.worst_load_us = load_us;
+	if (load_us > scheduler->budget_us) scheduler->stats.overruns++;
+}
+
+uint16_t sensor_scheduler_get_idle_ticks(sensor_scheduler_t* scheduler)
+{
+	uint16_t idle = UINT16_MAX;
+
+	for(uint16_t i = 0; i < scheduler->count; ++i)
+	{
+		sensor_scheduler_slot_t* slot = &scheduler->slots[i];
+		if (slot->enabled == 0) continue;
+
+		uint16_t slot_idle;
+		if (slot->follow_up_ticks > 0)
+		{
+			slot_idle = slot->follow_up_ticks - 1;
+		}
+		else
+		{
+			slot_idle = (uint16_t)((slot->phase + slot->period_ticks - (scheduler->tick % slot->period_ticks)) % slot->period_ticks);
+		}
+
+		if (slot_idle < idle) idle = slot_idle;
+	}
+
+	return idle;
+}
+
+void sensor_scheduler_skip(sensor_scheduler_t* scheduler, uint16_t ticks)
+{
+	for(uint16_t i = 0; i < scheduler->count; ++i)
+	{
+		sensor_scheduler_slot_t* slot = &scheduler->slots[i];
+		if (slot->follow_up_ticks == 0) continue;
+
+		// The split-phase call is never skipped, at worst it happens at the next tick
+		if (slot->follow_up_ticks > ticks) slot->follow_up_ticks -= ticks;
+		else slot->follow_up_ticks = 1;
+	}
+
+	scheduler->tick += ticks;
+}
+
+sensor_scheduler_stats_t* sensor_scheduler_get_stats(sensor_scheduler_t* scheduler)
+{
+	return &scheduler->stats;
+}
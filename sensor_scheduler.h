@@ -0,0 +1,150 @@
+/*
+ * sensor_scheduler.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef SENSOR_SCHEDULER_H_
+#define SENSOR_SCHEDULER_H_
+
+#include <stdint.h>
+
+/**
+ * @def SENSOR_SCHEDULER_MAX_ENTRIES
+ * @brief Maximum number of sensors handled by the scheduler
+ */
+#ifndef SENSOR_SCHEDULER_MAX_ENTRIES
+#define SENSOR_SCHEDULER_MAX_ENTRIES	24
+#endif
+
+/**
+ * @def SENSOR_SCHEDULER_MAX_HORIZON_TICKS
+ * @brief Maximum number of ticks used to compute the bus load (least common multiple of the periods)
+ * If the periods have a larger common multiple, the load is only estimated over that number of ticks
+ */
+#ifndef SENSOR_SCHEDULER_MAX_HORIZON_TICKS
+#define SENSOR_SCHEDULER_MAX_HORIZON_TICKS	1000
+#endif
+
+/**
+ * @brief Check if the sensor can be used (board detected and initialised)
+ *
+ * @retval 0 Sensor not available, its slots are skipped and it does not count inside the bus load
+ */
+typedef uint8_t (*sensor_scheduler_available_func_t)(void* context);
+
+/**
+ * @brief Perform the cyclic operation of the sensor
+ *
+ * @retval 0 Nothing more to do until the next period
+ * @retval > 0 Number of ticks after which the function has to be called again (split-phase read)
+ */
+typedef uint16_t (*sensor_scheduler_run_func_t)(void* context);
+
+/**
+ * Description of one sensor
+ */
+typedef struct
+{
+	uint16_t id;									/**< Identifier of the sensor (notification ID of its stream) */
+	const char* name;
+	uint32_t period_ms;								/**< Default period */
+	uint32_t bus_time_us;							/**< Worst case I2C bus time used by one call */
+	sensor_scheduler_available_func_t is_available;
+	sensor_scheduler_run_func_t run;
+} sensor_scheduler_entry_t;
+
+typedef struct
+{
+	const sensor_scheduler_entry_t* entry;
+	uint16_t period_ticks;
+	uint16_t phase;									/**< Tick of the period at which the sensor is called */
+	uint16_t follow_up_ticks;						/**< Ticks remaining before the next split-phase call (0 if none) */
+	uint8_t enabled;								/**< Result of is_available when the plan has been computed */
+} sensor_scheduler_slot_t;
+
+typedef struct
+{
+	uint32_t planned_worst_load_us;		/**< Highest bus time planned inside one tick */
+	uint16_t planned_overrun_ticks;		/**< Number of ticks (of the horizon) whose planned bus time exceeds the budget */
+	uint32_t overruns;					/**< Number of executed ticks whose bus time exceeded the budget */
+	uint32_t worst_load_us;				/**< Highest bus time of an executed tick */
+} sensor_scheduler_stats_t;
+
+typedef struct
+{
+	sensor_scheduler_slot_t slots[SENSOR_SCHEDULER_MAX_ENTRIES];
+	uint16_t count;
+	void* context;						/**< Passed to the functions of the entries */
+	uint32_t tick_ms;
+	uint32_t budget_us;					/**< Bus time available inside one tick */
+	uint32_t tick;
+	uint16_t horizon_ticks;
+	sensor_scheduler_stats_t stats;
+} sensor_scheduler_t;
+
+/**
+ * @brief Initialise the scheduler with a table of sensors
+ * The phases are computed by sensor_scheduler_plan
+ *
+ * @param [in] entries Table of sensors (must stay valid, only the pointer is kept)
+ * @param [in] count Number of entries (at most SENSOR_SCHEDULER_MAX_ENTRIES are used)
+ * @param [in] context Pointer passed to the functions of the entries
+ * @param [in] tick_ms Period at which sensor_scheduler_do is called
+ * @param [in] budget_us Bus time available inside one tick
+ */
+void sensor_scheduler_init(sensor_scheduler_t* scheduler, const sensor_scheduler_entry_t* entries, uint16_t count,
+		void* context, uint32_t tick_ms, uint32_t budget_us);
+
+/**
+ * @brief Check which sensors are available and compute their phases
+ * Sensors are placed one after the other at the phase where the highest bus load of their ticks is the lowest.
+ *
+ * @retval 0 All ticks stay inside the budget
+ * @retval > 0 Number of ticks whose planned bus time exceeds the budget
+ */
+uint16_t sensor_scheduler_plan(sensor_scheduler_t* scheduler);
+
+/**
+ * @brief Change the period of a sensor at runtime
+ * The sensor is placed again according to the load of the other sensors
+ *
+ * @retval 0 Success
+ * @retval -1 Unknown sensor
+ * @retval -2 Invalid period
+ */
+int sensor_scheduler_set_period(sensor_scheduler_t* scheduler, uint16_t id, uint32_t period_ms);
+
+/**
+ * @brief Get the current period of a sensor
+ *
+ * @retval 0 Unknown sensor
+ */
+uint32_t sensor_scheduler_get_period(sensor_scheduler_t* scheduler, uint16_t id);
+
+/**
+ * @brief Call the sensors whose slot is the current tick (or that wait for a split-phase call)
+ * Has to be called every tick_ms
+ */
+void sensor_scheduler_do(sensor_scheduler_t* scheduler);
+
+/**
+ * @brief Get the number of next ticks during which no sensor has to be called
+ * Enables the caller to sleep over these ticks (see sensor_scheduler_skip)
+ *
+ * @retval 0 A sensor is called at the next tick
+ * @retval UINT16_MAX No sensor enabled
+ */
+uint16_t sensor_scheduler_get_idle_ticks(sensor_scheduler_t* scheduler);
+
+/**
+ * @brief Advance the scheduler over ticks without calling any sensor
+ *
+ * @param [in] ticks Number of ticks skipped (at most the value returned by sensor_scheduler_get_idle_ticks)
+ */
+void sensor_scheduler_skip(sensor_scheduler_t* scheduler, uint16_t ticks);
+
+sensor_scheduler_stats_t* sensor_scheduler_get_stats(sensor_scheduler_t* scheduler);
+
+#endif /* SENSOR_SCHEDULER_H_ */
@@ -10,7 +10,6 @@
 #include <stddef.h>
 
 static const uint8_t SGP40_I2C_ADDR = 0x59;
-static const uint32_t SGP40_GET_RAW_MEASUREMENT_DURATION_MS = 30;
 static const uint16_t SGP40_CMD_GET_SERIAL_ID = 0x3682;
 static const uint32_t SGP40_GET_SERIAL_ID_DURATION_MS = 1;
 
@@ -79,17 +78,20 @@ int sgp40_get_serial_id(sgp40_serial_id_t * id)
 	return 0;
 }
 
-int sgp40_measure_raw_signal_without_compensation(uint16_t * voc_value)
+int sgp40_start_measurement_without_compensation()
 {
-	int8_t result = 0;
 	uint8_t cmd[8] = {0x26, 0x0F, 0x80, 0x00, 0xA2, 0x66, 0x66, 0x93};
-	uint8_t data[3] = {0};
 
 	// Send the command
-	result = i2c_write_bytes(SGP40_I2C_ADDR, cmd, sizeof(cmd));
-	if (result != 0) return -1;
+	if (i2c_write_bytes(SGP40_I2C_ADDR, cmd, sizeof(cmd)) != 0) return -1;
 
-	sys_sleep(SGP40_GET_RAW_MEASUREMENT_DURATION_MS);
+	return 0;
+}
+
+int sgp40_fetch_measurement(uint16_t* voc_value)
+{
+	int8_t result = 0;
+	uint8_t data[3] = {0};
 
 	// Read answer
 	result = i2c_read_bytes(SGP40_I2C_ADDR, data, sizeof(data));
@@ -105,6 +107,15 @@ int sgp40_measure_raw_signal_without_compensation(uint16_t * voc_value)
 	return 0;
 }
 
+int sgp40_measure_raw_signal_without_compensation(uint16_t * voc_value)
+{
+	if (sgp40_start_measurement_without_compensation() != 0) return -1;
+
+	sys_sleep(SGP40_MEASUREMENT_DURATION_MS);
+
+	return sgp40_fetch_measurement(voc_value);
+}
+
 /**
  * Convert the temperature and the humidity to format supported by the SGP40
  * The values are needed for internal value compensation
@@ -128,11 +139,9 @@ static void convert_to_sensor_format(float temperature, float humidity,
 	*humidity_sensor_format = (uint16_t) tmp;
 }
 
-int sgp40_measure_with_compensation(float temperature, float humidity, uint16_t* voc_value)
+int sgp40_start_measurement_with_compensation(float temperature, float humidity)
 {
-	int8_t result;
 	uint8_t cmd[8] = {0x26, 0x0F, 0x80, 0x00, 0xA2, 0x66, 0x66, 0x93};
-	uint8_t data[3] = {0};
 	uint16_t temperature_sensor_format = 0;
 	uint16_t humidity_sensor_format = 0;
 
@@ -148,21 +157,16 @@ int sgp40_measure_with_compensation(float temperature, float humidity, uint16_t*
 	cmd[7] = crc8(&cmd[5], 2);
 
 	// Send the command
-	result = i2c_write_bytes(SGP40_I2C_ADDR, cmd, sizeof(cmd));
-	if (result != 0) return -1;
+	if (i2c_write_bytes(SGP40_I2C_ADDR, cmd, sizeof(cmd)) != 0) return -1;
 
-	sys_sleep(SGP40_GET_RAW_MEASUREMENT_DURATION_MS);
-
-	// Read answer
-	result = i2c_read_bytes(SGP40_I2C_ADDR, data, sizeof(data));
-	if (result != 0) return -2;
+	return 0;
+}
 
-	// Verify CRC
-	uint8_t crc = crc8(data, sizeof(data) - 1);
-	if (crc != data[2]) return -3;
+int sgp40_measure_with_compensation(float temperature, float humidity, uint16_t* voc_value)
+{
+	if (sgp40_start_measurement_with_compensation(temperature, humidity) != 0) return -1;
 
-	// Get value
-	*voc_value = ((uint16_t)data[0] << 8 | data[1]);
+	sys_sleep(SGP40_MEASUREMENT_DURATION_MS);
 
-	return 0;
+	return sgp40_fetch_measurement(voc_value);
 }
@@ -10,6 +10,12 @@
 
 #include <stdint.h>
 
+/**
+ * @def SGP40_MEASUREMENT_DURATION_MS
+ * @brief Time needed by the sensor to perform a VOC measurement
+ */
+#define SGP40_MEASUREMENT_DURATION_MS	30
+
 typedef struct
 {
 	uint32_t msb;
@@ -44,5 +50,28 @@ int sgp40_measure_raw_signal_without_compensation(uint16_t * voc_value);
  */
 int sgp40_measure_with_compensation(float temperature, float humidity, uint16_t* voc_value);
 
+/**
+ * @brief Start a VOC measurement without humidity compensation and return without waiting
+ * The result can be fetched SGP40_MEASUREMENT_DURATION_MS later using sgp40_fetch_measurement
+ *
+ * @retval 0 Success else error
+ */
+int sgp40_start_measurement_without_compensation();
+
+/**
+ * @brief Start a VOC measurement using temperature and humidity compensation and return without waiting
+ * The result can be fetched SGP40_MEASUREMENT_DURATION_MS later using sgp40_fetch_measurement
+ *
+ * @retval 0 Success else error
+ */
+int sgp40_start_measurement_with_compensation(float temperature, float humidity);
+
+/**
+ * @brief Read the result of the last started measurement
+ *
+ * @retval 0 Success else error (e.g. the measurement is not finished yet)
+ */
+int sgp40_fetch_measurement(uint16_t* voc_value);
+
 
 #endif /* SGP40_SGP40_H_ */
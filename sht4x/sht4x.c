@@ -12,7 +12,6 @@ static const uint8_t SHT4X_I2C_ADDR = 0x44;
 static const uint8_t SHT4X_CMD_READ_SERIAL = 0x89;
 static const uint32_t SHT4X_GET_SERIAL_CMD_DURATION_MS = 1;
 static const uint8_t SHT4X_CMD_READ_HIGH_PRECISION = 0xFD;
-static const uint32_t SHT4X_READ_MEASUREMENT_CMD_DURATION_MS = 9;
 
 static sht4x_read_func_t i2c_read_bytes;
 static sht4x_write_func_t i2c_write_bytes;
@@ -56,17 +55,20 @@ int sht4x_get_serial_id(uint32_t * id)
 	return 0;
 }
 
-int sht4x_get_raw_measurement(uint16_t* temperature, uint16_t* humidity)
+int sht4x_start_measurement()
 {
-	int8_t result = 0;
 	uint8_t cmd = SHT4X_CMD_READ_HIGH_PRECISION;
-	uint8_t data[6] = {0};
 
 	// Send it
-	result = i2c_write_bytes(SHT4X_I2C_ADDR, &cmd, sizeof(cmd));
-	if (result != 0) return -1;
+	if (i2c_write_bytes(SHT4X_I2C_ADDR, &cmd, sizeof(cmd)) != 0) return -1;
 
-	sys_sleep(SHT4X_READ_MEASUREMENT_CMD_DURATION_MS);
+	return 0;
+}
+
+static int fetch_raw_measurement(uint16_t* temperature, uint16_t* humidity)
+{
+	int8_t result = 0;
+	uint8_t data[6] = {0};
 
 	// Read answer
 	result = i2c_read_bytes(SHT4X_I2C_ADDR, data, sizeof(data));
@@ -86,6 +88,21 @@ int sht4x_get_raw_measurement(uint16_t* temperature, uint16_t* humidity)
 	return 0;
 }
 
+static void convert_measurement(uint16_t raw_temperature, uint16_t raw_humidity, float* temperature, float* humidity)
+{
+	*temperature = -45.f + 175.f * ((float)raw_temperature / 65535.0f);
+	*humidity = -6.f + 125.f * ((float)raw_humidity / 65535.0f);
+}
+
+int sht4x_get_raw_measurement(uint16_t* temperature, uint16_t* humidity)
+{
+	if (sht4x_start_measurement() != 0) return -1;
+
+	sys_sleep(SHT4X_MEASUREMENT_DURATION_MS);
+
+	return fetch_raw_measurement(temperature, humidity);
+}
+
 int sht4x_get_temperature_and_humidity(float* temperature, float* humidity)
 {
 	uint16_t raw_temperature = 0;
@@ -93,8 +110,19 @@ int sht4x_get_temperature_and_humidity(float* temperature, float* humidity)
 	if (sht4x_get_raw_measurement(&raw_temperature, &raw_humidity) != 0) return -1;
 
 	// Convert
-	*temperature = -45.f + 175.f * ((float)raw_temperature / 65535.0f);
-	*humidity = -6.f + 125.f * ((float)raw_humidity / 65535.0f);
+	convert_measurement(raw_temperature, raw_humidity, temperature, humidity);
+
+	return 0;
+}
+
+int sht4x_fetch_temperature_and_humidity(float* temperature, float* humidity)
+{
+	uint16_t raw_temperature = 0;
+	uint16_t raw_humidity = 0;
+	if (fetch_raw_measurement(&raw_temperature, &raw_humidity) != 0) return -1;
+
+	// Convert
+	convert_measurement(raw_temperature, raw_humidity, temperature, humidity);
 
 	return 0;
 }
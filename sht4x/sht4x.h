@@ -10,6 +10,12 @@
 
 #include <stdint.h>
 
+/**
+ * @def SHT4X_MEASUREMENT_DURATION_MS
+ * @brief Time needed by the sensor to perform a high precision measurement
+ */
+#define SHT4X_MEASUREMENT_DURATION_MS	9
+
 typedef int8_t (*sht4x_read_func_t)(uint8_t dev_addr, uint8_t *data, uint16_t len);
 typedef int8_t (*sht4x_write_func_t)(uint8_t dev_addr, uint8_t *data, uint16_t len);
 typedef void (*sht4x_sleep_func_t)(uint32_t ms);
@@ -22,4 +28,19 @@ int sht4x_get_raw_measurement(uint16_t* temperature, uint16_t* humidity);
 
 int sht4x_get_temperature_and_humidity(float* temperature, float* humidity);
 
+/**
+ * @brief Send the high precision measurement command and return without waiting
+ * The result can be fetched SHT4X_MEASUREMENT_DURATION_MS later using sht4x_fetch_temperature_and_humidity
+ *
+ * @retval 0 Success else error
+ */
+int sht4x_start_measurement();
+
+/**
+ * @brief Read the result of the measurement started with sht4x_start_measurement
+ *
+ * @retval 0 Success else error (e.g. the measurement is not finished yet)
+ */
+int sht4x_fetch_temperature_and_humidity(float* temperature, float* humidity);
+
 #endif /* SHT4X_SHT4X_H_ */
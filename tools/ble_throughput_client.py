@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+"""
+ble_throughput_client.py
+
+Client of the throughput test mode of the RDK3 (command 7).
+Connects to the RDK3, starts the generator, decodes the test frames during a given time
+and reports goodput, loss and jitter.
+
+Requirements: pip install bleak
+
+Usage: python3 ble_throughput_client.py --address <BLE address> [--duration 30]
+"""
+
+import argparse
+import asyncio
+import statistics
+import struct
+import time
+
+from bleak import BleakClient, BleakScanner
+
+DATA_CHAR_UUID = "9dc72f3c-9623-479b-b2e3-ca83316a0a0f"
+
+CMD_STOP_PUSH_MODE = 2
+CMD_START_THROUGHPUT_TEST = 7
+
+TEST_FRAME_ID = 0xFFFE
+TEST_FRAME_HEADER = struct.Struct("<HII")
+
+
+class ThroughputDecoder:
+    """Decode the test frames (id, sequence number, device timestamp, pattern)"""
+
+    def __init__(self):
+        self.frames = 0
+        self.bytes = 0
+        self.lost = 0
+        self.corrupted = 0
+        self.out_of_order = 0
+        self.first_arrival = None
+        self.last_arrival = None
+        self.next_sequence = None
+        self.inter_arrival = []
+        self.transit_jitter = 0.0
+        self.last_transit = None
+
+    def on_frame(self, data, arrival=None):
+        """Handle one notification, returns False if it is not a test frame (e.g. ACK)"""
+        if len(data) < TEST_FRAME_HEADER.size:
+            return False
+        frame_id, sequence, device_us = TEST_FRAME_HEADER.unpack_from(data)
+        if frame_id != TEST_FRAME_ID:
+            return False
+
+        if arrival is None:
+            arrival = time.monotonic()
+
+        if any(data[i] != (i & 0xFF) for i in range(TEST_FRAME_HEADER.size, len(data))):
+            self.corrupted += 1
+
+        if self.next_sequence is not None:
+            if sequence > self.next_sequence:
+                self.lost += sequence - self.next_sequence
+            elif sequence < self.next_sequence:
+                self.out_of_order += 1
+        self.next_sequence = max(sequence + 1, self.next_sequence or 0)
+
+        if self.last_arrival is not None:
+            self.inter_arrival.append(arrival - self.last_arrival)
+        else:
+            self.first_arrival = arrival
+        self.last_arrival = arrival
+
+        # Interarrival jitter (RFC 3550): variation of the transit time device -> client
+        transit = arrival - device_us / 1e6
+        if self.last_transit is not None:
+            self.transit_jitter += (abs(transit - self.last_transit) - self.transit_jitter) / 16
+        self.last_transit = transit
+
+        self.frames += 1
+        self.bytes += len(data)
+        return True
+
+    def report(self):
+        if self.frames < 2:
+            return "Not enough frames received ({})".format(self.frames)
+
+        elapsed = self.last_arrival - self.first_arrival
+        expected = self.frames + self.lost
+        gaps_ms = [g * 1000 for g in self.inter_arrival]
+        lines = [
+            "Frames received: {} ({} bytes, {} bytes per frame)".format(self.frames, self.bytes, self.bytes // self.frames),
+            "Goodput: {:.1f} kbit/s".format(self.bytes * 8 / elapsed / 1000),
+            "Lost: {} ({:.2f} %), out of order: {}, corrupted: {}".format(
+                self.lost, 100.0 * self.lost / expected, self.out_of_order, self.corrupted),
+            "Inter-arrival: mean {:.2f} ms, stdev {:.2f} ms, max {:.2f} ms".format(
+                statistics.mean(gaps_ms), statistics.pstdev(gaps_ms), max(gaps_ms)),
+            "Transit jitter (RFC 3550): {:.2f} ms".format(self.transit_jitter * 1000),
+        ]
+        return "\n".join(lines)
+
+
+async def find_address(name):
+    device = await BleakScanner.find_device_by_filter(lambda d, ad: (d.name or "").startswith(name))
+    if device is None:
+        raise RuntimeError("No device named {} found".format(name))
+    return device.address
+
+
+async def run(args):
+    address = args.address or await find_address(args.name)
+    decoder = ThroughputDecoder()
+
+    async with BleakClient(address) as client:
+        print("Connected to {} (MTU {})".format(address, client.mtu_size))
+
+        await client.start_notify(DATA_CHAR_UUID, lambda _, data: decoder.on_frame(bytes(data)))
+        await client.write_gatt_char(DATA_CHAR_UUID, bytes([CMD_START_THROUGHPUT_TEST]), response=True)
+
+        await asyncio.sleep(args.duration)
+
+        await client.write_gatt_char(DATA_CHAR_UUID, bytes([CMD_STOP_PUSH_MODE]), response=True)
+        await asyncio.sleep(0.5)
+        await client.stop_notify(DATA_CHAR_UUID)
+
+    print(decoder.report())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="RDK3 BLE throughput test client")
+    parser.add_argument("--address", help="BLE address of the RDK3 (scan by name if not given)")
+    parser.add_argument("--name", default="RDK3", help="Advertised name used when scanning")
+    parser.add_argument("--duration", type=float, default=30.0, help="Duration of the test in seconds")
+    asyncio.run(run(parser.parse_args()))
+
+
+if __name__ == "__main__":
+    main()
@@ -15,10 +15,12 @@
 #define PACKET_HANDLER_BUFFER_SIZE 1024
 
 static um980_app_uart_readable_func_t uart_readable_func = NULL;
-static um980_app_uart_read_func_t uart_read_func = NULL;
+static um980_app_uart_read_available_func_t uart_read_available_func = NULL;
+static um980_app_uart_consume_func_t uart_consume_func = NULL;
 static um980_app_uart_write_func_t uart_write_func = NULL;
 
 // Buffer storing stream coming from the UM980 sensor (+1 because of internal handling -> we add \0 for debug purposes after reading something from the UART)
+// Only used for the packets split by the end of the UART ring, the other ones are read directly from the ring
 static uint8_t rx_buffer[PACKET_HANDLER_BUFFER_SIZE + 1];
 
 // Store how much data is available inside the rx buffer
@@ -27,48 +29,43 @@ static uint16_t rx_buffer_len = 0;
 static const uint16_t rtcm_fixed_size = 6;
 
 void packet_handler_init(um980_app_uart_readable_func_t uart_readable,
-		um980_app_uart_read_func_t uart_read,
+		um980_app_uart_read_available_func_t uart_read_available,
+		um980_app_uart_consume_func_t uart_consume,
 		um980_app_uart_write_func_t uart_write)
 {
 	uart_readable_func = uart_readable;
-	uart_read_func = uart_read;
+	uart_read_available_func = uart_read_available;
+	uart_consume_func = uart_consume;
 	uart_write_func = uart_write;
 }
 
 /**
  * @brief Read everything what is available on the UART inside the buffer
- *
- * @retval 0 Success
- * @retval -1 Buffer is full
- * @retval -2 error while reading
+ * Once the buffer is full, the rest stays inside the UART ring until packets have been extracted
  */
-static int read_available()
+static void read_available()
 {
-	uint32_t readable = uart_readable_func();
-	if (readable == 0) return 0;
+	for(;;)
+	{
+		const uint8_t* span = NULL;
+		uint16_t available = uart_read_available_func(&span);
+		if (available == 0) break;
 
-	uint16_t remaining_space = PACKET_HANDLER_BUFFER_SIZE - rx_buffer_len;
-	uint16_t toread = (readable > remaining_space) ? remaining_space : (uint16_t) readable;
+		uint16_t remaining_space = PACKET_HANDLER_BUFFER_SIZE - rx_buffer_len;
+		if (remaining_space == 0) break;
 
-	if (toread == 0)
-	{
-		return PACKET_HANDLER_ERROR_BUFFER_FULL;
-	}
+		uint16_t toread = (available > remaining_space) ? remaining_space : available;
+		memcpy(&rx_buffer[rx_buffer_len], span, toread);
+		uart_consume_func(toread);
 
-	int retval = uart_read_func(&rx_buffer[rx_buffer_len], toread);
-	if (retval < 0)
-	{
-		return PACKET_HANDLER_ERROR_READ;
+		rx_buffer_len += toread;
 	}
 
-	rx_buffer_len += (uint16_t) retval;
 	// Add \0 for debug option, in case the user use printf on the rx_buffer
 	rx_buffer[rx_buffer_len] = '\0';
-
-	return 0;
 }
 
-static bool is_nmea_packet_valid(uint8_t* buffer, uint16_t len)
+static bool is_nmea_packet_valid(const uint8_t* buffer, uint16_t len)
 {
 	if (buffer[0] != '$') return false;
 
@@ -80,7 +77,7 @@ static bool is_nmea_packet_valid(uint8_t* buffer, uint16_t len)
 	return false;
 }
 
-static uint16_t get_nmea_packet_len(uint8_t* buffer, uint16_t len)
+static uint16_t get_nmea_packet_len(const uint8_t* buffer, uint16_t len)
 {
 	for(uint16_t i = 1; i < len; ++i)
 	{
@@ -89,30 +86,13 @@ static uint16_t get_nmea_packet_len(uint8_t* buffer, uint16_t len)
 	return 0;
 }
 
-static uint32_t crc24(uint8_t* buffer, uint16_t size)
-{
-	uint32_t crc = 0;
-	int i = 0;
-	while (size--)
-	{
-		crc ^= (*buffer++) << (16);
-		for (i = 0; i < 8; i++)
-		{
-			crc <<= 1;
-			if (crc & 0x1000000)
-				crc ^= 0x01864cfb;
-		}
-	}
-	return crc;
-}
-
 /**
- * @brief Check if the packet starting at @start_addr in rx_buffer is valid RTCM or not
+ * @brief Check if the packet starting at buffer is valid RTCM or not
  *
  * @retval true Valid packet
  * @retval false Not valid packet
  */
-static bool is_rtcm_packet_valid(uint8_t* buffer, uint16_t len)
+static bool is_rtcm_packet_valid(const uint8_t* buffer, uint16_t len)
 {
 	// Enough place for preamble, reserved bits, message length and CRC? (at least 6  bytes -> 48bits)
 	if (len < rtcm_fixed_size) return false;
@@ -128,7 +108,7 @@ static bool is_rtcm_packet_valid(uint8_t* buffer, uint16_t len)
 	if (len < (rtcm_fixed_size + packet_len)) return false;
 
 	// Compute the CRC
-	uint32_t crc = crc24(buffer, packet_len + 3);
+	uint32_t crc = rtcm_packet_compute_crc24(buffer, packet_len + 3);
 
 	uint32_t crc_is = (buffer[3 + packet_len] << 16)
 		| (buffer[3 + packet_len + 1] << 8)
@@ -142,70 +122,155 @@ static bool is_rtcm_packet_valid(uint8_t* buffer, uint16_t len)
 void packet_handler_reset()
 {
 	rx_buffer_len = 0;
+
+	// Drop what the UART received as well
+	if (uart_readable_func != NULL) uart_consume_func((uint16_t) uart_readable_func());
 }
 
-int packet_handler_read_packet(uint8_t* buffer, uint16_t buffer_len)
+/**
+ * @brief Search the first packet inside the data (starts with $ or 0xD3)
+ *
+ * @param [out] start Index of the start of the packet (len if there is none)
+ *
+ * @retval > 0 A complete packet is available at start. Retval contains its length
+ * @retval 0 No packet or packet not complete yet
+ * @retval < 0 Error occured
+ */
+static int find_packet(const uint8_t* data, uint16_t len, uint16_t* start)
 {
-	int retval = read_available();
-	if (retval != 0) return retval;
+	for(uint16_t i = 0; i < len; ++i)
+	{
+		if (data[i] == '$')
+		{
+			*start = i;
+			if (is_nmea_packet_valid(&data[i], (len - i)) == false) return 0;
+
+			uint16_t packet_len = get_nmea_packet_len(&data[i], (len - i));
+			if (packet_len == 0) return PACKET_HANDLER_ERROR_INVALID_NMEA_LEN;
+			return packet_len;
+		}
+		else if (data[i] == 0xD3)
+		{
+			// Starts with 0xD3 -> RTCM
+			*start = i;
+			if (is_rtcm_packet_valid(&data[i], (len - i)) == false) return 0;
+
+			return rtcm_packet_get_variable_size(&data[i]) + rtcm_fixed_size;
+		}
+	}
+
+	*start = len;
+	return 0;
+}
 
-	// Search for $ or D3
-	for(int i = 0; i < rx_buffer_len; ++i)
+static int copy_packet(const uint8_t* packet, uint16_t packet_len, uint8_t* buffer, uint16_t buffer_len)
+{
+	if (buffer_len < (packet_len + 1))
 	{
-		if (rx_buffer[i] == '$')
+		return PACKET_HANDLER_ERROR_BUFFER_TOO_SMALL;
+	}
+
+	memcpy(buffer, packet, packet_len);
+	buffer[packet_len] = '\0';
+	return packet_len;
+}
+
+/**
+ * @brief Drop the first bytes of rx_buffer
+ */
+static void drop_buffered(uint16_t len)
+{
+	memmove(rx_buffer, &rx_buffer[len], rx_buffer_len - len);
+	rx_buffer_len -= len;
+}
+
+/**
+ * @brief Read a packet out of rx_buffer (filled with what the UART received)
+ * The bytes of a packet that cannot be read (invalid, too long) are dropped, the next call continues after them
+ */
+static int read_buffered_packet(uint8_t* buffer, uint16_t buffer_len)
+{
+	read_available();
+
+	uint16_t start = 0;
+	int packet_len = find_packet(rx_buffer, rx_buffer_len, &start);
+	if (packet_len < 0)
+	{
+		drop_buffered(start + 1);
+		return packet_len;
+	}
+
+	if (packet_len == 0)
+	{
+		// Drop what is before the start of the packet (the ring is used again once the buffer is empty)
+		drop_buffered(start);
+
+		// Cannot be completed inside the buffer: search the next packet after its start
+		if (rx_buffer_len == PACKET_HANDLER_BUFFER_SIZE)
 		{
-			if (is_nmea_packet_valid(&rx_buffer[i], (rx_buffer_len -i)) == true)
-			{
-				uint16_t packet_len = get_nmea_packet_len(&rx_buffer[i], (rx_buffer_len -i));
-				if (packet_len == 0) return PACKET_HANDLER_ERROR_INVALID_NMEA_LEN;
+			drop_buffered(1);
+			return PACKET_HANDLER_ERROR_BUFFER_FULL;
+		}
+		return 0;
+	}
 
-				if (buffer_len < (packet_len + 1))
-				{
-					return PACKET_HANDLER_ERROR_BUFFER_TOO_SMALL;
-				}
+	int retval = copy_packet(&rx_buffer[start], packet_len, buffer, buffer_len);
 
-				// Read to buffer
-				memcpy(buffer, &rx_buffer[i], packet_len);
-				buffer[packet_len] = '\0';
+	// Shift RX buffer to keep it clean and update len (a packet too long for the caller is dropped as well)
+	drop_buffered(start + packet_len);
 
-				// Shift RX buffer to keep it clean and update len
-				memcpy(rx_buffer, &rx_buffer[i + packet_len], rx_buffer_len - (i + packet_len));
-				rx_buffer_len -= (packet_len + i);
+	return retval;
+}
 
-				return packet_len;
-			}
+int packet_handler_read_packet(uint8_t* buffer, uint16_t buffer_len)
+{
+	// Data already copied has to be handled first
+	if (rx_buffer_len != 0) return read_buffered_packet(buffer, buffer_len);
 
-			// Packet not valid, wait
-			return 0;
+	for(;;)
+	{
+		const uint8_t* span = NULL;
+		uint16_t available = uart_read_available_func(&span);
+		if (available == 0) return 0;
+
+		uint16_t start = 0;
+		int packet_len = find_packet(span, available, &start);
+		if (packet_len < 0)
+		{
+			uart_consume_func(start + 1);
+			return packet_len;
 		}
-		else if (rx_buffer[i] == 0xD3)
+
+		if (packet_len > 0)
 		{
-			// Starts with 0xD3 -> RTCM
-			if (is_rtcm_packet_valid(&rx_buffer[i], (rx_buffer_len - i)) == true)
-			{
-				uint16_t packet_len = rtcm_packet_get_variable_size(&rx_buffer[i]) + rtcm_fixed_size;
-				if (buffer_len < (packet_len + 1))
-				{
-					return PACKET_HANDLER_ERROR_BUFFER_TOO_SMALL;
-				}
-
-				// Read to buffer
-				memcpy(buffer, &rx_buffer[i], packet_len);
-				buffer[packet_len] = '\0';
-
-				// Shift RX buffer to keep it clean and update len
-				memcpy(rx_buffer, &rx_buffer[i + packet_len], rx_buffer_len - (i + packet_len));
-				rx_buffer_len -= (packet_len + i);
-
-				return packet_len;
-			}
-
-			// Packet not valid, wait
-			return 0;
+			// Copied from the UART ring directly (a packet too long for the caller is dropped as well)
+			int retval = copy_packet(&span[start], packet_len, buffer, buffer_len);
+			uart_consume_func(start + packet_len);
+			return retval;
 		}
-	}
 
-	return 0;
+		// Drop what is before the start of the packet
+		uart_consume_func(start);
+
+		// Nothing looks like a packet, the ring can contain more data after its end
+		if (start == available) continue;
+
+		uint16_t pending = available - start;
+		if (uart_readable_func() > pending)
+		{
+			// The packet continues at the beginning of the ring
+			return read_buffered_packet(buffer, buffer_len);
+		}
+
+		// Not complete, wait
+		if (pending >= PACKET_HANDLER_BUFFER_SIZE)
+		{
+			// Cannot be completed inside the buffer: search the next packet after its start
+			uart_consume_func(1);
+			return PACKET_HANDLER_ERROR_BUFFER_FULL;
+		}
+		return 0;
+	}
 }
 
 uint16_t packet_handler_get_packet_type(uint8_t* buffer)
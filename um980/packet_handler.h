@@ -21,23 +21,27 @@
 #define PACKET_HANDLER_UNKNOWN_PACKET	3
 
 typedef uint32_t (*um980_app_uart_readable_func_t)(void);
-typedef int (*um980_app_uart_read_func_t)(uint8_t* buffer, uint16_t size);
+typedef uint16_t (*um980_app_uart_read_available_func_t)(const uint8_t** span);
+typedef void (*um980_app_uart_consume_func_t)(uint16_t len);
 typedef int (*um980_app_uart_write_func_t)(uint8_t* buffer, uint16_t size);
-typedef uint32_t (*um980_app_get_uticks)(void);
+typedef uint64_t (*um980_app_get_time_us)(void);
 
 /**
  * @brief Initialize the module
  */
 void packet_handler_init(um980_app_uart_readable_func_t uart_readable,
-		um980_app_uart_read_func_t uart_read,
+		um980_app_uart_read_available_func_t uart_read_available,
+		um980_app_uart_consume_func_t uart_consume,
 		um980_app_uart_write_func_t uart_write);
 
 /**
  * @brief Read a packet out of the data stream
  *
- * The function first read from the UART connection and fill an internal buffer
- * Then it reads the first packet available in the datastream
+ * The packets are copied from the spans of the UART RX ring directly. Only a packet split by the end of the ring
+ * goes through an internal buffer first (like the data following it until the buffer is empty again)
+ * Reads the first packet available in the datastream, the bytes before it are dropped
  * It can be a RTCM packet (starts with 0xD3 or a NMEA packet that starts with '$')
+ * On error, the bytes of the packet in fault (or its first byte if it cannot be completed) are dropped as well
  *
  * @retval 0 Nothing to read
  * @retval > 0 A packet has been read. Retval contains the length of the packet
@@ -46,7 +50,7 @@ void packet_handler_init(um980_app_uart_readable_func_t uart_readable,
 int packet_handler_read_packet(uint8_t* buffer, uint16_t buffer_len);
 
 /**
- * @brief Reset the internal buffer
+ * @brief Reset the internal buffer and drop what the UART received
  */
 void packet_handler_reset();
 
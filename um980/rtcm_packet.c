@@ -8,7 +8,7 @@
 #include "rtcm_packet.h"
 
 
-uint16_t rtcm_packet_get_variable_size(uint8_t* buffer)
+uint16_t rtcm_packet_get_variable_size(const uint8_t* buffer)
 {
 	return ((buffer[1] & 3) << 8) | buffer[2];
 }
@@ -18,4 +18,19 @@ uint16_t rtcm_packet_get_type(uint8_t* buffer)
 	return ((buffer[3]) << 4) | ((buffer[4] & 0xF0) >> 4);
 }
 
-
+uint32_t rtcm_packet_compute_crc24(const uint8_t* buffer, uint16_t size)
+{
+	uint32_t crc = 0;
+	int i = 0;
+	while (size--)
+	{
+		crc ^= (*buffer++) << (16);
+		for (i = 0; i < 8; i++)
+		{
+			crc <<= 1;
+			if (crc & 0x1000000)
+				crc ^= 0x01864cfb;
+		}
+	}
+	return crc;
+}
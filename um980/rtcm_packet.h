@@ -10,8 +10,13 @@
 
 #include <stdint.h>
 
-uint16_t rtcm_packet_get_variable_size(uint8_t* buffer);
+uint16_t rtcm_packet_get_variable_size(const uint8_t* buffer);
 
 uint16_t rtcm_packet_get_type(uint8_t* buffer);
 
+/**
+ * @brief Compute the CRC-24Q used by the RTCM frames (preamble up to the end of the message)
+ */
+uint32_t rtcm_packet_compute_crc24(const uint8_t* buffer, uint16_t size);
+
 #endif /* UM980_RTCM_PACKET_H_ */
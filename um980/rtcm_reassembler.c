@@ -0,0 +1,136 @@
+/*
+ * rtcm_reassembler.c
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#include "rtcm_reassembler.h"
+
+#include <stddef.h>
+#include <string.h>
+#include "rtcm_packet.h"
+
+#define RTCM_PREAMBLE		0xD3
+#define RTCM_HEADER_SIZE	3
+#define RTCM_CRC_SIZE		3
+
+static rtcm_reassembler_output_func_t output_func = NULL;
+
+static uint8_t frame[RTCM_REASSEMBLER_MAX_FRAME_SIZE];
+
+// Number of bytes of the frame being received
+static uint16_t frame_len = 0;
+
+// Expected size of the frame being received (0 until the header is complete)
+static uint16_t frame_size = 0;
+
+static rtcm_reassembler_stats_t stats = {0};
+
+void rtcm_reassembler_init(rtcm_reassembler_output_func_t output)
+{
+	output_func = output;
+	rtcm_reassembler_reset();
+	memset(&stats, 0, sizeof(stats));
+}
+
+void rtcm_reassembler_reset()
+{
+	frame_len = 0;
+	frame_size = 0;
+}
+
+rtcm_reassembler_stats_t* rtcm_reassembler_get_stats()
+{
+	return &stats;
+}
+
+/**
+ * @brief Search for the next preamble inside the collected bytes (after a wrong header or CRC)
+ * and start over from there
+ */
+static void resync()
+{
+	uint16_t index = 1;
+	while((index < frame_len) && (frame[index] != RTCM_PREAMBLE)) index++;
+
+	stats.skipped_bytes += index;
+	frame_len -= index;
+	memmove(frame, &frame[index], frame_len);
+	frame_size = 0;
+}
+
+/**
+ * @brief Check what has been collected so far
+ *
+ * @retval 1 More bytes are needed
+ * @retval 0 The collected bytes have been consumed (frame output or resync), check again
+ */
+static int process_collected()
+{
+	if (frame_len < RTCM_HEADER_SIZE) return 1;
+
+	if (frame_size == 0)
+	{
+		// Reserved 6 bits should be 0
+		if ((frame[1] & 0xFC) != 0)
+		{
+			resync();
+			return 0;
+		}
+		frame_size = rtcm_packet_get_variable_size(frame) + RTCM_HEADER_SIZE + RTCM_CRC_SIZE;
+	}
+
+	if (frame_len < frame_size) return 1;
+
+	const uint16_t message_end = frame_size - RTCM_CRC_SIZE;
+	uint32_t crc = rtcm_packet_compute_crc24(frame, message_end);
+	uint32_t crc_is = (((uint32_t) frame[message_end]) << 16)
+			| (((uint32_t) frame[message_end + 1]) << 8)
+			| ((uint32_t) frame[message_end + 2]);
+
+	if (crc != crc_is)
+	{
+		stats.crc_errors++;
+		resync();
+		return 0;
+	}
+
+	if (output_func(frame, frame_size) == 0) stats.frames++;
+	else stats.dropped++;
+
+	// Keep the bytes following the frame
+	frame_len -= frame_size;
+	memmove(frame, &frame[frame_size], frame_len);
+	frame_size = 0;
+	return 0;
+}
+
+void rtcm_reassembler_push(const uint8_t* data, uint16_t len)
+{
+	uint16_t index = 0;
+	while(index < len)
+	{
+		// Hunt for the preamble
+		if (frame_len == 0)
+		{
+			if (data[index] != RTCM_PREAMBLE)
+			{
+				stats.skipped_bytes++;
+				index++;
+				continue;
+			}
+		}
+
+		// Copy as much as needed (the whole header first, then the rest of the frame)
+		uint16_t needed = (frame_size == 0) ? RTCM_HEADER_SIZE : frame_size;
+		uint16_t tocopy = needed - frame_len;
+		if (tocopy > (len - index)) tocopy = len - index;
+
+		memcpy(&frame[frame_len], &data[index], tocopy);
+		frame_len += tocopy;
+		index += tocopy;
+
+		while((frame_len > 0) && (process_collected() == 0)) {}
+	}
+}
@@ -0,0 +1,57 @@
+/*
+ * rtcm_reassembler.h
+ *
+ *  Created on: 17 Oct 2026
+ *      Author: ROJ030
+ */
+
+#ifndef UM980_RTCM_REASSEMBLER_H_
+#define UM980_RTCM_REASSEMBLER_H_
+
+#include <stdint.h>
+
+/**
+ * @def RTCM_REASSEMBLER_MAX_FRAME_SIZE
+ * @brief Longest RTCM3 frame (preamble + length: 3 bytes, message: up to 1023 bytes, CRC: 3 bytes)
+ */
+#define RTCM_REASSEMBLER_MAX_FRAME_SIZE	(3 + 1023 + 3)
+
+/**
+ * @brief Function receiving the complete and valid frames
+ *
+ * @retval 0 Frame accepted
+ * @retval < 0 Frame could not be accepted (counted as dropped)
+ */
+typedef int (*rtcm_reassembler_output_func_t)(uint8_t* frame, uint16_t len);
+
+typedef struct
+{
+	uint32_t frames;			/**< Number of valid frames handed to the output */
+	uint32_t crc_errors;		/**< Number of frames with a wrong CRC */
+	uint32_t dropped;			/**< Number of valid frames refused by the output */
+	uint32_t skipped_bytes;		/**< Number of bytes discarded while searching for a preamble */
+} rtcm_reassembler_stats_t;
+
+/**
+ * @brief Initialize the module
+ *
+ * @param [in] output Function called for each complete frame whose CRC-24Q is correct
+ */
+void rtcm_reassembler_init(rtcm_reassembler_output_func_t output);
+
+/**
+ * @brief Feed a chunk of the correction stream
+ *
+ * Frames can be split over several chunks (BLE writes), a chunk can contain several frames.
+ * Bytes that are not part of a frame are discarded.
+ */
+void rtcm_reassembler_push(const uint8_t* data, uint16_t len);
+
+/**
+ * @brief Forget the partially received frame (e.g. when the stream is interrupted)
+ */
+void rtcm_reassembler_reset();
+
+rtcm_reassembler_stats_t* rtcm_reassembler_get_stats();
+
+#endif /* UM980_RTCM_REASSEMBLER_H_ */
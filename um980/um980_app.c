@@ -18,10 +18,10 @@
 #include <string.h>
 #include <stdio.h>
 
-static um980_app_uart_readable_func_t uart_readable_func = NULL;
-static um980_app_uart_read_func_t uart_read_func = NULL;
+static um980_app_uart_read_available_func_t uart_read_available_func = NULL;
+static um980_app_uart_consume_func_t uart_consume_func = NULL;
 static um980_app_uart_write_func_t uart_write_func = NULL;
-static um980_app_get_uticks get_uticks_func = NULL;
+static um980_app_get_time_us get_time_us_func = NULL;
 static um980_app_on_nmea_packet nmea_listener = NULL;
 
 #define PACKET_BUFFER_SIZE 512
@@ -31,6 +31,10 @@ static uint8_t packet_buffer[PACKET_BUFFER_SIZE] = {0};
 
 static const uint32_t timeout_us = 100000; // 100ms
 
+// Command sent with um980_app_send_command, waiting for its answer
+static char pending_cmd[MAX_CMD_LEN] = {0};
+static uint64_t pending_deadline = 0;
+
 /**
  * @brief Flush the RX receiving buffer
  */
@@ -38,28 +42,29 @@ static void read_all()
 {
 	for(;;)
 	{
-		uint32_t readable = uart_readable_func();
-		if (readable == 0)
+		const uint8_t* span = NULL;
+		uint16_t available = uart_read_available_func(&span);
+		if (available == 0)
 		{
 			break;
 		}
 
-		uint16_t toread = (readable > PACKET_BUFFER_SIZE) ? PACKET_BUFFER_SIZE : (uint16_t)readable;
-		uart_read_func(packet_buffer, toread);
+		uart_consume_func(available);
 	}
 }
 
 void um980_app_init_hal(um980_app_uart_readable_func_t uart_readable,
-		um980_app_uart_read_func_t uart_read,
+		um980_app_uart_read_available_func_t uart_read_available,
+		um980_app_uart_consume_func_t uart_consume,
 		um980_app_uart_write_func_t uart_write,
-		um980_app_get_uticks get_uticks)
+		um980_app_get_time_us get_time_us)
 {
-	uart_readable_func = uart_readable;
-	uart_read_func = uart_read;
+	uart_read_available_func = uart_read_available;
+	uart_consume_func = uart_consume;
 	uart_write_func = uart_write;
-	get_uticks_func = get_uticks;
+	get_time_us_func = get_time_us;
 
-	packet_handler_init(uart_readable, uart_read, uart_write);
+	packet_handler_init(uart_readable, uart_read_available, uart_consume, uart_write);
 
 	read_all();
 }
@@ -74,14 +79,10 @@ void um980_app_reset()
 	packet_handler_reset();
 }
 
-/**
- * @brief Send a command and wait until feedback (or timeout)
- *
- * @retval 0 Success
- * @retval != 0 Error
- */
-static int send_command_and_wait(char* cmd)
+int um980_app_send_command(const char* cmd)
 {
+	if (strlen(cmd) >= (MAX_CMD_LEN - 2)) return -1;
+
 	char buffer[MAX_CMD_LEN];
 	sprintf(buffer, "%s\r\n", cmd);
 
@@ -91,48 +92,65 @@ static int send_command_and_wait(char* cmd)
 		return -1;
 	}
 
-	uint32_t start_time = get_uticks_func();
+	strcpy(pending_cmd, cmd);
+	pending_deadline = get_time_us_func() + timeout_us;
+	return 0;
+}
+
+int um980_app_poll_command()
+{
 	for(;;)
 	{
 		int retval = packet_handler_read_packet(packet_buffer, PACKET_BUFFER_SIZE);
 		if (retval < 0) return -2;
 
+		// Nothing more received
+		if (retval == 0) break;
+
 		// Packet is available, retval contains its length
-		if (retval > 0)
+		if (packet_buffer[0] == '$')
 		{
-			if (packet_buffer[0] == '$')
+			nmea_packet_type_t packet_type = nmea_packet_get_type(packet_buffer, (uint16_t)retval);
+			if (packet_type == PACKET_TYPE_COMMAND_ACK)
 			{
-				nmea_packet_type_t packet_type = nmea_packet_get_type(packet_buffer, (uint16_t)retval);
-				if (packet_type == PACKET_TYPE_COMMAND_ACK)
-				{
-					command_ack_packet_t packet;
-					command_ack_packet_extract_data(packet_buffer, (uint16_t)retval, &packet);
-
-					retval = command_ack_packet_check_command_status(cmd, &packet);
-					if (retval == 0) return 0;
-				}
+				command_ack_packet_t packet;
+				command_ack_packet_extract_data(packet_buffer, (uint16_t)retval, &packet);
+
+				retval = command_ack_packet_check_command_status(pending_cmd, &packet);
+				if (retval == 0) return 1;
 			}
 		}
-
-		// Check for timeout
-		uint32_t current_time = get_uticks_func();
-		if (current_time < start_time) return -3;
-		if ((current_time - start_time) > timeout_us) return -4;
 	}
 
-	return -5;
+	// Check for timeout
+	if (get_time_us_func() >= pending_deadline) return -4;
+
+	return 0;
 }
 
-static void wait_us(uint32_t us)
+/**
+ * @brief Send a command and wait until feedback (or timeout)
+ *
+ * @retval 0 Success
+ * @retval != 0 Error
+ */
+static int send_command_and_wait(char* cmd)
 {
-	uint32_t start_timestamp = get_uticks_func();
+	if (um980_app_send_command(cmd) != 0) return -1;
+
 	for(;;)
 	{
-		uint32_t timestamp = get_uticks_func();
-		if (timestamp < start_timestamp) return;
+		int retval = um980_app_poll_command();
+		if (retval == 1) return 0;
+		if (retval < 0) return retval;
+	}
+}
 
-		uint32_t diff = timestamp - start_timestamp;
-		if (diff > us) return;
+static void wait_us(uint32_t us)
+{
+	uint64_t deadline = get_time_us_func() + us;
+	while (get_time_us_func() < deadline)
+	{
 	}
 }
 
@@ -147,13 +165,13 @@ int um980_app_init()
 		int retval = um980_app_unlog();
 		if (retval != 0)
 		{
-			wait_us(500000); // wait for 0.5 seconds
+			wait_us(UM980_APP_UNLOG_RETRY_MS * 1000u);
 			um980_app_reset();
 		}
 		else return 0;
 
 		counter++;
-		if (counter > 1) return -1;
+		if (counter >= UM980_APP_UNLOG_ATTEMPTS) return -1;
 	}
 
 	return -2;
@@ -161,7 +179,7 @@ int um980_app_init()
 
 int um980_app_unlog()
 {
-	return send_command_and_wait("unlog");
+	return send_command_and_wait(UM980_APP_CMD_UNLOG);
 }
 
 int um980_app_set_mode_base()
@@ -171,7 +189,7 @@ int um980_app_set_mode_base()
 
 int um980_app_set_mode_rover()
 {
-	return send_command_and_wait("mode rover");
+	return send_command_and_wait(UM980_APP_CMD_MODE_ROVER);
 }
 
 int um980_app_start_correction_generation(uint16_t rtcm_number, uint16_t period)
@@ -182,16 +200,24 @@ int um980_app_start_correction_generation(uint16_t rtcm_number, uint16_t period)
 	return send_command_and_wait(cmd);
 }
 
-int um980_app_start_gga_generation(um980_frequency_hz_t frequency)
+const char* um980_app_get_gga_command(um980_frequency_hz_t frequency)
 {
 	switch(frequency)
 	{
-		case FREQUENCY_1HZ: return send_command_and_wait("gpgga 1");
-		case FREQUENCY_2HZ: return send_command_and_wait("gpgga 0.5");
-		case FREQUENCY_5HZ: return send_command_and_wait("gpgga 0.2");
-		case FREQUENCY_10HZ: return send_command_and_wait("gpgga 0.1");
+		case FREQUENCY_1HZ: return "gpgga 1";
+		case FREQUENCY_2HZ: return "gpgga 0.5";
+		case FREQUENCY_5HZ: return "gpgga 0.2";
+		case FREQUENCY_10HZ: return "gpgga 0.1";
 	}
-	return -1;
+	return NULL;
+}
+
+int um980_app_start_gga_generation(um980_frequency_hz_t frequency)
+{
+	const char* cmd = um980_app_get_gga_command(frequency);
+	if (cmd == NULL) return -1;
+
+	return send_command_and_wait((char*) cmd);
 }
 
 int um980_app_do()
@@ -12,6 +12,21 @@
 
 #include "packet_handler.h"
 
+/**
+ * @def UM980_APP_UNLOG_ATTEMPTS
+ * @brief Number of times unlog is sent during the init (the first one can fail because of the start-up of the module)
+ */
+#define UM980_APP_UNLOG_ATTEMPTS	2
+
+/**
+ * @def UM980_APP_UNLOG_RETRY_MS
+ * @brief Time between two attempts of unlog
+ */
+#define UM980_APP_UNLOG_RETRY_MS	500
+
+#define UM980_APP_CMD_UNLOG			"unlog"
+#define UM980_APP_CMD_MODE_ROVER	"mode rover"
+
 typedef enum
 {
 	FREQUENCY_1HZ,
@@ -28,9 +43,10 @@ typedef void (*um980_app_on_nmea_packet)(uint8_t* buffer, uint16_t len);
  * Store the HAL function and flush the RX receiving buffer
  */
 void um980_app_init_hal(um980_app_uart_readable_func_t uart_readable,
-		um980_app_uart_read_func_t uart_read,
+		um980_app_uart_read_available_func_t uart_read_available,
+		um980_app_uart_consume_func_t uart_consume,
 		um980_app_uart_write_func_t uart_write,
-		um980_app_get_uticks get_uticks);
+		um980_app_get_time_us get_time_us);
 
 void um980_app_set_nmea_listener(um980_app_on_nmea_packet listener);
 
@@ -49,6 +65,27 @@ int um980_app_init();
  */
 void um980_app_reset();
 
+/**
+ * @brief Send a command without waiting for its answer (non blocking)
+ * The answer is checked with um980_app_poll_command, one command at a time
+ *
+ * @param [in] cmd Command without line ending (for example "unlog")
+ *
+ * @retval 0 Success
+ * @retval != 0 Error
+ */
+int um980_app_send_command(const char* cmd);
+
+/**
+ * @brief Check if the command sent with um980_app_send_command has been acknowledged (non blocking)
+ * Reads what the UM980 sent, the other packets are dropped
+ *
+ * @retval 1 Command acknowledged
+ * @retval 0 Answer not received yet
+ * @retval < 0 Error or no answer after 100ms
+ */
+int um980_app_poll_command();
+
 /**
  * @brief Make the UM980 quiet (start generation correction and position messages)
  *
@@ -67,6 +104,13 @@ int um980_app_unlog();
  */
 int um980_app_start_gga_generation(um980_frequency_hz_t frequency);
 
+/**
+ * @brief Get the command starting the generation of GGA messages (to be sent with um980_app_send_command)
+ *
+ * @retval NULL Frequency not supported
+ */
+const char* um980_app_get_gga_command(um980_frequency_hz_t frequency);
+
 /**
  * @brief Set the UM980 as a base mode
  *